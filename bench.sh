@@ -0,0 +1,83 @@
+#!/bin/bash
+# Reproducible benchmark: builds server and client with -O2, starts the server on
+# localhost:4040 and runs the same scenarios every time. Arguments are passed to the
+# server, e.g. ./bench.sh --workers=4. DURATION and THREADS override the client defaults.
+# MODES="epoll uring" runs every scenario once per serving mode, e.g. to compare the
+# epoll and io_uring backends under the same load, and ends with a summary table.
+set -e
+cd "$(dirname "$0")"
+
+DURATION=${DURATION:-10}
+THREADS=${THREADS:-2}
+
+gcc -O2 -Wall -pthread server.c -o server
+gcc -O2 -Wall -pthread client.c -o client
+
+SERVER_PID=
+trap 'kill $SERVER_PID 2>/dev/null; wait $SERVER_PID 2>/dev/null' EXIT
+
+start_server(){
+	# Connections the previous server closed can hold the port in TIME_WAIT for a minute
+	for attempt in $(seq 40); do
+		./server "$@" > /dev/null 2>&1 &
+		SERVER_PID=$!
+
+		# Wait for the listener
+		for i in $(seq 50); do
+			if (exec 3<>/dev/tcp/127.0.0.1/4040) 2>/dev/null; then
+				break
+			fi
+			sleep 0.1
+		done
+		if kill -0 $SERVER_PID 2>/dev/null; then
+			return
+		fi
+		[ "$attempt" = 1 ] && echo "Waiting for port 4040 to be released..." >&2
+		sleep 2
+	done
+	echo "Server failed to start" >&2
+	exit 1
+}
+
+stop_server(){
+	kill $SERVER_PID 2>/dev/null
+	wait $SERVER_PID 2>/dev/null || true
+	SERVER_PID=
+}
+
+SUMMARY=
+run(){
+	echo "=== $1"
+	local name=$1
+	shift
+	local output
+	output=$(./client -t "$THREADS" -d "$DURATION" "$@")
+	echo "$output"
+	echo ""
+	local throughput=$(echo "$output" | grep -o '([0-9.]*/s)' | head -1 | tr -d '()')
+	local p99=$(echo "$output" | grep -o 'p99 [^,]*' | head -1 | cut -d' ' -f2)
+	SUMMARY+="$(printf '%-8s %-26s %14s %10s' "$MODE" "$name" "$throughput" "$p99")"$'\n'
+}
+
+scenarios(){
+	run "Keep-alive GET" -c 64 -R "GET /index.html"
+	run "Pipelined GET, depth 16" -c 16 -p 16 -R "GET /index.html"
+	run "Connection per request" -c 16 --close -R "GET /index.html"
+	run "GET/POST mix 9:1" -c 64 -R "9*GET /index.html" -R "1*POST /form.html user_name=bench&user_age=1"
+	run "Open loop, 20000 req/s" -c 64 -r 20000 -l -R "GET /index.html" -R "GET /styles.css"
+}
+
+if [ -z "$MODES" ]; then
+	start_server "$@"
+	scenarios
+	exit 0
+fi
+
+for MODE in $MODES; do
+	echo "##### --mode=$MODE"
+	start_server --mode="$MODE" "$@"
+	scenarios
+	stop_server
+done
+printf '%-8s %-26s %14s %10s\n' Mode Scenario Throughput p99
+echo -n "$SUMMARY"
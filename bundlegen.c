@@ -0,0 +1,275 @@
+/*
+ * Packs a document root into a bundle for the server's --bundle option:
+ *
+ *   gcc -O2 -pthread bundlegen.c -o bundlegen
+ *   ./bundlegen [--cache-control=EXT=SECONDS]... [--max-file=BYTES] files site.bundle
+ *
+ * Every regular file up to --max-file (default 1M) is packed under its request path
+ * together with its pre-compressed sidecars, with the headers the server would
+ * send for it rendered in advance, so Cache-Control rules are fixed when packing.
+ * Symlinks and larger files are left out and served from the document root.
+ * server.c is compiled in with its main() renamed, so content types, ETags and
+ * headers are exactly what the server computes for the same files.
+ */
+#define main server_main
+#include "server.c"
+#undef main
+
+typedef struct{
+	char *data;
+	size_t len;
+	size_t cap;
+} Blob;
+
+Blob blob; // everything after the entries, offsets relative to its start until written
+BundleEntry *entries;
+uint64_t entry_count;
+uint64_t entry_cap;
+off_t max_file = CACHE_MAX_FILE;
+int skipped;
+
+//Append len bytes to the blob. Returns their offset, or -1 on failure
+long long blob_append(const void *data, size_t len){
+	if (blob.len + len > blob.cap){
+		size_t new_cap = blob.cap ? blob.cap : 65536;
+		while (new_cap < blob.len + len){
+			new_cap *= 2;
+		}
+		char *new_data = realloc(blob.data, new_cap);
+		if (new_data == NULL){
+			perror("Memory allocation failed\n");
+			return -1;
+		}
+		blob.data = new_data;
+		blob.cap = new_cap;
+	}
+	memcpy(blob.data + blob.len, data, len);
+	blob.len += len;
+	return blob.len - len;
+}
+
+//Append the contents of path, relative to the document root. Returns their offset, or -1 on failure
+long long blob_append_file(const char *path, off_t size){
+	int fd = openat(document_root.fd, document_root_relative(path), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if (fd < 0){
+		perror(path);
+		return -1;
+	}
+	char *body = file_read_body(fd, size);
+	close(fd);
+	if (body == NULL){
+		fprintf(stderr, "Failed to read %s\n", path);
+		return -1;
+	}
+	long long offset = blob_append(body, size);
+	free(body);
+	return offset;
+}
+
+//Pack one variant of a file under key. Returns 0 for success, 1 for failure
+int add_entry(const char *key, const char *body_path, StaticFile *file, int coding){
+	if (entry_count == entry_cap){
+		entry_cap = entry_cap ? entry_cap * 2 : 1024;
+		entries = realloc(entries, entry_cap * sizeof(BundleEntry));
+		if (entries == NULL){
+			perror("Memory allocation failed\n");
+			return 1;
+		}
+	}
+	char header[1024];
+	int header_len = render_static_header(header, sizeof(header), file);
+	BundleEntry *entry = &entries[entry_count];
+	memset(entry, 0, sizeof(*entry));
+	long long key_offset = blob_append(key, strlen(key));
+	long long header_offset = blob_append(header, header_len);
+	long long content_type_offset = blob_append(file->content_type, strlen(file->content_type) + 1);
+	long long body_offset = blob_append_file(body_path, file->size);
+	if (key_offset < 0 || header_offset < 0 || content_type_offset < 0 || body_offset < 0){
+		return 1;
+	}
+	entry->key_offset = key_offset;
+	entry->key_len = strlen(key);
+	entry->header_offset = header_offset;
+	entry->header_len = header_len;
+	entry->content_type_offset = content_type_offset;
+	entry->body_offset = body_offset;
+	entry->body_len = file->size;
+	entry->mtime = file->mtime;
+	entry->max_age = file->max_age;
+	entry->codings = file->codings;
+	entry->coding = coding;
+	memcpy(entry->etag, file->etag, sizeof(entry->etag));
+	entry_count++;
+	return 0;
+}
+
+//Pack the file at request path with the sidecars it has. Returns 0 for success, 1 for failure
+int pack_file(const char *path, const struct stat *file_stat){
+	if (file_stat->st_size > max_file){
+		skipped++;
+		return 0;
+	}
+	StaticFile file = { NULL, mime_type(path), NULL, 0, 0, cache_control_max_age(path), find_sidecars(path), -1, "", NULL };
+	static_file_stat(&file, file_stat);
+	if (add_entry(path, path, &file, -1) != 0){
+		return 1;
+	}
+
+	for (int coding = 0; coding < CODING_COUNT; coding++){
+		if (!(file.codings & (1 << coding))){
+			continue;
+		}
+		char sidecar_path[PATH_MAX + 8];
+		char key[PATH_MAX + 8];
+		struct stat sidecar_stat;
+		snprintf(sidecar_path, sizeof(sidecar_path), "%s%s", path, content_codings[coding].extension);
+		if (fstatat(document_root.fd, document_root_relative(sidecar_path), &sidecar_stat, AT_SYMLINK_NOFOLLOW) != 0
+				|| sidecar_stat.st_size > max_file){
+			continue;
+		}
+		StaticFile sidecar = file;
+		sidecar.content_encoding = content_codings[coding].name;
+		static_file_stat(&sidecar, &sidecar_stat);
+		cache_coding_key(key, sizeof(key), path, coding);
+		if (add_entry(key, sidecar_path, &sidecar, coding) != 0){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//Pack every regular file below the directory at request path prefix ("" for the root). Returns 0 for success, 1 for failure
+int pack_directory(const char *prefix){
+	int dir_fd = openat(document_root.fd, prefix[0] ? prefix + 1 : ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	DIR *dir = dir_fd >= 0 ? fdopendir(dir_fd) : NULL;
+	if (dir == NULL){
+		perror(prefix[0] ? prefix : document_root.path);
+		if (dir_fd >= 0){
+			close(dir_fd);
+		}
+		return 1;
+	}
+	struct dirent *dirent;
+	int failed = 0;
+	while (!failed && (dirent = readdir(dir)) != NULL){
+		if (strcmp(dirent->d_name, ".") == 0 || strcmp(dirent->d_name, "..") == 0){
+			continue;
+		}
+		char path[PATH_MAX];
+		struct stat file_stat;
+		if (snprintf(path, sizeof(path), "%s/%s", prefix, dirent->d_name) >= (int)sizeof(path)
+				|| fstatat(dirfd(dir), dirent->d_name, &file_stat, AT_SYMLINK_NOFOLLOW) != 0){
+			skipped++;
+			continue;
+		}
+		if (S_ISDIR(file_stat.st_mode)){
+			failed = pack_directory(path);
+		}
+		else if (S_ISREG(file_stat.st_mode)){
+			failed = pack_file(path, &file_stat);
+		}
+		else {
+			skipped++;
+		}
+	}
+	closedir(dir);
+	return failed;
+}
+
+//Write header, index, entries and blob to output. Returns 0 for success, 1 for failure
+int write_bundle(FILE *output){
+	//1. Index at most half full, so probes stay short
+	BundleHeader header = {0};
+	memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+	header.version = BUNDLE_VERSION;
+	header.slot_count = 2;
+	while (header.slot_count < entry_count * 2){
+		header.slot_count *= 2;
+	}
+	header.entry_count = entry_count;
+	uint64_t blob_start = sizeof(header) + (uint64_t)header.slot_count * sizeof(BundleSlot) + entry_count * sizeof(BundleEntry);
+	header.size = blob_start + blob.len;
+
+	BundleSlot *slots = calloc(header.slot_count, sizeof(BundleSlot));
+	if (slots == NULL){
+		perror("Memory allocation failed\n");
+		return 1;
+	}
+	for (uint64_t i = 0; i < entry_count; i++){
+		char key[PATH_MAX + 8];
+		snprintf(key, sizeof(key), "%.*s", (int)entries[i].key_len, blob.data + entries[i].key_offset);
+		unsigned int hash = cache_hash(key);
+		uint32_t slot = hash & (header.slot_count - 1);
+		while (slots[slot].entry != 0){
+			slot = (slot + 1) & (header.slot_count - 1);
+		}
+		slots[slot].hash = hash;
+		slots[slot].entry = i + 1;
+
+		//2. Offsets become relative to the start of the file
+		entries[i].key_offset += blob_start;
+		entries[i].header_offset += blob_start;
+		entries[i].content_type_offset += blob_start;
+		entries[i].body_offset += blob_start;
+	}
+
+	int failed = fwrite(&header, sizeof(header), 1, output) != 1
+		|| fwrite(slots, sizeof(BundleSlot), header.slot_count, output) != header.slot_count
+		|| (entry_count > 0 && fwrite(entries, sizeof(BundleEntry), entry_count, output) != entry_count)
+		|| (blob.len > 0 && fwrite(blob.data, blob.len, 1, output) != 1);
+	free(slots);
+	return failed;
+}
+
+int main(int argc, char *argv[]){
+	static struct option long_options[] = {
+		{"cache-control", required_argument, NULL, 'c'},
+		{"max-file", required_argument, NULL, 'm'},
+		{NULL, 0, NULL, 0}
+	};
+	int option;
+	while ((option = getopt_long(argc, argv, "", long_options, NULL)) != -1){
+		if (option == 'c' && config_add_cache_control(optarg) == 0){
+			continue;
+		}
+		if (option == 'm' && (max_file = parse_size(optarg)) >= 0){
+			continue;
+		}
+		fprintf(stderr, "Usage: %s [--cache-control=EXT=SECONDS]... [--max-file=BYTES] directory bundle\n", argv[0]);
+		return 1;
+	}
+	if (argc - optind != 2){
+		fprintf(stderr, "Usage: %s [--cache-control=EXT=SECONDS]... [--max-file=BYTES] directory bundle\n", argv[0]);
+		return 1;
+	}
+
+	//1. Pack the tree, looking files up the way the server does
+	if (document_root_open(argv[optind]) != 0 || pack_directory("") != 0){
+		return 1;
+	}
+	if (entry_count >= UINT32_MAX / 2){
+		fprintf(stderr, "Too many files for one bundle\n");
+		return 1;
+	}
+
+	//2. Write it under a temporary name and rename it into place, so a running server's bundle is never half written
+	char temporary[PATH_MAX];
+	snprintf(temporary, sizeof(temporary), "%s.tmp", argv[optind + 1]);
+	FILE *output = fopen(temporary, "wb");
+	if (output == NULL){
+		perror("Failed to create bundle\n");
+		return 1;
+	}
+	int failed = write_bundle(output);
+	if (fclose(output) != 0 || failed || rename(temporary, argv[optind + 1]) != 0){
+		perror("Failed to write bundle\n");
+		unlink(temporary);
+		return 1;
+	}
+	printf("Packed %llu entries, %zu bytes of data into %s", (unsigned long long)entry_count, blob.len, argv[optind + 1]);
+	if (skipped > 0){
+		printf("; %d files left to the document root", skipped);
+	}
+	printf("\n");
+	return 0;
+}
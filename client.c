@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <sys/socket.h>
 #include <stdlib.h>
@@ -5,42 +6,749 @@
 #include <netinet/in.h>
 #include <string.h>
 #include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <stdint.h>
 
-int main(int argc, char *argv[]){
-	//Create a socket
-	int client_fd = socket(AF_INET, SOCK_STREAM, 0);
-	if (client_fd < 0){
+/*
+ * HTTP/1.1 benchmark driver for the server. Each thread runs its own epoll loop
+ * over a share of the connections, keeps up to --pipeline requests in flight on
+ * each and records every response's latency in a log-linear histogram.
+ *
+ * In closed-loop mode (the default) a connection sends its next request as soon
+ * as a response arrives. With --rate the requests are sent on a fixed schedule
+ * instead and latency is measured from when a request was due, not from when it
+ * could be sent, so a stalled server shows up in the tail instead of silently
+ * lowering the offered load (coordinated omission).
+ */
+#define MAX_TEMPLATES 16
+#define MAX_PIPELINE 128
+#define MAX_EVENTS 256
+#define HEAD_MAX 8192 //Largest response head accepted
+#define READ_CHUNK (64 * 1024)
+#define RECONNECT_DELAY_NS 10000000ull //Wait before retrying a failed connection
+
+//=====================LATENCY HISTOGRAM==================
+/*
+ * Values under 64ns get a bucket each; above that every power of two is split into
+ * 64 buckets, so any recorded value is reported within 1.6% of its true value
+ */
+#define HIST_SUB_BITS 6
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB_COUNT)
+
+typedef struct{
+	uint64_t counts[HIST_BUCKETS];
+	uint64_t total;
+	uint64_t max;
+} Histogram;
+
+int hist_index(uint64_t value){
+	if (value < HIST_SUB_COUNT){
+		return value;
+	}
+	int shift = 63 - __builtin_clzll(value) - HIST_SUB_BITS;
+	return ((shift + 1) << HIST_SUB_BITS) + ((value >> shift) & (HIST_SUB_COUNT - 1));
+}
+
+//Largest value that falls in bucket index
+uint64_t hist_bucket_value(int index){
+	if (index < HIST_SUB_COUNT){
+		return index;
+	}
+	int shift = (index >> HIST_SUB_BITS) - 1;
+	uint64_t base = HIST_SUB_COUNT + (index & (HIST_SUB_COUNT - 1));
+	return ((base + 1) << shift) - 1;
+}
+
+void hist_record(Histogram *hist, uint64_t value){
+	hist->counts[hist_index(value)]++;
+	hist->total++;
+	if (value > hist->max) hist->max = value;
+}
+
+void hist_merge(Histogram *into, const Histogram *from){
+	for (int i = 0; i < HIST_BUCKETS; i++){
+		into->counts[i] += from->counts[i];
+	}
+	into->total += from->total;
+	if (from->max > into->max) into->max = from->max;
+}
+
+//Value at percentile (0-100)
+uint64_t hist_percentile(const Histogram *hist, double percentile){
+	if (hist->total == 0){
+		return 0;
+	}
+	uint64_t rank = (uint64_t)(percentile / 100.0 * hist->total + 0.5);
+	if (rank < 1) rank = 1;
+	uint64_t seen = 0;
+	for (int i = 0; i < HIST_BUCKETS; i++){
+		seen += hist->counts[i];
+		if (seen >= rank){
+			uint64_t value = hist_bucket_value(i);
+			return value < hist->max ? value : hist->max;
+		}
+	}
+	return hist->max;
+}
+
+//=====================CONFIGURATION==================
+//One kind of request in the mix, rendered once up front
+typedef struct{
+	char *data; // complete request bytes
+	size_t len;
+	int weight;
+	char description[96]; // METHOD PATH for the report
+} RequestTemplate;
+
+typedef struct{
+	const char *host;
+	const char *port;
+	struct sockaddr_storage address;
+	socklen_t address_len;
+	int threads;
+	int connections;
+	int pipeline;
+	int duration; // seconds
+	int keep_alive;
+	int latency_table;
+	double rate; // total requests per second, 0 for closed loop
+	RequestTemplate templates[MAX_TEMPLATES];
+	int template_count;
+	int total_weight;
+} BenchConfig;
+
+BenchConfig bench = {
+	.host = "127.0.0.1",
+	.port = "4040",
+	.threads = 2,
+	.connections = 16,
+	.pipeline = 1,
+	.duration = 10,
+	.keep_alive = 1
+};
+
+uint64_t now_ns(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/*
+ * Parse "[WEIGHT*]METHOD PATH [BODY]" into a rendered request. A body is sent as
+ * application/x-www-form-urlencoded. Returns 0 for success, 1 for failure
+ */
+int add_template(const char *spec){
+	if (bench.template_count == MAX_TEMPLATES){
+		fprintf(stderr, "At most %d request templates\n", MAX_TEMPLATES);
+		return 1;
+	}
+	RequestTemplate *request = &bench.templates[bench.template_count];
+
+	//1. Optional weight
+	request->weight = 1;
+	const char *star = strchr(spec, '*');
+	const char *space = strchr(spec, ' ');
+	if (star != NULL && (space == NULL || star < space)){
+		request->weight = atoi(spec);
+		if (request->weight <= 0){
+			fprintf(stderr, "Invalid weight in request template: %s\n", spec);
+			return 1;
+		}
+		spec = star + 1;
+	}
+
+	//2. Method, path and optional body
+	char method[16];
+	char path[1024];
+	int consumed = 0;
+	if (sscanf(spec, "%15s %1023s %n", method, path, &consumed) < 2){
+		fprintf(stderr, "Request template must be \"[WEIGHT*]METHOD PATH [BODY]\": %s\n", spec);
+		return 1;
+	}
+	const char *body = spec + consumed;
+	size_t body_len = strlen(body);
+	snprintf(request->description, sizeof(request->description), "%s %.64s", method, path);
+
+	//3. Render the request
+	size_t cap = strlen(path) + strlen(bench.host) + body_len + 256;
+	request->data = malloc(cap);
+	if (request->data == NULL){
+		perror("Memory allocation failed\n");
+		return 1;
+	}
+	int len = snprintf(request->data, cap, "%s %s HTTP/1.1\r\nHost: %s:%s\r\n%s",
+		method, path, bench.host, bench.port, bench.keep_alive ? "" : "Connection: close\r\n");
+	if (body_len > 0){
+		len += snprintf(request->data + len, cap - len,
+			"Content-Type: application/x-www-form-urlencoded\r\nContent-Length: %zu\r\n", body_len);
+	}
+	len += snprintf(request->data + len, cap - len, "\r\n");
+	memcpy(request->data + len, body, body_len);
+	request->len = len + body_len;
+
+	bench.total_weight += request->weight;
+	bench.template_count++;
+	return 0;
+}
+
+//=====================CONNECTIONS==================
+typedef struct{
+	uint64_t intended; // latency is measured from here: when the request was due
+	int template_index;
+} InFlight;
+
+typedef struct{
+	uint64_t completed;
+	uint64_t errors;
+	uint64_t bytes;
+	uint64_t status[6]; // by class, [1] for 1xx through [5] for 5xx, [0] for anything else
+	Histogram latency;
+} BenchStats;
+
+typedef struct{
+	InFlight inflight[MAX_PIPELINE]; // ring of requests sent and not yet answered
+	char head[HEAD_MAX]; // response head being read
+	char *out; // request bytes not yet written
+	size_t out_len;
+	size_t out_sent;
+	size_t out_cap;
+	size_t head_len;
+	long long body_left; // -1 while reading the head
+	uint64_t next_send; // open loop: when the next request is due
+	uint64_t retry_at; // when to reconnect after a failure, 0 when connected
+	int inflight_head;
+	int inflight_count;
+	int close_after; // the response being read ends the connection
+	int status;
+	int fd;
+} BenchConnection;
+
+typedef struct{
+	pthread_t thread;
+	BenchConnection *connections;
+	BenchStats stats;
+	uint64_t start;
+	uint64_t end;
+	uint64_t interval; // open loop: ns between requests on one connection
+	uint64_t rng;
+	int connection_count;
+	int epoll_fd;
+} BenchThread;
+
+int conn_append(BenchConnection *conn, const char *data, size_t len){
+	if (conn->out_len + len > conn->out_cap){
+		size_t cap = conn->out_cap ? conn->out_cap : 4096;
+		while (cap < conn->out_len + len) cap *= 2;
+		char *out = realloc(conn->out, cap);
+		if (out == NULL){
+			perror("Memory allocation failed\n");
+			return 1;
+		}
+		conn->out = out;
+		conn->out_cap = cap;
+	}
+	memcpy(conn->out + conn->out_len, data, len);
+	conn->out_len += len;
+	return 0;
+}
+
+//Write queued request bytes until the socket is full. Returns 0 for success, 1 for failure
+int conn_flush(BenchConnection *conn){
+	while (conn->out_sent < conn->out_len){
+		ssize_t sent = send(conn->fd, conn->out + conn->out_sent, conn->out_len - conn->out_sent, MSG_NOSIGNAL);
+		if (sent < 0){
+			if (errno == EINTR) continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+			return 1;
+		}
+		conn->out_sent += sent;
+	}
+	conn->out_len = conn->out_sent = 0;
+	return 0;
+}
+
+/*
+ * Open a non-blocking connection and queue every request still in flight on it,
+ * so requests lost with a previous connection are sent again with their original
+ * due times. Returns 0 for success, 1 for failure
+ */
+int conn_open(BenchThread *thread, BenchConnection *conn){
+	conn->fd = socket(bench.address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (conn->fd < 0){
 		perror("Socket creation failed\n");
-		exit(EXIT_FAILURE);
+		return 1;
+	}
+	int one = 1;
+	setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	if (connect(conn->fd, (struct sockaddr *)&bench.address, bench.address_len) < 0 && errno != EINPROGRESS){
+		close(conn->fd);
+		conn->fd = -1;
+		return 1;
+	}
+
+	struct epoll_event event;
+	event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+	event.data.ptr = conn;
+	if (epoll_ctl(thread->epoll_fd, EPOLL_CTL_ADD, conn->fd, &event) < 0){
+		perror("epoll_ctl failed\n");
+		close(conn->fd);
+		conn->fd = -1;
+		return 1;
+	}
+
+	conn->out_len = conn->out_sent = 0;
+	conn->head_len = 0;
+	conn->body_left = -1;
+	conn->close_after = 0;
+	conn->retry_at = 0;
+	for (int i = 0; i < conn->inflight_count; i++){
+		RequestTemplate *request = &bench.templates[conn->inflight[(conn->inflight_head + i) % MAX_PIPELINE].template_index];
+		if (conn_append(conn, request->data, request->len) != 0){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void conn_close(BenchConnection *conn){
+	if (conn->fd >= 0){
+		close(conn->fd);
+		conn->fd = -1;
+	}
+}
+
+//The connection broke: count an error and reconnect shortly, keeping the requests in flight
+void conn_failed(BenchThread *thread, BenchConnection *conn, uint64_t now){
+	conn_close(conn);
+	thread->stats.errors++;
+	conn->retry_at = now + RECONNECT_DELAY_NS;
+}
+
+//Pick a template by weight
+int pick_template(BenchThread *thread){
+	if (bench.template_count == 1){
+		return 0;
 	}
-	
-	//Bind a socket
-	struct sockaddr_in addy;
-	memset(&addy, 0, sizeof(addy));
-	addy.sin_family = AF_INET;
-	addy.sin_port = htons(4040);
-	if (inet_pton(AF_INET, "127.0.0.1", &addy.sin_addr) < 0) {
-		printf("Invalid Address\n");
-		exit(EXIT_FAILURE);
+	thread->rng ^= thread->rng << 13;
+	thread->rng ^= thread->rng >> 7;
+	thread->rng ^= thread->rng << 17;
+	int pick = thread->rng % bench.total_weight;
+	for (int i = 0; i < bench.template_count; i++){
+		pick -= bench.templates[i].weight;
+		if (pick < 0){
+			return i;
+		}
 	}
+	return 0;
+}
+
+//Queue one request due at intended. Returns 0 for success, 1 for failure
+int conn_issue(BenchThread *thread, BenchConnection *conn, uint64_t intended){
+	int index = pick_template(thread);
+	InFlight *slot = &conn->inflight[(conn->inflight_head + conn->inflight_count) % MAX_PIPELINE];
+	slot->intended = intended;
+	slot->template_index = index;
+	conn->inflight_count++;
+	return conn_append(conn, bench.templates[index].data, bench.templates[index].len);
+}
 
-	//CHECK CONNECT VS BIND
-	int connected = connect(client_fd, (struct sockaddr *)&addy, sizeof(addy));
-	if (connected < 0){
-		printf("Connection failed\n");
-		exit(EXIT_FAILURE);
+//Parse the status code, Content-Length and Connection of a complete response head
+int parse_response_head(BenchConnection *conn, size_t head_len){
+	if (head_len < 12 || strncmp(conn->head, "HTTP/1.", 7) != 0){
+		return 1;
+	}
+	conn->status = atoi(conn->head + 9);
+	conn->body_left = 0;
+	conn->close_after = !bench.keep_alive;
+	for (char *line = conn->head; line < conn->head + head_len; ){
+		char *line_end = memmem(line, conn->head + head_len - line, "\r\n", 2);
+		if (line_end == NULL) break;
+		if (strncasecmp(line, "Content-Length:", 15) == 0){
+			conn->body_left = strtoll(line + 15, NULL, 10);
+		}
+		else if (strncasecmp(line, "Connection:", 11) == 0){
+			char *value = line + 11;
+			while (*value == ' ') value++;
+			conn->close_after = strncasecmp(value, "close", 5) == 0;
+		}
+		line = line_end + 2;
 	}
+	//No body whatever Content-Length says
+	if (conn->status == 304 || conn->status == 204 || conn->status / 100 == 1){
+		conn->body_left = 0;
+	}
+	return 0;
+}
 
-	//Send message
-	char *hello = "Oyaaaaaaa\n";
-	send(client_fd, hello, strlen(hello), 0);
-	printf("Umetuma oya\n");
+//The oldest request in flight has been answered
+void conn_complete(BenchThread *thread, BenchConnection *conn, uint64_t now){
+	InFlight *done = &conn->inflight[conn->inflight_head];
+	if (now >= thread->start && now <= thread->end){
+		hist_record(&thread->stats.latency, now > done->intended ? now - done->intended : 0);
+		thread->stats.completed++;
+		int class = conn->status / 100;
+		thread->stats.status[class >= 1 && class <= 5 ? class : 0]++;
+	}
+	conn->inflight_head = (conn->inflight_head + 1) % MAX_PIPELINE;
+	conn->inflight_count--;
+	conn->head_len = 0;
+	conn->body_left = -1;
+}
 
-	//Receive message
-	char buffer[1024];
-	read(client_fd, buffer, sizeof(buffer) - 2);
-	buffer[sizeof(buffer) - 1] = '\0';
-	printf("%s\n", buffer);
+/*
+ * Account for len received bytes. Only response heads are copied, bodies are
+ * skipped by count. Returns 0 to keep reading, 1 if the connection must be reopened
+ */
+int conn_consume(BenchThread *thread, BenchConnection *conn, const char *data, size_t len, uint64_t now){
+	const char *p = data;
+	const char *end = data + len;
+	while (p < end){
+		if (conn->body_left < 0){
+			//1. Collect the head until the blank line, which may be split across reads
+			size_t take = end - p;
+			if (take > HEAD_MAX - conn->head_len) take = HEAD_MAX - conn->head_len;
+			size_t search_from = conn->head_len > 3 ? conn->head_len - 3 : 0;
+			memcpy(conn->head + conn->head_len, p, take);
+			char *blank = memmem(conn->head + search_from, conn->head_len + take - search_from, "\r\n\r\n", 4);
+			if (blank == NULL){
+				conn->head_len += take;
+				p += take;
+				if (conn->head_len == HEAD_MAX || conn->inflight_count == 0){
+					thread->stats.errors++;
+					return 1;
+				}
+				continue;
+			}
+			size_t head_len = blank + 4 - conn->head;
+			p += head_len - conn->head_len;
+			if (conn->inflight_count == 0 || parse_response_head(conn, head_len) != 0){
+				thread->stats.errors++;
+				return 1;
+			}
+		}
+		else {
+			//2. Skip the body
+			size_t take = end - p;
+			if ((long long)take > conn->body_left) take = conn->body_left;
+			conn->body_left -= take;
+			p += take;
+		}
 
+		if (conn->body_left == 0){
+			int close_after = conn->close_after;
+			conn_complete(thread, conn, now);
+			if (close_after){
+				return 1;
+			}
+		}
+	}
 	return 0;
 }
+
+void conn_handle_event(BenchThread *thread, BenchConnection *conn, uint32_t events, uint64_t now){
+	static __thread char buffer[READ_CHUNK];
+	if (events & EPOLLIN){
+		while (1){
+			ssize_t bytes_read = recv(conn->fd, buffer, sizeof(buffer), 0);
+			if (bytes_read > 0){
+				if (now >= thread->start && now <= thread->end){
+					thread->stats.bytes += bytes_read;
+				}
+				if (conn_consume(thread, conn, buffer, bytes_read, now) != 0){
+					//Server said Connection: close (or sent garbage): reopen straight away
+					conn_close(conn);
+					if (conn_open(thread, conn) != 0){
+						conn_failed(thread, conn, now);
+					}
+					return;
+				}
+				continue;
+			}
+			if (bytes_read < 0 && errno == EINTR) continue;
+			if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+			//Closed or reset with requests outstanding
+			conn_failed(thread, conn, now);
+			return;
+		}
+	}
+	else if (events & (EPOLLERR | EPOLLHUP)){
+		conn_failed(thread, conn, now);
+		return;
+	}
+	if ((events & EPOLLOUT) && conn_flush(conn) != 0){
+		conn_failed(thread, conn, now);
+	}
+}
+
+//Send whatever is due on conn and return when it next wants attention (0 for "when a response arrives")
+uint64_t conn_schedule(BenchThread *thread, BenchConnection *conn, uint64_t now){
+	if (conn->fd < 0){
+		if (now < conn->retry_at){
+			return conn->retry_at;
+		}
+		if (conn_open(thread, conn) != 0){
+			conn_failed(thread, conn, now);
+			return conn->retry_at;
+		}
+	}
+
+	int queued = 0;
+	if (thread->interval == 0){
+		//Closed loop: keep the pipeline full
+		while (conn->inflight_count < bench.pipeline){
+			queued |= conn_issue(thread, conn, now) == 0;
+		}
+	}
+	else {
+		//Open loop: requests stay due at their scheduled time even while the pipeline is full
+		while (conn->next_send <= now && conn->inflight_count < bench.pipeline){
+			queued |= conn_issue(thread, conn, conn->next_send) == 0;
+			conn->next_send += thread->interval;
+		}
+	}
+	if (queued && conn_flush(conn) != 0){
+		conn_failed(thread, conn, now);
+		return conn->retry_at;
+	}
+	return thread->interval != 0 && conn->inflight_count < bench.pipeline ? conn->next_send : 0;
+}
+
+void *bench_thread(void *arg){
+	BenchThread *thread = arg;
+	struct epoll_event events[MAX_EVENTS];
+
+	//1. Stagger open-loop schedules so connections do not fire in lockstep
+	for (int i = 0; i < thread->connection_count; i++){
+		BenchConnection *conn = &thread->connections[i];
+		conn->fd = -1;
+		conn->body_left = -1;
+		conn->next_send = thread->start + thread->interval * i / thread->connection_count;
+	}
+
+	//2. Run until the end of the measurement, sending what is due after every wakeup
+	uint64_t now = now_ns();
+	while (now < thread->end){
+		uint64_t wake = thread->end;
+		for (int i = 0; i < thread->connection_count; i++){
+			uint64_t next = conn_schedule(thread, &thread->connections[i], now);
+			if (next != 0 && next < wake) wake = next;
+		}
+
+		int timeout = wake > now ? (int)((wake - now + 999999) / 1000000) : 0;
+		int ready = epoll_wait(thread->epoll_fd, events, MAX_EVENTS, timeout);
+		if (ready < 0 && errno != EINTR){
+			perror("epoll_wait failed\n");
+			break;
+		}
+		now = now_ns();
+		for (int i = 0; i < ready; i++){
+			BenchConnection *conn = events[i].data.ptr;
+			if (conn->fd >= 0){
+				conn_handle_event(thread, conn, events[i].events, now);
+			}
+		}
+	}
+
+	for (int i = 0; i < thread->connection_count; i++){
+		conn_close(&thread->connections[i]);
+		free(thread->connections[i].out);
+	}
+	return NULL;
+}
+
+//=====================REPORT==================
+void format_duration(uint64_t ns, char *out, size_t out_len){
+	if (ns < 1000000) snprintf(out, out_len, "%.1fus", ns / 1e3);
+	else if (ns < 1000000000) snprintf(out, out_len, "%.2fms", ns / 1e6);
+	else snprintf(out, out_len, "%.2fs", ns / 1e9);
+}
+
+void print_report(const BenchStats *stats, double seconds){
+	printf("Requests:  %llu (%.1f/s)\n", (unsigned long long)stats->completed, stats->completed / seconds);
+	printf("Transfer:  %.2f MB (%.2f MB/s)\n", stats->bytes / 1e6, stats->bytes / 1e6 / seconds);
+	printf("Errors:    %llu\n", (unsigned long long)stats->errors);
+	printf("Status:    2xx %llu, 3xx %llu, 4xx %llu, 5xx %llu, other %llu\n",
+		(unsigned long long)stats->status[2], (unsigned long long)stats->status[3], (unsigned long long)stats->status[4],
+		(unsigned long long)stats->status[5], (unsigned long long)(stats->status[0] + stats->status[1]));
+
+	char p50[32], p99[32], p999[32], max[32];
+	format_duration(hist_percentile(&stats->latency, 50), p50, sizeof(p50));
+	format_duration(hist_percentile(&stats->latency, 99), p99, sizeof(p99));
+	format_duration(hist_percentile(&stats->latency, 99.9), p999, sizeof(p999));
+	format_duration(stats->latency.max, max, sizeof(max));
+	printf("Latency:   p50 %s, p99 %s, p99.9 %s, max %s\n", p50, p99, p999, max);
+
+	if (bench.latency_table){
+		static const double percentiles[] = { 50, 75, 90, 95, 99, 99.9, 99.99, 100 };
+		printf("Latency distribution:\n");
+		for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++){
+			char value[32];
+			format_duration(hist_percentile(&stats->latency, percentiles[i]), value, sizeof(value));
+			printf("  %7.2f%%  %s\n", percentiles[i], value);
+		}
+	}
+}
+
+//=====================MAIN==================
+void print_usage(const char *program){
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -H, --host=HOST          server address (default 127.0.0.1)\n"
+		"  -P, --port=PORT          server port (default 4040)\n"
+		"  -t, --threads=N          client threads (default 2)\n"
+		"  -c, --connections=N      connections across all threads (default 16)\n"
+		"  -d, --duration=SECONDS   measurement time (default 10)\n"
+		"  -p, --pipeline=N         requests in flight per connection (default 1, max %d)\n"
+		"  -C, --close              one request per connection (Connection: close)\n"
+		"  -r, --rate=N             open loop: N requests/s in total on a fixed schedule (default: closed loop)\n"
+		"  -R, --request=SPEC       \"[WEIGHT*]METHOD PATH [BODY]\", repeatable for a weighted mix\n"
+		"                           (default \"GET /index.html\")\n"
+		"  -l, --latency            print the full latency distribution\n"
+		"  -h, --help               show this message\n",
+		program, MAX_PIPELINE);
+}
+
+int main(int argc, char *argv[]){
+	static struct option long_options[] = {
+		{"host", required_argument, NULL, 'H'},
+		{"port", required_argument, NULL, 'P'},
+		{"threads", required_argument, NULL, 't'},
+		{"connections", required_argument, NULL, 'c'},
+		{"duration", required_argument, NULL, 'd'},
+		{"pipeline", required_argument, NULL, 'p'},
+		{"close", no_argument, NULL, 'C'},
+		{"rate", required_argument, NULL, 'r'},
+		{"request", required_argument, NULL, 'R'},
+		{"latency", no_argument, NULL, 'l'},
+		{"help", no_argument, NULL, 'h'},
+		{0, 0, 0, 0}
+	};
+
+	//1. Parse options. Templates are rendered after the loop since they depend on --close and --host
+	const char *specs[MAX_TEMPLATES];
+	int spec_count = 0;
+	int option;
+	while ((option = getopt_long(argc, argv, "H:P:t:c:d:p:Cr:R:lh", long_options, NULL)) != -1){
+		switch (option){
+			case 'H': bench.host = optarg; break;
+			case 'P': bench.port = optarg; break;
+			case 't': bench.threads = atoi(optarg); break;
+			case 'c': bench.connections = atoi(optarg); break;
+			case 'd': bench.duration = atoi(optarg); break;
+			case 'p': bench.pipeline = atoi(optarg); break;
+			case 'C': bench.keep_alive = 0; break;
+			case 'r': bench.rate = atof(optarg); break;
+			case 'R':
+				if (spec_count == MAX_TEMPLATES){
+					fprintf(stderr, "At most %d request templates\n", MAX_TEMPLATES);
+					return 1;
+				}
+				specs[spec_count++] = optarg;
+				break;
+			case 'l': bench.latency_table = 1; break;
+			case 'h':
+				print_usage(argv[0]);
+				return 0;
+			default:
+				print_usage(argv[0]);
+				return 1;
+		}
+	}
+	if (bench.threads <= 0 || bench.connections <= 0 || bench.duration <= 0 || bench.pipeline <= 0
+			|| bench.pipeline > MAX_PIPELINE || bench.rate < 0){
+		print_usage(argv[0]);
+		return 1;
+	}
+	if (bench.threads > bench.connections){
+		bench.threads = bench.connections;
+	}
+	if (!bench.keep_alive){
+		bench.pipeline = 1;
+	}
+	if (spec_count == 0){
+		specs[spec_count++] = "GET /index.html";
+	}
+	for (int i = 0; i < spec_count; i++){
+		if (add_template(specs[i]) != 0){
+			return 1;
+		}
+	}
+
+	//2. Resolve the server once
+	struct addrinfo hints, *result;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	int status = getaddrinfo(bench.host, bench.port, &hints, &result);
+	if (status != 0){
+		fprintf(stderr, "getaddrinfo failed: %s\n", gai_strerror(status));
+		return 1;
+	}
+	memcpy(&bench.address, result->ai_addr, result->ai_addrlen);
+	bench.address_len = result->ai_addrlen;
+	freeaddrinfo(result);
+
+	printf("Running %ds benchmark @ %s:%s\n", bench.duration, bench.host, bench.port);
+	printf("  %d threads, %d connections, pipeline %d, %s, ", bench.threads, bench.connections, bench.pipeline,
+		bench.keep_alive ? "keep-alive" : "connection per request");
+	if (bench.rate > 0) printf("open loop at %.0f req/s\n", bench.rate);
+	else printf("closed loop\n");
+	for (int i = 0; i < bench.template_count; i++){
+		printf("  %d x %s\n", bench.templates[i].weight, bench.templates[i].description);
+	}
+
+	//3. Split the connections and the rate across threads and start them together
+	BenchThread *threads = calloc(bench.threads, sizeof(BenchThread));
+	if (threads == NULL){
+		perror("Memory allocation failed\n");
+		return 1;
+	}
+	uint64_t start = now_ns() + 10000000ull;
+	uint64_t end = start + (uint64_t)bench.duration * 1000000000ull;
+	for (int i = 0; i < bench.threads; i++){
+		BenchThread *thread = &threads[i];
+		thread->connection_count = bench.connections / bench.threads + (i < bench.connections % bench.threads);
+		thread->connections = calloc(thread->connection_count, sizeof(BenchConnection));
+		thread->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if (thread->connections == NULL || thread->epoll_fd < 0){
+			perror("Thread setup failed\n");
+			return 1;
+		}
+		thread->start = start;
+		thread->end = end;
+		thread->interval = bench.rate > 0 ? (uint64_t)(1e9 * bench.connections / bench.rate) : 0;
+		thread->rng = 0x9e3779b97f4a7c15ull * (i + 1);
+		if (pthread_create(&thread->thread, NULL, bench_thread, thread) != 0){
+			perror("pthread_create failed\n");
+			return 1;
+		}
+	}
+
+	//4. Merge and report
+	BenchStats total;
+	memset(&total, 0, sizeof(total));
+	for (int i = 0; i < bench.threads; i++){
+		pthread_join(threads[i].thread, NULL);
+		BenchStats *stats = &threads[i].stats;
+		total.completed += stats->completed;
+		total.errors += stats->errors;
+		total.bytes += stats->bytes;
+		for (int j = 0; j < 6; j++){
+			total.status[j] += stats->status[j];
+		}
+		hist_merge(&total.latency, &stats->latency);
+		close(threads[i].epoll_fd);
+		free(threads[i].connections);
+	}
+	print_report(&total, bench.duration);
+	free(threads);
+	return total.completed > 0 ? 0 : 1;
+}
@@ -0,0 +1,2106 @@
+//Generated by mimegen from mime.types. Do not edit, regenerate instead
+#ifndef MIME_TYPES_H
+#define MIME_TYPES_H
+
+#define MIME_BUCKETS 383
+#define MIME_SLOTS 2048
+#define MIME_MAX_EXTENSION 32
+
+typedef struct{
+	const char *extension; // lower case, NULL for an empty slot
+	const char *type;
+} MimeSlot;
+
+static inline uint32_t mime_hash(const char *key, uint32_t seed){
+	uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+	while (*key){
+		hash ^= (unsigned char)*key++;
+		hash *= 16777619u;
+	}
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35u;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+static const uint16_t mime_displacements[MIME_BUCKETS] = {
+	7, 1, 2, 8, 2, 8, 5, 2, 1, 2, 4, 3, 31, 4, 34, 1,
+	9, 1, 5, 10, 1, 8, 1, 22, 1, 7, 1, 6, 6, 1, 5, 0,
+	1, 4, 12, 2, 0, 57, 1, 19, 3, 9, 4, 1, 1, 1, 2, 4,
+	8, 1, 2, 2, 2, 3, 3, 14, 2, 9, 4, 12, 1, 3, 4, 5,
+	9, 24, 2, 19, 16, 12, 11, 2, 11, 2, 9, 5, 16, 6, 11, 7,
+	3, 12, 22, 25, 25, 1, 12, 3, 4, 14, 5, 8, 15, 4, 12, 1,
+	1, 10, 1, 47, 7, 4, 1, 5, 87, 15, 3, 11, 40, 12, 17, 9,
+	2, 1, 1, 3, 4, 2, 4, 2, 7, 4, 23, 1, 6, 4, 7, 12,
+	5, 4, 2, 4, 16, 3, 1, 15, 1, 3, 17, 14, 3, 4, 6, 10,
+	13, 7, 11, 3, 6, 1, 1, 3, 1, 1, 17, 15, 1, 11, 5, 11,
+	4, 4, 3, 9, 13, 17, 5, 3, 1, 7, 62, 2, 1, 6, 17, 3,
+	4, 6, 9, 2, 19, 64, 1, 2, 9, 13, 12, 11, 4, 1, 1, 34,
+	19, 10, 3, 1, 1, 12, 12, 4, 4, 2, 7, 7, 7, 17, 8, 12,
+	1, 1, 8, 2, 1, 5, 34, 3, 18, 7, 8, 4, 1, 25, 1, 12,
+	6, 20, 5, 30, 0, 9, 4, 1, 14, 13, 10, 3, 4, 7, 1, 2,
+	10, 82, 13, 21, 4, 1, 26, 30, 7, 101, 9, 21, 54, 46, 17, 70,
+	3, 6, 1, 1, 32, 1, 19, 5, 3, 5, 24, 5, 29, 5, 12, 1,
+	7, 3, 19, 17, 5, 4, 2, 11, 1, 2, 2, 12, 34, 1, 4, 5,
+	1, 4, 20, 1, 30, 38, 8, 20, 35, 1, 1, 0, 49, 29, 80, 36,
+	7, 57, 1, 7, 4, 12, 3, 20, 28, 21, 1, 57, 13, 1, 3, 11,
+	37, 2, 3, 26, 32, 14, 3, 2, 2, 3, 5, 4, 20, 7, 2, 3,
+	11, 46, 21, 3, 2, 18, 4, 5, 5, 21, 75, 2, 1, 2, 3, 8,
+	1, 0, 2, 3, 4, 18, 1, 2, 2, 43, 61, 2, 0, 3, 18, 18,
+	19, 18, 4, 7, 15, 5, 0, 1, 60, 4, 2, 8, 21, 62, 4,
+};
+
+static const MimeSlot mime_slots[MIME_SLOTS] = {
+	{ "src", "application/x-wais-source" },
+	{ "ifc", "application/p21" },
+	{ "xdm", "application/vnd.syncml.dm+xml" },
+	{ "bsd", "chemical/x-crossfire" },
+	{ "xdf", "application/xcap-diff+xml" },
+	{ "xlsm", "application/vnd.ms-excel.sheet.macroEnabled.12" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "cml", "application/cellml+xml" },
+	{ NULL, NULL },
+	{ "kmz", "application/vnd.google-earth.kmz" },
+	{ "esa", "application/vnd.osgi.subsystem" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "sd", "chemical/x-mdl-sdfile" },
+	{ "vcx", "application/vnd.vcx" },
+	{ "udeb", "application/vnd.debian.binary-package" },
+	{ NULL, NULL },
+	{ "or3", "application/vnd.lotus-organizer" },
+	{ "wqd", "application/vnd.wqd" },
+	{ "mseed", "application/vnd.fdsn.mseed" },
+	{ NULL, NULL },
+	{ "xca", "application/xcap-caps+xml" },
+	{ "mc2", "text/vnd.senx.warpscript" },
+	{ "acutc", "application/vnd.acucorp" },
+	{ "wpd", "application/vnd.wordperfect" },
+	{ "s1e", "application/vnd.sealed.xls" },
+	{ "iges", "model/iges" },
+	{ "spl", "application/futuresplash" },
+	{ "tiff", "image/tiff" },
+	{ "grv", "application/vnd.groove-injector" },
+	{ "gpkg.tar", "application/vnd.gentoo.gpkg" },
+	{ "oxlicg", "application/vnd.oxli.countgraph" },
+	{ "gal", "chemical/x-gaussian-log" },
+	{ "ssml", "application/ssml+xml" },
+	{ "axv", "video/annodex" },
+	{ "3dm", "text/vnd.in3d.3dml" },
+	{ NULL, NULL },
+	{ "brf", "text/plain" },
+	{ "wk3", "application/vnd.lotus-1-2-3" },
+	{ "xsm", "application/vnd.syncml+xml" },
+	{ "fst", "image/vnd.fst" },
+	{ "mod", "application/xml-dtd" },
+	{ NULL, NULL },
+	{ "mpc", "application/vnd.mophun.certificate" },
+	{ NULL, NULL },
+	{ "oga", "audio/ogg" },
+	{ "shar", "application/x-shar" },
+	{ "xpr", "application/vnd.is-xpr" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "tat", "application/vnd.onepagertat" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "gen", "chemical/x-genbank" },
+	{ "curl", "text/vnd.curl" },
+	{ "dwd", "application/atsc-dwd+xml" },
+	{ "xott", "application/vnd.collabio.xodocuments.document-template" },
+	{ "aif", "audio/x-aiff" },
+	{ NULL, NULL },
+	{ "mpga", "audio/mpeg" },
+	{ NULL, NULL },
+	{ "ac", "application/pkix-attr-cert" },
+	{ "csf", "chemical/x-cache-csf" },
+	{ NULL, NULL },
+	{ "exe", "application/x-msdos-program" },
+	{ "xop", "application/xop+xml" },
+	{ "sjp", "image/vnd.sealedmedia.softseal.jpg" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "tlclient", "application/vnd.cendio.thinlinc.clientconf" },
+	{ "tfx", "image/tiff-fx" },
+	{ NULL, NULL },
+	{ "imi", "application/vnd.imagemeter.image+zip" },
+	{ "otc", "application/vnd.oasis.opendocument.chart-template" },
+	{ NULL, NULL },
+	{ "nnd", "application/vnd.noblenet-directory" },
+	{ NULL, NULL },
+	{ "held", "application/atsc-held+xml" },
+	{ "gz", "application/gzip" },
+	{ "cii", "application/vnd.anser-web-certificate-issue-initiation" },
+	{ "svg", "image/svg+xml" },
+	{ NULL, NULL },
+	{ "evb", "audio/EVRCB" },
+	{ NULL, NULL },
+	{ "rm", "audio/x-pn-realaudio" },
+	{ "fits", "image/fits" },
+	{ "nitf", "application/vnd.nitf" },
+	{ NULL, NULL },
+	{ "asn", "chemical/x-ncbi-asn1" },
+	{ NULL, NULL },
+	{ "spc", "chemical/x-galactic-spc" },
+	{ "nt", "application/n-triples" },
+	{ NULL, NULL },
+	{ "wma", "audio/x-ms-wma" },
+	{ "uoml", "application/vnd.uoml+xml" },
+	{ NULL, NULL },
+	{ "cdxml", "application/vnd.chemdraw+xml" },
+	{ "skt", "application/vnd.koan" },
+	{ "gamin", "chemical/x-gamess-input" },
+	{ "asice", "application/vnd.etsi.asic-e+zip" },
+	{ NULL, NULL },
+	{ "cdy", "application/vnd.cinderella" },
+	{ "istc", "application/vnd.veryant.thin" },
+	{ "isws", "application/vnd.veryant.thin" },
+	{ "msp", "application/octet-stream" },
+	{ "dpkg", "application/vnd.xmpie.dpkg" },
+	{ "yme", "application/vnd.yaoweme" },
+	{ NULL, NULL },
+	{ "gcd", "text/x-pcs-gcd" },
+	{ "sensmle", "application/sensml-exi" },
+	{ NULL, NULL },
+	{ "saf", "application/vnd.yamaha.smaf-audio" },
+	{ "xodp", "application/vnd.collabio.xodocuments.presentation" },
+	{ "sarif-external-properties.json", "application/sarif-external-properties+json" },
+	{ "dpg", "application/vnd.dpgraph" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "hbci", "application/vnd.hbci" },
+	{ "vsc", "application/vnd.vidsoft.vidconference" },
+	{ "shtml", "text/html" },
+	{ "ims", "application/vnd.ms-ims" },
+	{ "apk", "application/vnd.android.package-archive" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "tcl", "application/x-tcl" },
+	{ "ic3", "application/vnd.commerce-battelle" },
+	{ "wsc", "application/vnd.wfa.wsc" },
+	{ "uo", "application/vnd.uoml+xml" },
+	{ "fit", "image/fits" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "hans", "text/vnd.hans" },
+	{ "lbd", "application/vnd.llamagraphics.life-balance.desktop" },
+	{ NULL, NULL },
+	{ "atomsvc", "application/atomsvc+xml" },
+	{ NULL, NULL },
+	{ "mxml", "application/xv+xml" },
+	{ "h", "text/x-chdr" },
+	{ "xmt_txt", "model/vnd.parasolid.transmit.text" },
+	{ NULL, NULL },
+	{ "roa", "application/rpki-roa" },
+	{ "oxt", "application/vnd.openofficeorg.extension" },
+	{ "gdl", "model/vnd.gdl" },
+	{ NULL, NULL },
+	{ "pskcxml", "application/pskc+xml" },
+	{ "jpx", "image/jpx" },
+	{ "heifs", "image/heif-sequence" },
+	{ NULL, NULL },
+	{ "sxls", "application/vnd.sealed.xls" },
+	{ NULL, NULL },
+	{ "cascii", "chemical/x-cactvs-binary" },
+	{ "vbox", "application/vnd.previewsystems.box" },
+	{ "cbr", "application/vnd.comicbook-rar" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "rb", "application/x-ruby" },
+	{ "gml", "application/gml+xml" },
+	{ "lostsyncxml", "application/lostsync+xml" },
+	{ "emm", "application/vnd.ibm.electronic-media" },
+	{ "potm", "application/vnd.ms-powerpoint.template.macroEnabled.12" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "mwf", "application/vnd.MFER" },
+	{ "dp", "application/vnd.osgi.dp" },
+	{ "flw", "application/vnd.kde.kivio" },
+	{ "woff", "font/woff" },
+	{ NULL, NULL },
+	{ "html", "text/html" },
+	{ "td", "application/urc-targetdesc+xml" },
+	{ "sarif.json", "application/sarif+json" },
+	{ "kwd", "application/vnd.kde.kword" },
+	{ "pyo", "application/x-python-code" },
+	{ NULL, NULL },
+	{ "mpg4", "video/mp4" },
+	{ NULL, NULL },
+	{ "xvml", "application/xv+xml" },
+	{ NULL, NULL },
+	{ "wadl", "application/vnd.sun.wadl+xml" },
+	{ "stc", "application/vnd.sun.xml.calc.template" },
+	{ "mol2", "application/vnd.sybyl.mol2" },
+	{ "slaz", "application/vnd.scribus" },
+	{ "jsontd", "application/td+json" },
+	{ "spd", "application/vnd.sealedmedia.softseal.pdf" },
+	{ "ifm", "application/vnd.shana.informed.formdata" },
+	{ NULL, NULL },
+	{ "gam", "chemical/x-gamess-input" },
+	{ NULL, NULL },
+	{ "wlnk", "application/link-format" },
+	{ "dcr", "application/x-director" },
+	{ "7z", "application/x-7z-compressed" },
+	{ "x3dvz", "model/x3d-vrml" },
+	{ "m4u", "video/vnd.mpegurl" },
+	{ "nbp", "application/vnd.wolfram.player" },
+	{ NULL, NULL },
+	{ "bsp", "model/vnd.valve.source.compiled-map" },
+	{ NULL, NULL },
+	{ "ogg", "audio/ogg" },
+	{ NULL, NULL },
+	{ "sac", "application/tamp-sequence-adjust-confirm" },
+	{ "wmls", "text/vnd.wap.wmlscript" },
+	{ "ica", "application/x-ica" },
+	{ "unityweb", "application/vnd.unity" },
+	{ "ics", "text/calendar" },
+	{ "xcs", "application/calendar+xml" },
+	{ "lgr", "application/lgr+xml" },
+	{ "xhe", "audio/usac" },
+	{ "stpz", "model/step+zip" },
+	{ "sdo", "application/vnd.sealed.doc" },
+	{ NULL, NULL },
+	{ "seml", "application/vnd.sealed.eml" },
+	{ "stif", "application/vnd.sealed.tiff" },
+	{ "texi", "application/x-texinfo" },
+	{ "mid", "audio/sp-midi" },
+	{ "123", "application/vnd.lotus-1-2-3" },
+	{ "tap", "image/vnd.tencent.tap" },
+	{ "mop", "chemical/x-mopac-input" },
+	{ "rlc", "image/vnd.fujixerox.edmics-rlc" },
+	{ "fts", "image/fits" },
+	{ "soc", "application/sgml-open-catalog" },
+	{ "torrent", "application/x-bittorrent" },
+	{ "wvx", "video/x-ms-wvx" },
+	{ "edx", "application/vnd.novadigm.EDX" },
+	{ "clkp", "application/vnd.crick.clicker.palette" },
+	{ "multitrack", "audio/vnd.presonus.multitrack" },
+	{ "mpe", "video/mpeg" },
+	{ "pac", "application/x-ns-proxy-autoconfig" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "jt", "model/JT" },
+	{ NULL, NULL },
+	{ "webmanifest", "application/manifest+json" },
+	{ "link66", "application/vnd.route66.link66+xml" },
+	{ NULL, NULL },
+	{ "ppkg", "application/vnd.xmpie.ppkg" },
+	{ "atomcat", "application/atomcat+xml" },
+	{ "ustar", "application/x-ustar" },
+	{ "hdf", "application/x-hdf" },
+	{ "c11amc", "application/vnd.cluetrust.cartomobile-config" },
+	{ "gim", "application/vnd.groove-identity-message" },
+	{ "x_t", "model/vnd.parasolid.transmit.text" },
+	{ "mcd", "application/vnd.mcd" },
+	{ "m3g", "application/m3g" },
+	{ "mvt", "application/vnd.mapbox-vector-tile" },
+	{ "pcf", "application/x-font-pcf" },
+	{ "opf", "application/oebps-package+xml" },
+	{ "sis", "application/vnd.symbian.install" },
+	{ "nlu", "application/vnd.neurolanguage.nlu" },
+	{ "sos", "text/vnd.sosi" },
+	{ "prt", "chemical/x-ncbi-asn1-ascii" },
+	{ NULL, NULL },
+	{ "tsd", "application/timestamped-data" },
+	{ "cab", "application/vnd.ms-cab-compressed" },
+	{ "dotx", "application/vnd.openxmlformats-officedocument.wordprocessingml.template" },
+	{ NULL, NULL },
+	{ "sema", "application/vnd.sema" },
+	{ "tei", "application/tei+xml" },
+	{ "u8hdr", "message/global-headers" },
+	{ "apkg", "application/vnd.anki" },
+	{ "orc", "audio/csound" },
+	{ "dwf", "model/vnd.dwf" },
+	{ "gff3", "text/gff3" },
+	{ "atomsrv", "application/atomserv+xml" },
+	{ "gau", "chemical/x-gaussian-input" },
+	{ NULL, NULL },
+	{ "svgz", "image/svg+xml" },
+	{ NULL, NULL },
+	{ "mus", "application/vnd.musician" },
+	{ "ntf", "application/vnd.lotus-notes" },
+	{ "uris", "text/uri-list" },
+	{ "ssv", "application/vnd.shade-save-file" },
+	{ "t", "text/troff" },
+	{ "py", "text/x-python" },
+	{ "kfo", "application/vnd.kde.kformula" },
+	{ "vbk", "audio/vnd.nortel.vbk" },
+	{ "p7m", "application/pkcs7-mime" },
+	{ "gtar", "application/x-gtar" },
+	{ "shex", "text/shex" },
+	{ "nsf", "application/vnd.lotus-notes" },
+	{ "c9r", "application/vnd.cryptomator.encrypted" },
+	{ NULL, NULL },
+	{ "xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet" },
+	{ "qbo", "application/vnd.intu.qbo" },
+	{ "ico", "image/vnd.microsoft.icon" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ml2", "application/vnd.sybyl.mol2" },
+	{ NULL, NULL },
+	{ "tsp", "application/dsptype" },
+	{ NULL, NULL },
+	{ "cer", "application/pkix-cert" },
+	{ "sr", "application/vnd.sigrok.session" },
+	{ "appcache", "text/cache-manifest" },
+	{ "ppttc", "application/vnd.think-cell.ppttc+json" },
+	{ "awb", "audio/AMR-WB" },
+	{ NULL, NULL },
+	{ "kpr", "application/vnd.kde.kpresenter" },
+	{ "ic6", "application/vnd.commerce-battelle" },
+	{ "ami", "application/vnd.amiga.ami" },
+	{ "potx", "application/vnd.openxmlformats-officedocument.presentationml.template" },
+	{ "hta", "application/hta" },
+	{ "dna", "application/vnd.dna" },
+	{ "iota", "application/vnd.astraea-software.iota" },
+	{ "dssc", "application/dssc+der" },
+	{ NULL, NULL },
+	{ "obg", "application/vnd.openblox.game-binary" },
+	{ "stix", "application/stix+json" },
+	{ "sensml", "application/sensml+json" },
+	{ "mwc", "application/vnd.dpgraph" },
+	{ "scld", "application/vnd.doremir.scorecloud-binary-document" },
+	{ "uvg", "image/vnd.dece.graphic" },
+	{ NULL, NULL },
+	{ "tamp", "application/vnd.onepagertamp" },
+	{ "mj2", "video/mj2" },
+	{ "epsi", "application/postscript" },
+	{ "pvb", "application/vnd.3gpp.pic-bw-var" },
+	{ "text", "text/plain" },
+	{ NULL, NULL },
+	{ "tau", "application/tamp-apex-update" },
+	{ NULL, NULL },
+	{ "c", "text/x-csrc" },
+	{ "plj", "audio/vnd.everad.plj" },
+	{ "qt", "video/quicktime" },
+	{ "fm", "application/vnd.framemaker" },
+	{ "relo", "application/p2p-overlay+xml" },
+	{ "shaclc", "text/shaclc" },
+	{ "scim", "application/scim+json" },
+	{ "qgs", "application/x-qgis" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ascii", "text/vnd.ascii-art" },
+	{ "pti", "image/prs.pti" },
+	{ "moo", "chemical/x-mopac-out" },
+	{ "moml", "model/vnd.moml+xml" },
+	{ "h++", "text/x-c++hdr" },
+	{ "ccxml", "application/ccxml+xml" },
+	{ NULL, NULL },
+	{ "siv", "application/sieve" },
+	{ "dii", "application/DII" },
+	{ "wv", "application/vnd.wv.csp+wbxml" },
+	{ NULL, NULL },
+	{ "ctx", "chemical/x-ctx" },
+	{ "uvvf", "application/vnd.dece.data" },
+	{ "jdx", "chemical/x-jcamp-dx" },
+	{ "mag", "application/vnd.ecowin.chart" },
+	{ "me", "application/x-troff-me" },
+	{ "lyx", "application/x-lyx" },
+	{ "imgcal", "application/vnd.3lightssoftware.imagescal" },
+	{ NULL, NULL },
+	{ "emma", "application/emma+xml" },
+	{ "sgf", "application/x-go-sgf" },
+	{ NULL, NULL },
+	{ "dae", "model/vnd.collada+xml" },
+	{ NULL, NULL },
+	{ "csvs", "text/csv-schema" },
+	{ "iii", "application/x-iphone" },
+	{ "heics", "image/heic-sequence" },
+	{ "bmp", "image/bmp" },
+	{ "wasm", "application/wasm" },
+	{ NULL, NULL },
+	{ "karbon", "application/vnd.kde.karbon" },
+	{ "ic5", "application/vnd.commerce-battelle" },
+	{ "acn", "audio/asc" },
+	{ "bib", "text/x-bibtex" },
+	{ NULL, NULL },
+	{ "rnd", "application/prs.nprend" },
+	{ "apex", "application/vnd.apexlang" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "cryptomator", "application/vnd.cryptomator.vault" },
+	{ "uvvg", "image/vnd.dece.graphic" },
+	{ "ifb", "text/calendar" },
+	{ "m21", "application/mp21" },
+	{ "xslt", "application/xslt+xml" },
+	{ NULL, NULL },
+	{ "ogx", "application/ogg" },
+	{ "m", "application/vnd.wolfram.mathematica.package" },
+	{ "rtf", "application/rtf" },
+	{ "epsf", "application/postscript" },
+	{ NULL, NULL },
+	{ "apng", "image/apng" },
+	{ "dv", "video/dv" },
+	{ NULL, NULL },
+	{ "hvp", "application/vnd.yamaha.hv-voice" },
+	{ "s1n", "image/vnd.sealed.png" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "grd", "application/vnd.gentics.grd+json" },
+	{ NULL, NULL },
+	{ "vfk", "text/vnd.exchangeable" },
+	{ "ftc", "application/vnd.fluxtime.clip" },
+	{ "com", "application/x-msdos-program" },
+	{ "tex", "text/x-tex" },
+	{ "jpeg", "image/jpeg" },
+	{ "uvp", "video/vnd.dece.pd" },
+	{ "bkm", "application/vnd.nervana" },
+	{ "p7z", "application/pkcs7-mime" },
+	{ "flb", "application/vnd.ficlab.flb+zip" },
+	{ "las", "application/vnd.las" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "tfi", "application/thraud+xml" },
+	{ NULL, NULL },
+	{ "pcap", "application/vnd.tcpdump.pcap" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "uvi", "image/vnd.dece.graphic" },
+	{ "vtf", "image/vnd.valve.source.texture" },
+	{ NULL, NULL },
+	{ "vcd", "application/x-cdlink" },
+	{ "smv", "audio/SMV" },
+	{ "gdz", "application/vnd.familysearch.gedcom+zip" },
+	{ "vms", "chemical/x-vamas-iso14976" },
+	{ "eclass", "application/vnd.gentoo.eclass" },
+	{ NULL, NULL },
+	{ "icf", "application/vnd.commerce-battelle" },
+	{ "dpx", "image/dpx" },
+	{ "sem", "application/vnd.sealed.eml" },
+	{ "tatx", "application/vnd.onepagertatx" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "cpp", "text/x-c++src" },
+	{ NULL, NULL },
+	{ "%", "application/x-trash" },
+	{ "fxp", "application/vnd.adobe.fxp" },
+	{ NULL, NULL },
+	{ "boo", "text/x-boo" },
+	{ "osm", "application/vnd.openstreetmap.data+xml" },
+	{ "tcap", "application/vnd.3gpp2.tcap" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "copyright", "text/vnd.debian.copyright" },
+	{ "vtnstd", "application/vnd.veritone.aion+json" },
+	{ "210", "application/p21" },
+	{ "tgf", "chemical/x-mdl-tgf" },
+	{ NULL, NULL },
+	{ "dx", "chemical/x-jcamp-dx" },
+	{ "mpm", "application/vnd.blueice.multipass" },
+	{ "mrcx", "application/marcxml+xml" },
+	{ "ecelp9600", "audio/vnd.nuera.ecelp9600" },
+	{ "val", "chemical/x-ncbi-asn1-binary" },
+	{ "aiff", "audio/x-aiff" },
+	{ "zip", "application/zip" },
+	{ "sfv", "text/x-sfv" },
+	{ "ebuild", "application/vnd.gentoo.ebuild" },
+	{ NULL, NULL },
+	{ "vcg", "application/vnd.groove-vcard" },
+	{ "sar", "application/vnd.sar" },
+	{ "cat", "application/vnd.ms-pki.seccat" },
+	{ "gqf", "application/vnd.grafeq" },
+	{ "hvs", "application/vnd.yamaha.hv-script" },
+	{ NULL, NULL },
+	{ "fly", "text/vnd.fly" },
+	{ "xml", "application/xml" },
+	{ "vds", "model/vnd.sap.vds" },
+	{ "ltx", "text/x-tex" },
+	{ NULL, NULL },
+	{ "wmv", "video/x-ms-wmv" },
+	{ NULL, NULL },
+	{ "shp", "application/vnd.shp" },
+	{ "pre", "application/vnd.lotus-freelance" },
+	{ "crl", "application/pkix-crl" },
+	{ "package", "application/vnd.autopackage" },
+	{ NULL, NULL },
+	{ "wspolicy", "application/wspolicy+xml" },
+	{ "bik", "video/vnd.radgamettools.bink" },
+	{ NULL, NULL },
+	{ "xots", "application/vnd.collabio.xodocuments.spreadsheet-template" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "fxpl", "application/vnd.adobe.fxp" },
+	{ "cef", "chemical/x-cxf" },
+	{ "sensmlc", "application/sensml+cbor" },
+	{ "patch", "text/x-diff" },
+	{ "rq", "application/sparql-query" },
+	{ NULL, NULL },
+	{ "g3w", "application/vnd.geospace" },
+	{ "mdc", "application/vnd.marlin.drm.mdcf" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "miz", "text/mizar" },
+	{ "hpi", "application/vnd.hp-hpid" },
+	{ "p8", "application/pkcs8" },
+	{ NULL, NULL },
+	{ "xlam", "application/vnd.ms-excel.addin.macroEnabled.12" },
+	{ "jtd", "text/vnd.esmertec.theme-descriptor" },
+	{ "hpub", "application/prs.hpub+zip" },
+	{ "vcf", "text/vcard" },
+	{ "rxn", "chemical/x-mdl-rxnfile" },
+	{ "arrow", "application/vnd.apache.arrow.file" },
+	{ "obj", "model/obj" },
+	{ "lha", "application/x-lha" },
+	{ "gpt", "chemical/x-mopac-graph" },
+	{ "uvvu", "video/vnd.dece.mp4" },
+	{ "ggb", "application/vnd.geogebra.file" },
+	{ "xdw", "application/vnd.fujixerox.docuworks" },
+	{ "dvc", "application/dvcs" },
+	{ NULL, NULL },
+	{ "fsc", "application/vnd.fsc.weblaunch" },
+	{ "mpp", "application/vnd.ms-project" },
+	{ "bcpio", "application/x-bcpio" },
+	{ "rdf", "application/rdf+xml" },
+	{ NULL, NULL },
+	{ "1clr", "application/clr" },
+	{ "embl", "chemical/x-embl-dl-nucleotide" },
+	{ NULL, NULL },
+	{ "smht", "application/vnd.sealed.mht" },
+	{ NULL, NULL },
+	{ "dtd", "application/xml-dtd" },
+	{ "xdp", "application/vnd.adobe.xdp+xml" },
+	{ "mph", "application/x-comsol" },
+	{ "uvvp", "video/vnd.dece.pd" },
+	{ "x3db", "model/x3d+fastinfoset" },
+	{ "cwl", "application/cwl" },
+	{ NULL, NULL },
+	{ "n3", "text/n3" },
+	{ "csp", "application/vnd.commonspace" },
+	{ "dif", "video/dv" },
+	{ "str", "application/vnd.pg.format" },
+	{ NULL, NULL },
+	{ "gbr", "application/rpki-ghostbusters" },
+	{ NULL, NULL },
+	{ "s11", "video/vnd.sealed.mpeg1" },
+	{ NULL, NULL },
+	{ "orf", "image/x-olympus-orf" },
+	{ "gjf", "chemical/x-gaussian-input" },
+	{ "pas", "text/x-pascal" },
+	{ "gre", "application/vnd.geometry-explorer" },
+	{ NULL, NULL },
+	{ "zir", "application/vnd.zul" },
+	{ "smh", "application/vnd.sealed.mht" },
+	{ "rsat", "application/atsc-rsat+xml" },
+	{ NULL, NULL },
+	{ "hal", "application/vnd.hal+xml" },
+	{ NULL, NULL },
+	{ "pcf.z", "application/x-font-pcf" },
+	{ NULL, NULL },
+	{ "ecig", "application/vnd.evolv.ecig.settings" },
+	{ NULL, NULL },
+	{ "nml", "application/vnd.enliven" },
+	{ "hh", "text/x-c++hdr" },
+	{ NULL, NULL },
+	{ "sxi", "application/vnd.sun.xml.impress" },
+	{ "mxf", "application/mxf" },
+	{ "yin", "application/yin+xml" },
+	{ "gltf", "model/gltf+json" },
+	{ "txf", "application/vnd.Mobius.TXF" },
+	{ "hdt", "application/vnd.hdt" },
+	{ "aac", "audio/aac" },
+	{ "xav", "application/xcap-att+xml" },
+	{ "ecigprofile", "application/vnd.evolv.ecig.profile" },
+	{ "irp", "application/vnd.irepository.package+xml" },
+	{ "s14", "video/vnd.sealed.mpeg4" },
+	{ NULL, NULL },
+	{ "jmz", "application/x-jmol" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "skd", "application/vnd.koan" },
+	{ NULL, NULL },
+	{ "listafp", "application/vnd.afpc.modca" },
+	{ "htm", "text/html" },
+	{ "odi", "application/vnd.oasis.opendocument.image" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "sds", "application/vnd.stardivision.chart" },
+	{ "aa3", "audio/ATRAC3" },
+	{ "ief", "image/ief" },
+	{ "qfx", "application/vnd.intu.qfx" },
+	{ "uvvm", "video/vnd.dece.mobile" },
+	{ "mf4", "application/MF4" },
+	{ NULL, NULL },
+	{ "xlf", "application/xliff+xml" },
+	{ NULL, NULL },
+	{ "rd", "chemical/x-mdl-rdfile" },
+	{ "qam", "application/vnd.epson.quickanime" },
+	{ "pbm", "image/x-portable-bitmap" },
+	{ "sensmlx", "application/sensml+xml" },
+	{ "afp", "application/vnd.afpc.modca" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "dit", "application/DIT" },
+	{ NULL, NULL },
+	{ "imscc", "application/vnd.ims.imsccv1p1" },
+	{ "wpl", "application/vnd.ms-wpl" },
+	{ "lsf", "video/x-la-asf" },
+	{ "xdssc", "application/dssc+xml" },
+	{ NULL, NULL },
+	{ "vtu", "model/vnd.vtu" },
+	{ "ogex", "model/vnd.opengex" },
+	{ "irm", "application/vnd.ibm.rights-management" },
+	{ "ktr", "application/vnd.kahootz" },
+	{ "cdr", "image/x-coreldraw" },
+	{ "msa", "application/vnd.msa-disk-image" },
+	{ "cdt", "image/x-coreldrawtemplate" },
+	{ "rgbe", "image/vnd.radiance" },
+	{ "cmp", "application/vnd.yellowriver-custom-menu" },
+	{ "atomdeleted", "application/atomdeleted+xml" },
+	{ "tnf", "application/vnd.ms-tnef" },
+	{ "ppsx", "application/vnd.openxmlformats-officedocument.presentationml.slideshow" },
+	{ "opus", "audio/ogg" },
+	{ "mail", "message/rfc822" },
+	{ "dmp", "application/vnd.tcpdump.pcap" },
+	{ "x3dv", "model/x3d-vrml" },
+	{ "fbs", "image/vnd.fastbidsheet" },
+	{ "nb", "application/vnd.wolfram.mathematica" },
+	{ "s1p", "application/vnd.sealed.ppt" },
+	{ "ktx2", "image/ktx2" },
+	{ "lzh", "application/x-lzh" },
+	{ "mp1", "audio/mpeg" },
+	{ "aifc", "audio/x-aiff" },
+	{ "gif", "image/gif" },
+	{ "tsq", "application/timestamp-query" },
+	{ "vsw", "application/vnd.visio" },
+	{ "dcm", "application/dicom" },
+	{ NULL, NULL },
+	{ "lrm", "application/vnd.ms-lrm" },
+	{ NULL, NULL },
+	{ "rip", "audio/vnd.rip" },
+	{ "bmi", "application/vnd.bmi" },
+	{ NULL, NULL },
+	{ "senml-etchj", "application/senml-etch+json" },
+	{ "gsheet", "application/urc-grpsheet+xml" },
+	{ "bar", "application/vnd.qualcomm.brew-app-res" },
+	{ "keynote", "application/vnd.apple.keynote" },
+	{ "nsh", "application/vnd.lotus-notes" },
+	{ "pml", "application/vnd.ctc-posml" },
+	{ "sam", "application/vnd.lotus-wordpro" },
+	{ "jxs", "image/jxs" },
+	{ NULL, NULL },
+	{ "wmz", "application/x-ms-wmz" },
+	{ "eln", "application/vnd.eln+zip" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ktz", "application/vnd.kahootz" },
+	{ "fli", "video/fli" },
+	{ "dts", "audio/vnd.dts" },
+	{ NULL, NULL },
+	{ "amlx", "application/automationml-amlx+zip" },
+	{ "uvz", "application/vnd.dece.zip" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "sm", "application/vnd.stepmania.stepchart" },
+	{ "lvp", "audio/vnd.lucent.voice" },
+	{ "djv", "image/vnd.djvu" },
+	{ "sti", "application/vnd.sun.xml.impress.template" },
+	{ "gl", "video/gl" },
+	{ "clkt", "application/vnd.crick.clicker.template" },
+	{ "rct", "application/prs.nprend" },
+	{ "finf", "application/fastinfoset" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "wbmp", "image/vnd.wap.wbmp" },
+	{ "wm", "video/x-ms-wm" },
+	{ "sxm", "application/vnd.sun.xml.math" },
+	{ NULL, NULL },
+	{ "ppd", "application/vnd.cups-ppd" },
+	{ "mdb", "application/msaccess" },
+	{ "xz", "application/x-xz" },
+	{ "mp3", "audio/mpeg" },
+	{ "kwt", "application/vnd.kde.kword" },
+	{ "deb", "application/vnd.debian.binary-package" },
+	{ "aion", "application/vnd.veritone.aion+json" },
+	{ "dpgraph", "application/vnd.dpgraph" },
+	{ NULL, NULL },
+	{ "ppm", "image/x-portable-pixmap" },
+	{ "sda", "application/vnd.stardivision.draw" },
+	{ "qtl", "application/x-quicktimeplayer" },
+	{ "taz", "application/x-gtar-compressed" },
+	{ NULL, NULL },
+	{ "fchk", "chemical/x-gaussian-checkpoint" },
+	{ NULL, NULL },
+	{ "vpm", "multipart/voice-message" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "wps", "application/vnd.ms-works" },
+	{ "bed", "application/vnd.realvnc.bed" },
+	{ "adts", "audio/aac" },
+	{ "p21", "application/p21" },
+	{ NULL, NULL },
+	{ "jar", "application/java-archive" },
+	{ "stpnc", "application/p21" },
+	{ "xspf", "application/xspf+xml" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "csd", "audio/csound" },
+	{ "ots", "application/vnd.oasis.opendocument.spreadsheet-template" },
+	{ "kom", "application/vnd.hbci" },
+	{ "info", "application/x-info" },
+	{ "espass", "application/vnd.espass-espass+zip" },
+	{ "quiz", "application/vnd.quobject-quoxdocument" },
+	{ "thmx", "application/vnd.ms-officetheme" },
+	{ "ei6", "application/vnd.pg.osasli" },
+	{ "ttml", "application/ttml+xml" },
+	{ "susp", "application/vnd.sus-calendar" },
+	{ "rsheet", "application/urc-ressheet+xml" },
+	{ "portpkg", "application/vnd.macports.portpkg" },
+	{ "sc", "application/vnd.ibm.secure-container" },
+	{ "hgl", "text/vnd.hgl" },
+	{ "crtr", "application/vnd.multiad.creator" },
+	{ "msf", "application/vnd.epson.msf" },
+	{ "mods", "application/mods+xml" },
+	{ "mmdb", "application/vnd.maxmind.maxmind-db" },
+	{ "mlp", "audio/vnd.dolby.mlp" },
+	{ "pseg3820", "application/vnd.afpc.modca" },
+	{ "gan", "application/x-ganttproject" },
+	{ "dvi", "application/x-dvi" },
+	{ "exp", "application/express" },
+	{ "webm", "video/webm" },
+	{ "odp", "application/vnd.oasis.opendocument.presentation" },
+	{ "mif", "application/vnd.mif" },
+	{ "ts", "text/vnd.trolltech.linguist" },
+	{ "psb", "application/vnd.3gpp.pic-bw-small" },
+	{ "bdm", "application/vnd.syncml.dm+wbxml" },
+	{ "tr", "text/troff" },
+	{ NULL, NULL },
+	{ "odx", "application/ODX" },
+	{ "spf", "application/vnd.yamaha.smaf-phrase" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "xfd", "application/vnd.xfdl" },
+	{ "artisan", "application/vnd.artisan+json" },
+	{ "eot", "application/vnd.ms-fontobject" },
+	{ "gxt", "application/vnd.geonext" },
+	{ "flv", "video/x-flv" },
+	{ "cac", "chemical/x-cache" },
+	{ "b", "chemical/x-molconn-Z" },
+	{ "swf", "application/vnd.adobe.flash.movie" },
+	{ "jpgm", "image/jpm" },
+	{ "wif", "application/watcherinfo+xml" },
+	{ "aso", "application/vnd.accpac.simply.aso" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "x_b", "model/vnd.parasolid.transmit.binary" },
+	{ "tar", "application/x-tar" },
+	{ "rss", "application/x-rss+xml" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "scq", "application/scvp-cv-request" },
+	{ "wz", "application/x-wingz" },
+	{ "ves", "application/vnd.ves.encrypted" },
+	{ "hvd", "application/vnd.yamaha.hv-dic" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ndc", "application/vnd.osa.netdeploy" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ddd", "application/vnd.fujixerox.ddd" },
+	{ "geo", "application/vnd.dynageo" },
+	{ "scsf", "application/vnd.sealed.csf" },
+	{ NULL, NULL },
+	{ "gtm", "application/vnd.groove-tool-message" },
+	{ "fg5", "application/vnd.fujitsu.oasysgp" },
+	{ "xpx", "application/vnd.intercon.formnet" },
+	{ "scd", "application/vnd.scribus" },
+	{ "gsf", "application/x-font" },
+	{ "mtl", "model/mtl" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "sxc", "application/vnd.sun.xml.calc" },
+	{ "x3dz", "model/x3d+xml" },
+	{ "rdp", "application/x-rdp" },
+	{ "hpid", "application/vnd.hp-hpid" },
+	{ "xpw", "application/vnd.intercon.formnet" },
+	{ "sms", "application/vnd.3gpp2.sms" },
+	{ NULL, NULL },
+	{ "jxss", "image/jxss" },
+	{ NULL, NULL },
+	{ "std", "application/vnd.sun.xml.draw.template" },
+	{ "wmf", "image/wmf" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "genozip", "application/vnd.genozip" },
+	{ "csv", "text/csv" },
+	{ "uvvv", "video/vnd.dece.video" },
+	{ "s1h", "application/vnd.sealedmedia.softseal.html" },
+	{ "ent", "application/xml-external-parsed-entity" },
+	{ "cla", "application/vnd.claymore" },
+	{ "msm", "model/vnd.gdl" },
+	{ "3mf", "application/vnd.ms-3mfdocument" },
+	{ "senml-etchc", "application/senml-etch+cbor" },
+	{ "lasxml", "application/vnd.las.las+xml" },
+	{ NULL, NULL },
+	{ "qcall", "application/vnd.ericsson.quickcall" },
+	{ NULL, NULL },
+	{ "onepkg", "application/onenote" },
+	{ NULL, NULL },
+	{ "atom", "application/atom+xml" },
+	{ "usda", "model/vnd.usda" },
+	{ "mesh", "model/mesh" },
+	{ NULL, NULL },
+	{ "mp4", "video/mp4" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "hs", "text/x-haskell" },
+	{ "teicorpus", "application/tei+xml" },
+	{ "spn", "image/vnd.sealed.png" },
+	{ NULL, NULL },
+	{ "ogv", "video/ogg" },
+	{ "pkipath", "application/pkix-pkipath" },
+	{ "mxs", "application/vnd.triscape.mxs" },
+	{ "acu", "application/vnd.acucobol" },
+	{ "dvb", "video/vnd.dvb.file" },
+	{ "dis", "application/vnd.Mobius.DIS" },
+	{ "pgm", "image/x-portable-graymap" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "sy2", "application/vnd.sybyl.mol2" },
+	{ "uvvh", "video/vnd.dece.hd" },
+	{ "g2w", "application/vnd.geoplan" },
+	{ "xbd", "application/vnd.fujixerox.docuworks.binder" },
+	{ "gpkg", "application/geopackage+sqlite3" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "rpss", "application/vnd.nokia.radio-presets" },
+	{ "tuc", "application/tamp-update-confirm" },
+	{ "stml", "application/vnd.sealedmedia.softseal.html" },
+	{ "dmg", "application/x-apple-diskimage" },
+	{ "urim", "application/vnd.uri-map" },
+	{ NULL, NULL },
+	{ "mhas", "audio/mhas" },
+	{ "loas", "audio/usac" },
+	{ "nimn", "application/vnd.nimn" },
+	{ "shx", "application/vnd.shx" },
+	{ "rl", "application/resource-lists+xml" },
+	{ "abc", "text/vnd.abc" },
+	{ "pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation" },
+	{ "cmc", "application/vnd.cosmocaller" },
+	{ "dim", "application/vnd.fastcopy-disk-image" },
+	{ "shf", "application/shf+xml" },
+	{ NULL, NULL },
+	{ "frm", "application/vnd.ufdl" },
+	{ "oa2", "application/vnd.fujitsu.oasys2" },
+	{ "txt", "text/plain" },
+	{ NULL, NULL },
+	{ "ai", "application/postscript" },
+	{ "xtel", "chemical/x-xtel" },
+	{ NULL, NULL },
+	{ "rld", "application/resource-lists-diff+xml" },
+	{ NULL, NULL },
+	{ "sxw", "application/vnd.sun.xml.writer" },
+	{ NULL, NULL },
+	{ "kcm", "application/vnd.nervana" },
+	{ NULL, NULL },
+	{ "uvvs", "video/vnd.dece.sd" },
+	{ "smi", "application/smil+xml" },
+	{ "jad", "text/vnd.sun.j2me.app-descriptor" },
+	{ "qvd", "application/vnd.theqvd" },
+	{ "flo", "application/vnd.micrografx.flo" },
+	{ "ms", "application/x-troff-ms" },
+	{ "pub", "application/vnd.exstream-package" },
+	{ NULL, NULL },
+	{ "ez2", "application/vnd.ezpix-album" },
+	{ "ggs", "application/vnd.geogebra.slides" },
+	{ "sdoc", "application/vnd.sealed.doc" },
+	{ "sdf", "application/vnd.Kinar" },
+	{ "emb", "chemical/x-embl-dl-nucleotide" },
+	{ "mpt", "application/vnd.ms-project" },
+	{ "mpkg", "application/vnd.apple.installer+xml" },
+	{ "dart", "application/vnd.dart" },
+	{ "btif", "image/prs.btif" },
+	{ "ndl", "application/vnd.lotus-notes" },
+	{ "rif", "application/reginfo+xml" },
+	{ "mseq", "application/vnd.mseq" },
+	{ "markdown", "text/markdown" },
+	{ NULL, NULL },
+	{ "3dml", "text/vnd.in3d.3dml" },
+	{ "x3d", "model/x3d+xml" },
+	{ "fcs", "application/vnd.isac.fcs" },
+	{ NULL, NULL },
+	{ "sswf", "video/vnd.sealed.swf" },
+	{ "man", "application/x-troff-man" },
+	{ "ic1", "application/vnd.commerce-battelle" },
+	{ "pps", "application/vnd.ms-powerpoint" },
+	{ "pwn", "application/vnd.3M.Post-it-Notes" },
+	{ "cda", "application/x-cdf" },
+	{ "pfa", "application/x-font" },
+	{ "utz", "application/vnd.uiq.theme" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "anx", "application/annodex" },
+	{ "u3d", "model/u3d" },
+	{ "zirz", "application/vnd.zul" },
+	{ NULL, NULL },
+	{ "zmt", "chemical/x-mopac-input" },
+	{ "list3820", "application/vnd.afpc.modca" },
+	{ "jsontm", "application/tm+json" },
+	{ "cif", "application/vnd.multiad.creator.cif" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "rep", "application/vnd.businessobjects" },
+	{ NULL, NULL },
+	{ "xer", "application/xcap-error+xml" },
+	{ "pot", "text/plain" },
+	{ "sxg", "application/vnd.sun.xml.writer.global" },
+	{ NULL, NULL },
+	{ "rdz", "application/vnd.data-vision.rdz" },
+	{ NULL, NULL },
+	{ "spq", "application/scvp-vp-request" },
+	{ NULL, NULL },
+	{ "jhc", "image/jphc" },
+	{ "cellml", "application/cellml+xml" },
+	{ "xlim", "application/vnd.xmpie.xlim" },
+	{ "oxps", "application/oxps" },
+	{ "vxml", "application/voicexml+xml" },
+	{ "plc", "application/vnd.Mobius.PLC" },
+	{ "cdmid", "application/cdmi-domain" },
+	{ "wbs", "application/vnd.criticaltools.wbs+xml" },
+	{ "mb", "application/mathematica" },
+	{ "rs", "application/rls-services+xml" },
+	{ "asics", "application/vnd.etsi.asic-s+zip" },
+	{ NULL, NULL },
+	{ "cww", "application/prs.cww" },
+	{ "wtb", "application/vnd.webturbo" },
+	{ "fe_launch", "application/vnd.denovo.fcselayout-link" },
+	{ "lbc", "audio/iLBC" },
+	{ "chrt", "application/vnd.kde.kchart" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "uvvd", "application/vnd.dece.data" },
+	{ NULL, NULL },
+	{ "its", "application/its+xml" },
+	{ "psid", "audio/prs.sid" },
+	{ "mxu", "video/vnd.mpegurl" },
+	{ "mdi", "image/vnd.ms-modi" },
+	{ NULL, NULL },
+	{ "cea", "application/CEA" },
+	{ "rnc", "application/relax-ng-compact-syntax" },
+	{ "cpio", "application/x-cpio" },
+	{ "wad", "application/x-doom" },
+	{ "oprc", "application/vnd.palm" },
+	{ "shc", "text/shaclc" },
+	{ "cc", "text/x-c++src" },
+	{ "uva", "audio/vnd.dece.audio" },
+	{ "request", "application/vnd.nervana" },
+	{ "pat", "image/x-coreldrawpattern" },
+	{ "aep", "application/vnd.audiograph" },
+	{ "spdx.json", "application/spdx+json" },
+	{ "old", "application/x-trash" },
+	{ "pages", "application/vnd.apple.pages" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "jsonld", "application/ld+json" },
+	{ "vmd", "chemical/x-vmd" },
+	{ "hej2", "image/hej2k" },
+	{ "uvs", "video/vnd.dece.sd" },
+	{ NULL, NULL },
+	{ "moc", "text/x-moc" },
+	{ "inp", "chemical/x-gamess-input" },
+	{ "atxml", "application/ATXML" },
+	{ "ngdat", "application/vnd.nokia.n-gage.data" },
+	{ "lhzl", "application/vnd.belightsoft.lhzl+zip" },
+	{ "tatp", "application/vnd.onepagertatp" },
+	{ "tnef", "application/vnd.ms-tnef" },
+	{ "uis", "application/urc-uisocketdesc+xml" },
+	{ "wsdl", "application/wsdl+xml" },
+	{ "mc1", "application/vnd.medcalcdata" },
+	{ "apxml", "application/auth-policy+xml" },
+	{ "sig", "application/pgp-signature" },
+	{ NULL, NULL },
+	{ "sfs", "application/vnd.spotfire.sfs" },
+	{ "enw", "audio/EVRCNW" },
+	{ "htc", "text/x-component" },
+	{ "pem", "application/pem-certificate-chain" },
+	{ NULL, NULL },
+	{ "xhvml", "application/xv+xml" },
+	{ "ahead", "application/vnd.ahead.space" },
+	{ "or2", "application/vnd.lotus-organizer" },
+	{ "dms", "text/vnd.DMClientScript" },
+	{ "joda", "application/vnd.joost.joda-archive" },
+	{ "usdz", "model/vnd.usdz+zip" },
+	{ "m1v", "video/mpeg" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "mjs", "text/javascript" },
+	{ NULL, NULL },
+	{ "xif", "image/vnd.xiff" },
+	{ "erf", "image/x-epson-erf" },
+	{ "latex", "application/x-latex" },
+	{ "m3u", "audio/mpegurl" },
+	{ NULL, NULL },
+	{ "ssw", "video/vnd.sealed.swf" },
+	{ "xsf", "application/prs.xsf+xml" },
+	{ NULL, NULL },
+	{ "semd", "application/vnd.semd" },
+	{ "sdp", "application/sdp" },
+	{ NULL, NULL },
+	{ "wks", "application/vnd.ms-works" },
+	{ NULL, NULL },
+	{ "docm", "application/vnd.ms-word.document.macroEnabled.12" },
+	{ "dwg", "image/vnd.dwg" },
+	{ "iso", "application/x-iso9660-image" },
+	{ NULL, NULL },
+	{ "vmt", "application/vnd.valve.source.material" },
+	{ "pkd", "application/vnd.hbci" },
+	{ "btf", "image/prs.btif" },
+	{ "c4d", "application/vnd.clonk.c4group" },
+	{ "ecigtheme", "application/vnd.evolv.ecig.theme" },
+	{ "line", "application/vnd.nebumind.line" },
+	{ NULL, NULL },
+	{ "hpp", "text/x-c++hdr" },
+	{ "ic0", "application/vnd.commerce-battelle" },
+	{ "sdd", "application/vnd.stardivision.impress" },
+	{ "vsf", "application/vnd.vsf" },
+	{ NULL, NULL },
+	{ "p7c", "application/pkcs7-mime" },
+	{ "pl", "text/x-perl" },
+	{ "p12", "application/pkcs12" },
+	{ "meta4", "application/metalink4+xml" },
+	{ "wmd", "application/x-ms-wmd" },
+	{ "smzip", "application/vnd.stepmania.package" },
+	{ "imp", "application/vnd.accpac.simply.imp" },
+	{ "s1g", "image/vnd.sealedmedia.softseal.gif" },
+	{ "mm", "application/x-freemind" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "sco", "audio/csound" },
+	{ "dist", "application/vnd.apple.installer+xml" },
+	{ "msi", "application/x-msi" },
+	{ NULL, NULL },
+	{ "ins", "application/x-internet-signup" },
+	{ "mvb", "chemical/x-mopac-vib" },
+	{ "qxt", "application/vnd.Quark.QuarkXPress" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "odm", "application/vnd.oasis.opendocument.text-master" },
+	{ "qwt", "application/vnd.Quark.QuarkXPress" },
+	{ NULL, NULL },
+	{ "wafl", "application/vnd.wasmflow.wafl" },
+	{ "cpa", "chemical/x-compass" },
+	{ "p8e", "application/pkcs8-encrypted" },
+	{ "rgb", "image/x-rgb" },
+	{ "vtt", "text/vtt" },
+	{ "stpx", "model/step+xml" },
+	{ "kne", "application/vnd.Kinar" },
+	{ "cxf", "chemical/x-cxf" },
+	{ "xyze", "image/vnd.radiance" },
+	{ NULL, NULL },
+	{ "uvva", "audio/vnd.dece.audio" },
+	{ NULL, NULL },
+	{ "sv4cpio", "application/x-sv4cpio" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "fla", "application/vnd.dtg.local.flash" },
+	{ NULL, NULL },
+	{ "sfc", "application/vnd.nintendo.snes.rom" },
+	{ "cxx", "text/x-c++src" },
+	{ "atx", "audio/ATRAC-X" },
+	{ "dir", "application/x-director" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "art", "image/x-jg" },
+	{ "mml", "application/mathml+xml" },
+	{ "fig", "application/x-xfig" },
+	{ NULL, NULL },
+	{ "imf", "application/vnd.imagemeter.folder+zip" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "cdmio", "application/cdmi-object" },
+	{ "bh2", "application/vnd.fujitsu.oasysprs" },
+	{ NULL, NULL },
+	{ "ivu", "application/vnd.immervision-ivu" },
+	{ NULL, NULL },
+	{ "lhzd", "application/vnd.belightsoft.lhzd+zip" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "sv4crc", "application/x-sv4crc" },
+	{ "rlm", "application/vnd.resilient.logic" },
+	{ "ota", "application/vnd.android.ota" },
+	{ "ep", "application/vnd.bluetooth.ep.oob" },
+	{ "c11amz", "application/vnd.cluetrust.cartomobile-config-pkg" },
+	{ "o", "application/x-object" },
+	{ "fdf", "application/fdf" },
+	{ "lbe", "application/vnd.llamagraphics.life-balance.exchange+xml" },
+	{ "wax", "audio/x-ms-wax" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "tur", "application/tamp-update" },
+	{ "wav", "audio/x-wav" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "lzx", "application/x-lzx" },
+	{ "xlsb", "application/vnd.ms-excel.sheet.binary.macroEnabled.12" },
+	{ NULL, NULL },
+	{ "spot", "text/vnd.in3d.spot" },
+	{ "smf", "application/vnd.stardivision.math" },
+	{ NULL, NULL },
+	{ "ors", "application/ocsp-response" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "oeb", "application/vnd.openeye.oeb" },
+	{ NULL, NULL },
+	{ "zaz", "application/vnd.zzazz.deck+xml" },
+	{ "dxp", "application/vnd.spotfire.dxp" },
+	{ "mp21", "application/mp21" },
+	{ "uvv", "video/vnd.dece.video" },
+	{ NULL, NULL },
+	{ "pya", "audio/vnd.ms-playready.media.pya" },
+	{ "skm", "application/vnd.koan" },
+	{ "ma", "application/mathematica" },
+	{ "fpx", "image/vnd.fpx" },
+	{ "flac", "audio/flac" },
+	{ "sfd", "application/vnd.font-fontforge-sfd" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "dsm", "application/vnd.desmume.movie" },
+	{ "ic4", "application/vnd.commerce-battelle" },
+	{ "senmlc", "application/senml+cbor" },
+	{ "slc", "application/vnd.wap.slc" },
+	{ "cr2", "image/x-canon-cr2" },
+	{ "provx", "application/provenance+xml" },
+	{ NULL, NULL },
+	{ "lpf", "application/lpf+zip" },
+	{ "sdkm", "application/vnd.solent.sdkm+xml" },
+	{ NULL, NULL },
+	{ "obgx", "application/vnd.openblox.game+xml" },
+	{ NULL, NULL },
+	{ "pcl", "application/vnd.hp-PCL" },
+	{ NULL, NULL },
+	{ "s1m", "audio/vnd.sealedmedia.softseal.mpeg" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "rapd", "application/route-apd+xml" },
+	{ "chm", "application/vnd.ms-htmlhelp" },
+	{ "glb", "model/gltf-binary" },
+	{ "azs", "application/vnd.airzip.filesecure.azs" },
+	{ "rusd", "application/route-usd+xml" },
+	{ "l16", "audio/L16" },
+	{ NULL, NULL },
+	{ "si", "text/vnd.wap.si" },
+	{ "silo", "model/mesh" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "xyz", "chemical/x-xyz" },
+	{ "st", "application/vnd.sailingtracker.track" },
+	{ "css", "text/css" },
+	{ "wmlc", "application/vnd.wap.wmlc" },
+	{ "fti", "application/vnd.anser-web-funds-transfer-initiation" },
+	{ "exr", "image/aces" },
+	{ "wg", "application/vnd.pmi.widget" },
+	{ "drle", "image/dicom-rle" },
+	{ "pfb", "application/x-font" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "fb", "application/x-maker" },
+	{ "pbd", "application/vnd.powerbuilder6" },
+	{ "p", "text/x-pascal" },
+	{ "qcp", "audio/EVRC-QCP" },
+	{ "stk", "application/hyperstudio" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "qps", "application/vnd.publishare-delta-tree" },
+	{ "zst", "application/zstd" },
+	{ "tamx", "application/vnd.onepagertamx" },
+	{ "tag", "text/prs.lines.tag" },
+	{ NULL, NULL },
+	{ "lasjson", "application/vnd.las.las+json" },
+	{ NULL, NULL },
+	{ "vrml", "model/vrml" },
+	{ "sce", "application/vnd.etsi.asic-e+zip" },
+	{ "cdmic", "application/cdmi-container" },
+	{ "lmp", "model/vnd.gdl" },
+	{ "kia", "application/vnd.kidspiration" },
+	{ "age", "application/vnd.age" },
+	{ "viaframe", "application/vnd.tml" },
+	{ "spdx", "text/spdx" },
+	{ "xpm", "image/x-xpixmap" },
+	{ "ods", "application/vnd.oasis.opendocument.spreadsheet" },
+	{ "pnm", "image/x-portable-anymap" },
+	{ "ctab", "chemical/x-cactvs-binary" },
+	{ "xul", "application/vnd.mozilla.xul+xml" },
+	{ "preminet", "application/vnd.preminet" },
+	{ "cst", "application/vnd.commonspace" },
+	{ "ism", "model/vnd.gdl" },
+	{ "sxl", "application/vnd.sealed.xls" },
+	{ "pki", "application/pkixcmp" },
+	{ "grxml", "application/srgs+xml" },
+	{ NULL, NULL },
+	{ "plp", "application/vnd.panoply" },
+	{ "hsj2", "image/hsj2" },
+	{ "syft.json", "application/vnd.syft+json" },
+	{ "3tz", "application/vnd.maxar.archive.3tz+zip" },
+	{ NULL, NULL },
+	{ "carjson", "application/vnd.eu.kasparian.car+json" },
+	{ "xar", "application/vnd.xara" },
+	{ NULL, NULL },
+	{ "p2p", "application/vnd.wfa.p2p" },
+	{ NULL, NULL },
+	{ "cl", "application/simple-filter+xml" },
+	{ "psg", "application/vnd.afpc.modca-pagesegment" },
+	{ NULL, NULL },
+	{ "sofa", "audio/sofa" },
+	{ "jxra", "image/jxrA" },
+	{ "heif", "image/heif" },
+	{ "knp", "application/vnd.Kinar" },
+	{ "coswid", "application/swid+cbor" },
+	{ "bpd", "application/vnd.hbci" },
+	{ "qxl", "application/vnd.Quark.QuarkXPress" },
+	{ "vis", "application/vnd.visionary" },
+	{ "oda", "application/ODA" },
+	{ "msl", "application/vnd.Mobius.MSL" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "odg", "application/vnd.oasis.opendocument.graphics" },
+	{ NULL, NULL },
+	{ "wgsl", "text/wgsl" },
+	{ "rdf-crypt", "application/prs.rdf-xml-crypt" },
+	{ "omg", "audio/ATRAC3" },
+	{ "eml", "message/rfc822" },
+	{ "twds", "application/vnd.SimTech-MindMapper" },
+	{ "mgp", "application/vnd.osgeo.mapguide.package" },
+	{ "cls", "text/x-tex" },
+	{ "exi", "application/exi" },
+	{ "mts", "model/vnd.mts" },
+	{ "cpkg", "application/vnd.xmpie.cpkg" },
+	{ "bmed", "multipart/vnd.bint.med-plus" },
+	{ "les", "application/vnd.hhe.lesson-player" },
+	{ NULL, NULL },
+	{ "sik", "application/x-trash" },
+	{ "azf", "application/vnd.airzip.filesecure.azf" },
+	{ "cbor", "application/cbor" },
+	{ "kin", "chemical/x-kinemage" },
+	{ "fbdoc", "application/x-maker" },
+	{ "uvvz", "application/vnd.dece.zip" },
+	{ NULL, NULL },
+	{ "mxmf", "audio/mobile-xmf" },
+	{ "asc", "application/pgp-keys" },
+	{ "tmo", "application/vnd.tmobile-livetv" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "fcdt", "application/vnd.adobe.formscentral.fcdt" },
+	{ "ppam", "application/vnd.ms-powerpoint.addin.macroEnabled.12" },
+	{ "qca", "application/vnd.ericsson.quickcall" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "cdmiq", "application/cdmi-queue" },
+	{ "smp3", "audio/vnd.sealedmedia.softseal.mpeg" },
+	{ "i2g", "application/vnd.intergeo" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "senmlx", "application/senml+xml" },
+	{ NULL, NULL },
+	{ "book", "application/x-maker" },
+	{ "dxf", "image/vnd.dxf" },
+	{ "es3", "application/vnd.eszigno3+xml" },
+	{ "uvvt", "application/vnd.dece.ttml+xml" },
+	{ NULL, NULL },
+	{ "azw3", "application/vnd.amazon.mobi8-ebook" },
+	{ NULL, NULL },
+	{ "geojson", "application/geo+json" },
+	{ "box", "application/vnd.previewsystems.box" },
+	{ NULL, NULL },
+	{ "1km", "application/vnd.1000minds.decision-model+xml" },
+	{ "xlt", "application/vnd.ms-excel" },
+	{ "axa", "audio/annodex" },
+	{ "sdw", "application/vnd.stardivision.writer" },
+	{ "jp2", "image/jp2" },
+	{ "xsl", "application/xslt+xml" },
+	{ "mpeg", "video/mpeg" },
+	{ "nns", "application/vnd.noblenet-sealer" },
+	{ "semf", "application/vnd.semf" },
+	{ NULL, NULL },
+	{ "c4p", "application/vnd.clonk.c4group" },
+	{ "pm", "text/x-perl" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "nim", "video/vnd.nokia.interleaved-multimedia" },
+	{ "jpm", "image/jpm" },
+	{ "wk4", "application/vnd.lotus-1-2-3" },
+	{ "apexlang", "application/vnd.apexlang" },
+	{ "uvvx", "application/vnd.dece.unspecified" },
+	{ "bmml", "application/vnd.balsamiq.bmml+xml" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "psfs", "application/vnd.psfs" },
+	{ NULL, NULL },
+	{ "scr", "application/x-silverlight" },
+	{ "uvh", "video/vnd.dece.hd" },
+	{ NULL, NULL },
+	{ "mpy", "application/vnd.ibm.MiniPay" },
+	{ "apr", "application/vnd.lotus-approach" },
+	{ "atfx", "application/ATFX" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ddeb", "application/vnd.debian.binary-package" },
+	{ "gsm", "audio/x-gsm" },
+	{ "emf", "image/emf" },
+	{ NULL, NULL },
+	{ "jxl", "image/jxl" },
+	{ "mft", "application/rpki-manifest" },
+	{ "mcif", "chemical/x-mmcif" },
+	{ "nq", "application/n-quads" },
+	{ "gnumeric", "application/x-gnumeric" },
+	{ "yt", "video/vnd.youtube.yt" },
+	{ "xcos", "application/x-scilab-xcos" },
+	{ "sw", "chemical/x-swissprot" },
+	{ "jam", "application/vnd.jam" },
+	{ "ly", "text/x-lilypond" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "pgp", "application/pgp-encrypted" },
+	{ "mpd", "application/dash+xml" },
+	{ NULL, NULL },
+	{ "manifest", "text/cache-manifest" },
+	{ "xlm", "application/vnd.ms-excel" },
+	{ NULL, NULL },
+	{ "prc", "model/prc" },
+	{ "rst", "text/prs.fallenstein.rst" },
+	{ NULL, NULL },
+	{ "arrows", "application/vnd.apache.arrow.stream" },
+	{ "es", "text/javascript" },
+	{ "ccmp", "application/ccmp+xml" },
+	{ "tree", "application/vnd.rainstor.data" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "mpg", "video/mpeg" },
+	{ "ghf", "application/vnd.groove-help" },
+	{ "xlc", "application/vnd.ms-excel" },
+	{ "fdt", "application/fdt+xml" },
+	{ "c3d", "chemical/x-chem3d" },
+	{ "jisp", "application/vnd.jisp" },
+	{ NULL, NULL },
+	{ "wcm", "application/vnd.ms-works" },
+	{ "sic", "application/vnd.wap.sic" },
+	{ "wmc", "application/vnd.wmc" },
+	{ "clkw", "application/vnd.crick.clicker.wordbank" },
+	{ "srx", "application/sparql-results+xml" },
+	{ "alc", "chemical/x-alchemy" },
+	{ "eps", "application/postscript" },
+	{ "efi", "application/efi" },
+	{ "wrl", "model/vrml" },
+	{ "gqs", "application/vnd.grafeq" },
+	{ "sh", "application/x-sh" },
+	{ NULL, NULL },
+	{ "uvvi", "image/vnd.dece.graphic" },
+	{ "cuc", "application/tamp-community-update-confirm" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "u8msg", "message/global" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "xdd", "application/bacnet-xdd+zip" },
+	{ "hwp", "application/x-hwp" },
+	{ "cpl", "application/cpl+xml" },
+	{ "one", "application/onenote" },
+	{ "xpak", "application/vnd.gentoo.xpak" },
+	{ "nebul", "application/vnd.nebumind.line" },
+	{ "jls", "image/jls" },
+	{ NULL, NULL },
+	{ "gph", "application/vnd.FloGraphIt" },
+	{ NULL, NULL },
+	{ "pdf", "application/pdf" },
+	{ "mov", "video/quicktime" },
+	{ "entity", "application/vnd.nervana" },
+	{ "cgm", "image/cgm" },
+	{ NULL, NULL },
+	{ "cwl.json", "application/cwl+json" },
+	{ NULL, NULL },
+	{ "cmsc", "application/cms" },
+	{ NULL, NULL },
+	{ "oth", "application/vnd.oasis.opendocument.text-web" },
+	{ "emotionml", "application/emotionml+xml" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "jxr", "image/jxr" },
+	{ "xfdf", "application/xfdf" },
+	{ NULL, NULL },
+	{ "xhtml", "application/xhtml+xml" },
+	{ "gf", "application/x-tex-gf" },
+	{ NULL, NULL },
+	{ "mfm", "application/vnd.mfmp" },
+	{ "amr", "audio/AMR" },
+	{ "qwd", "application/vnd.Quark.QuarkXPress" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "cpt", "application/mac-compactpro" },
+	{ NULL, NULL },
+	{ "pyox", "model/vnd.pytha.pyox" },
+	{ NULL, NULL },
+	{ "ttl", "text/turtle" },
+	{ NULL, NULL },
+	{ "jng", "image/x-jng" },
+	{ "gcf", "application/x-graphing-calculator" },
+	{ "epub", "application/epub+zip" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "dll", "application/x-msdos-program" },
+	{ NULL, NULL },
+	{ "mpw", "application/vnd.exstream-empower+zip" },
+	{ NULL, NULL },
+	{ "jphc", "image/jphc" },
+	{ "c4g", "application/vnd.clonk.c4group" },
+	{ "crt", "application/x-x509-ca-cert" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "hqx", "application/mac-binhex40" },
+	{ "odf", "application/vnd.oasis.opendocument.formula" },
+	{ "ecelp4800", "audio/vnd.nuera.ecelp4800" },
+	{ "ipk", "application/vnd.shana.informed.package" },
+	{ "koz", "audio/vnd.audiokoz" },
+	{ "cbin", "chemical/x-cactvs-binary" },
+	{ NULL, NULL },
+	{ "ssf", "application/vnd.epson.ssf" },
+	{ "a", "text/vnd.a" },
+	{ "dotm", "application/vnd.ms-word.template.macroEnabled.12" },
+	{ "senml", "application/senml+json" },
+	{ "mbox", "application/mbox" },
+	{ "rfcxml", "application/rfc+xml" },
+	{ NULL, NULL },
+	{ "nef", "image/x-nikon-nef" },
+	{ "jxrs", "image/jxrS" },
+	{ "xcf", "image/x-xcf" },
+	{ "mng", "video/x-mng" },
+	{ "ink", "application/inkml+xml" },
+	{ "igl", "application/vnd.igloader" },
+	{ "dcd", "application/DCD" },
+	{ NULL, NULL },
+	{ "m4s", "video/iso.segment" },
+	{ "upa", "application/vnd.hbci" },
+	{ "ksp", "application/vnd.kde.kspread" },
+	{ "tk", "text/x-tcl" },
+	{ "tgz", "application/x-gtar-compressed" },
+	{ "nsg", "application/vnd.lotus-notes" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ufdl", "application/vnd.ufdl" },
+	{ "movie", "video/x-sgi-movie" },
+	{ "csh", "application/x-csh" },
+	{ "uri", "text/uri-list" },
+	{ "xel", "application/xcap-el+xml" },
+	{ "cod", "application/vnd.rim.cod" },
+	{ "sid", "audio/prs.sid" },
+	{ "trig", "application/trig" },
+	{ NULL, NULL },
+	{ "dataless", "application/vnd.fdsn.seed" },
+	{ NULL, NULL },
+	{ "msd", "application/vnd.fdsn.mseed" },
+	{ "csl", "application/vnd.citationstyles.style+xml" },
+	{ "sqlite3", "application/vnd.sqlite3" },
+	{ "igs", "model/iges" },
+	{ "m3u8", "application/vnd.apple.mpegurl" },
+	{ NULL, NULL },
+	{ "sieve", "application/sieve" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "sci", "application/x-scilab" },
+	{ "smp", "audio/vnd.sealedmedia.softseal.mpeg" },
+	{ "sru", "application/sru+xml" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "auc", "application/tamp-apex-update-confirm" },
+	{ "key", "application/pgp-keys" },
+	{ "wdb", "application/vnd.ms-works" },
+	{ NULL, NULL },
+	{ "qxd", "application/vnd.Quark.QuarkXPress" },
+	{ "dls", "audio/dls" },
+	{ "swi", "application/vnd.aristanetworks.swi" },
+	{ "vrm", "model/vrml" },
+	{ "ic8", "application/vnd.commerce-battelle" },
+	{ NULL, NULL },
+	{ "win", "model/vnd.gdl" },
+	{ "dbf", "application/vnd.dbf" },
+	{ "notebook", "application/vnd.smart.notebook" },
+	{ NULL, NULL },
+	{ "java", "text/x-java" },
+	{ "provn", "text/provenance-notation" },
+	{ "org", "application/vnd.lotus-organizer" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "m4v", "video/mp4" },
+	{ NULL, NULL },
+	{ "eol", "audio/vnd.digital-winds" },
+	{ NULL, NULL },
+	{ "diff", "text/x-diff" },
+	{ "xpi", "application/x-xpinstall" },
+	{ "paw", "application/vnd.pawaafile" },
+	{ "dtshd", "audio/vnd.dts.hd" },
+	{ "p10", "application/pkcs10" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "xla", "application/vnd.ms-excel" },
+	{ "tsr", "application/timestamp-reply" },
+	{ "sd2", "audio/x-sd2" },
+	{ "ccc", "text/vnd.net2phone.commcenter.command" },
+	{ "fvt", "video/vnd.fvt" },
+	{ "rms", "application/vnd.jcp.javame.midlet-rms" },
+	{ "json", "application/json" },
+	{ "ttf", "font/ttf" },
+	{ "igm", "application/vnd.insors.igm" },
+	{ NULL, NULL },
+	{ "pt", "application/vnd.snesdev-page-table" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "mpv", "video/x-matroska" },
+	{ "u8dsn", "message/global-delivery-status" },
+	{ "stp", "model/step" },
+	{ "c4f", "application/vnd.clonk.c4group" },
+	{ "xltx", "application/vnd.openxmlformats-officedocument.spreadsheetml.template" },
+	{ "skp", "application/vnd.koan" },
+	{ "lsx", "video/x-la-asf" },
+	{ NULL, NULL },
+	{ "pyv", "video/vnd.ms-playready.media.pyv" },
+	{ "hbc", "application/vnd.hbci" },
+	{ NULL, NULL },
+	{ "kpt", "application/vnd.kde.kpresenter" },
+	{ "soa", "text/dns" },
+	{ "uvt", "application/vnd.dece.ttml+xml" },
+	{ "1905.1", "application/vnd.ieee.1905" },
+	{ NULL, NULL },
+	{ "xbm", "image/x-xbitmap" },
+	{ "ic2", "application/vnd.commerce-battelle" },
+	{ "vfr", "application/vnd.tml" },
+	{ "vcs", "text/x-vcalendar" },
+	{ "orq", "application/ocsp-request" },
+	{ NULL, NULL },
+	{ "hpgl", "application/vnd.hp-HPGL" },
+	{ "ign", "application/vnd.coreos.ignition+json" },
+	{ "woff2", "font/woff2" },
+	{ "frame", "application/x-maker" },
+	{ "eps2", "application/postscript" },
+	{ "cdf", "application/x-cdf" },
+	{ NULL, NULL },
+	{ "gcg", "chemical/x-gcg8-sequence" },
+	{ NULL, NULL },
+	{ "mgz", "application/vnd.proteus.magazine" },
+	{ NULL, NULL },
+	{ "nwc", "application/x-nwc" },
+	{ "loom", "application/vnd.loom" },
+	{ "mmd", "application/vnd.chipnuts.karaoke-mmd" },
+	{ NULL, NULL },
+	{ "mxi", "application/vnd.vd-study" },
+	{ "odd", "application/tei+xml" },
+	{ "zone", "text/dns" },
+	{ "gjc", "chemical/x-gaussian-input" },
+	{ "ns4", "application/vnd.lotus-notes" },
+	{ "sldx", "application/vnd.openxmlformats-officedocument.presentationml.slide" },
+	{ NULL, NULL },
+	{ "dfac", "application/vnd.dreamfactory" },
+	{ "maei", "application/mmt-aei+xml" },
+	{ "reload", "application/vnd.resilient.logic" },
+	{ NULL, NULL },
+	{ "rsm", "model/vnd.gdl" },
+	{ "xlw", "application/vnd.ms-excel" },
+	{ "quox", "application/vnd.quobject-quoxdocument" },
+	{ "mpdd", "application/dashdelta" },
+	{ "sjpg", "image/vnd.sealedmedia.softseal.jpg" },
+	{ "pcx", "image/vnd.zbrush.pcx" },
+	{ NULL, NULL },
+	{ "istr", "chemical/x-isostar" },
+	{ NULL, NULL },
+	{ "rpst", "application/vnd.nokia.radio-preset" },
+	{ "bmpr", "application/vnd.balsamiq.bmpr" },
+	{ "umj", "application/vnd.umajin" },
+	{ "pyc", "application/x-python-code" },
+	{ "cryptonote", "application/vnd.rig.cryptonote" },
+	{ "lhs", "text/x-literate-haskell" },
+	{ "daf", "application/vnd.Mobius.DAF" },
+	{ "deploy", "application/octet-stream" },
+	{ "sppt", "application/vnd.sealed.ppt" },
+	{ "odt", "application/vnd.oasis.opendocument.text" },
+	{ "xct", "application/vnd.fujixerox.docuworks.container" },
+	{ NULL, NULL },
+	{ "oza", "application/x-oz-application" },
+	{ NULL, NULL },
+	{ "jpg2", "image/jp2" },
+	{ "sls", "application/route-s-tsid+xml" },
+	{ NULL, NULL },
+	{ "azv", "image/vnd.airzip.accelerator.azv" },
+	{ "osf", "application/vnd.yamaha.openscoreformat" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "zfo", "application/vnd.software602.filler.form-xml-zip" },
+	{ "jxsc", "image/jxsc" },
+	{ "atc", "application/vnd.acucorp" },
+	{ "sus", "application/vnd.sus-calendar" },
+	{ "ptrom", "application/vnd.snesdev-page-table" },
+	{ "u8mdn", "message/global-disposition-notification" },
+	{ "uvm", "video/vnd.dece.mobile" },
+	{ "m4a", "audio/mp4" },
+	{ "docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document" },
+	{ NULL, NULL },
+	{ "lcs", "application/vnd.logipipe.circuit+zip" },
+	{ "ggt", "application/vnd.geogebra.tool" },
+	{ "avi", "video/x-msvideo" },
+	{ "sldm", "application/vnd.ms-powerpoint.slide.macroEnabled.12" },
+	{ "icd", "application/vnd.commerce-battelle" },
+	{ NULL, NULL },
+	{ "sgml", "text/SGML" },
+	{ NULL, NULL },
+	{ "mp2", "audio/mpeg" },
+	{ "davmount", "application/davmount+xml" },
+	{ "senmle", "application/senml-exi" },
+	{ "ass", "audio/aac" },
+	{ "cdx", "chemical/x-cdx" },
+	{ "msh", "model/mesh" },
+	{ "avci", "image/avci" },
+	{ NULL, NULL },
+	{ "scl", "application/vnd.sycle+xml" },
+	{ "ra", "audio/x-pn-realaudio" },
+	{ "swidtag", "application/swid+xml" },
+	{ NULL, NULL },
+	{ "sgi", "image/vnd.sealedmedia.softseal.gif" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "kml", "application/vnd.google-earth.kml+xml" },
+	{ "xps", "application/vnd.ms-xpsdocument" },
+	{ NULL, NULL },
+	{ "itp", "application/vnd.shana.informed.formtemplate" },
+	{ NULL, NULL },
+	{ "mets", "application/mets+xml" },
+	{ "spx", "audio/ogg" },
+	{ "xodt", "application/vnd.collabio.xodocuments.document" },
+	{ "bat", "application/x-msdos-program" },
+	{ "etx", "text/x-setext" },
+	{ "dl", "application/vnd.datalog" },
+	{ NULL, NULL },
+	{ "xods", "application/vnd.collabio.xodocuments.spreadsheet" },
+	{ "clkx", "application/vnd.crick.clicker" },
+	{ "study-inter", "application/vnd.vd-study" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "xo", "application/vnd.olpc-sugar" },
+	{ "gv", "text/vnd.graphviz" },
+	{ NULL, NULL },
+	{ "mpf", "text/vnd.ms-mediapackage" },
+	{ "at3", "audio/ATRAC3" },
+	{ NULL, NULL },
+	{ "xotp", "application/vnd.collabio.xodocuments.presentation-template" },
+	{ "sitx", "application/x-stuffit" },
+	{ "wmx", "video/x-ms-wmx" },
+	{ "tcu", "application/tamp-community-update" },
+	{ "yang", "application/yang" },
+	{ NULL, NULL },
+	{ "ic7", "application/vnd.commerce-battelle" },
+	{ "atf", "application/ATF" },
+	{ "cld", "model/vnd.cld" },
+	{ "smov", "video/vnd.sealedmedia.softseal.mov" },
+	{ "tm.json", "application/tm+json" },
+	{ NULL, NULL },
+	{ "pgn", "application/vnd.chess-pgn" },
+	{ "fch", "chemical/x-gaussian-checkpoint" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "c++", "text/x-c++src" },
+	{ "ufd", "application/vnd.ufdl" },
+	{ "cdmia", "application/cdmi-capability" },
+	{ "cmdf", "chemical/x-cmdf" },
+	{ "evw", "audio/EVRCWB" },
+	{ NULL, NULL },
+	{ "ras", "image/x-cmu-raster" },
+	{ "lxf", "application/LXF" },
+	{ "stw", "application/vnd.sun.xml.writer.template" },
+	{ "xls", "application/vnd.ms-excel" },
+	{ "ez3", "application/vnd.ezpix-package" },
+	{ NULL, NULL },
+	{ "sxd", "application/vnd.sun.xml.draw" },
+	{ "js", "text/javascript" },
+	{ NULL, NULL },
+	{ "c3ex", "application/cccex" },
+	{ "doc", "application/msword" },
+	{ "fo", "application/vnd.software602.filler.form+xml" },
+	{ "hps", "application/vnd.hp-hps" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "prf", "application/pics-rules" },
+	{ "~", "application/x-trash" },
+	{ "plb", "application/vnd.3gpp.pic-bw-large" },
+	{ NULL, NULL },
+	{ "ext", "application/vnd.novadigm.EXT" },
+	{ "ivp", "application/vnd.immervision-ivp" },
+	{ "xfdl", "application/vnd.xfdl" },
+	{ "lca", "application/vnd.logipipe.circuit+zip" },
+	{ NULL, NULL },
+	{ "spdf", "application/vnd.sealedmedia.softseal.pdf" },
+	{ "pdx", "application/PDX" },
+	{ "ac3", "audio/ac3" },
+	{ "zfc", "application/vnd.filmit.zfc" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "crw", "image/x-canon-crw" },
+	{ "gram", "application/srgs" },
+	{ NULL, NULL },
+	{ "wk", "application/x-123" },
+	{ NULL, NULL },
+	{ "inkml", "application/inkml+xml" },
+	{ NULL, NULL },
+	{ "efif", "application/vnd.picsel" },
+	{ "odb", "application/vnd.oasis.opendocument.base" },
+	{ "csml", "chemical/x-csml" },
+	{ "uvx", "application/vnd.dece.unspecified" },
+	{ "smil", "application/smil+xml" },
+	{ "smo", "video/vnd.sealedmedia.softseal.mov" },
+	{ "xwd", "image/x-xwindowdump" },
+	{ NULL, NULL },
+	{ "xvm", "application/xv+xml" },
+	{ "rp9", "application/vnd.cloanto.rp9" },
+	{ "pkg", "application/vnd.apple.installer+xml" },
+	{ "nds", "application/vnd.nintendo.nitro.rom" },
+	{ NULL, NULL },
+	{ "mmod", "chemical/x-macromodel-input" },
+	{ "dd2", "application/vnd.oma.dd2+xml" },
+	{ "s1q", "video/vnd.sealedmedia.softseal.mov" },
+	{ "ist", "chemical/x-isostar" },
+	{ "xhtm", "application/xhtml+xml" },
+	{ "oas", "application/vnd.fujitsu.oasys" },
+	{ "avif", "image/avif" },
+	{ "oa3", "application/vnd.fujitsu.oasys3" },
+	{ NULL, NULL },
+	{ "cap", "application/vnd.tcpdump.pcap" },
+	{ "sdc", "application/vnd.stardivision.calc" },
+	{ NULL, NULL },
+	{ "sse", "application/vnd.kodak-descriptor" },
+	{ "webp", "image/webp" },
+	{ "sfd-hdstx", "application/vnd.hydrostatix.sof-data" },
+	{ "vsd", "application/vnd.visio" },
+	{ NULL, NULL },
+	{ "flt", "text/vnd.ficlab.flt" },
+	{ "tsa", "application/tamp-sequence-adjust" },
+	{ "ssvc", "application/vnd.crypto-shade-file" },
+	{ NULL, NULL },
+	{ "s1a", "application/vnd.sealedmedia.softseal.pdf" },
+	{ NULL, NULL },
+	{ "taglet", "application/vnd.mynfc" },
+	{ "svc", "application/vnd.dvb.service" },
+	{ NULL, NULL },
+	{ "oti", "application/vnd.oasis.opendocument.image-template" },
+	{ "jph", "image/jph" },
+	{ "pfr", "application/font-tdpfr" },
+	{ "hin", "chemical/x-hin" },
+	{ "vew", "application/vnd.lotus-approach" },
+	{ "zmm", "application/vnd.HandHeld-Entertainment+xml" },
+	{ "msu", "application/octet-stream" },
+	{ "s1j", "image/vnd.sealedmedia.softseal.jpg" },
+	{ "psd", "image/vnd.adobe.photoshop" },
+	{ NULL, NULL },
+	{ "mpn", "application/vnd.mophun.application" },
+	{ "uvu", "video/vnd.dece.mp4" },
+	{ "maker", "application/x-maker" },
+	{ "sarif", "application/sarif+json" },
+	{ "ptid", "application/vnd.pvi.ptid1" },
+	{ "wk1", "application/vnd.lotus-1-2-3" },
+	{ "txd", "application/vnd.genomatix.tuxedo" },
+	{ NULL, NULL },
+	{ "mrc", "application/marc" },
+	{ NULL, NULL },
+	{ "pls", "audio/x-scpls" },
+	{ NULL, NULL },
+	{ "plf", "application/vnd.pocketlearn" },
+	{ "cnd", "text/jcr-cnd" },
+	{ "lostxml", "application/lost+xml" },
+	{ NULL, NULL },
+	{ "model-inter", "application/vnd.vd-study" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "dor", "model/vnd.gdl" },
+	{ "cql", "text/cql" },
+	{ "viv", "video/vnd.vivo" },
+	{ "jnlp", "application/x-java-jnlp-file" },
+	{ "dsc", "text/prs.lines.tag" },
+	{ "mjp2", "video/mj2" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ppsm", "application/vnd.ms-powerpoint.slideshow.macroEnabled.12" },
+	{ "ovl", "application/vnd.afpc.modca-overlay" },
+	{ "cache", "chemical/x-cache" },
+	{ "distz", "application/vnd.apple.installer+xml" },
+	{ "tif", "image/tiff" },
+	{ NULL, NULL },
+	{ "gtw", "model/vnd.gtw" },
+	{ "spng", "image/vnd.sealed.png" },
+	{ "cw", "application/prs.cww" },
+	{ "mbk", "application/vnd.Mobius.MBK" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "glbin", "application/gltf-buffer" },
+	{ "ipfix", "application/ipfix" },
+	{ "ns3", "application/vnd.lotus-notes" },
+	{ "tra", "application/vnd.trueapp" },
+	{ "pil", "application/vnd.piaccess.application-licence" },
+	{ "kil", "application/x-killustrator" },
+	{ "evc", "audio/EVRC" },
+	{ "isp", "application/x-internet-signup" },
+	{ "jxsi", "image/jxsi" },
+	{ NULL, NULL },
+	{ "nc", "application/x-netcdf" },
+	{ "gac", "application/vnd.groove-account" },
+	{ "le", "application/vnd.bluetooth.le.oob" },
+	{ "sty", "text/x-tex" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "jrd", "application/jrd+json" },
+	{ "jlt", "application/vnd.hp-jlyt" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "snd", "audio/basic" },
+	{ NULL, NULL },
+	{ "stl", "model/stl" },
+	{ "au", "audio/basic" },
+	{ "see", "application/vnd.seemail" },
+	{ "s3df", "application/vnd.sealed.3df" },
+	{ "avcs", "image/avcs" },
+	{ NULL, NULL },
+	{ "lwp", "application/vnd.lotus-wordpro" },
+	{ "ez", "application/andrew-inset" },
+	{ "json-patch", "application/json-patch+json" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "d", "text/x-dsrc" },
+	{ "clue", "application/clue_info+xml" },
+	{ "ott", "application/vnd.oasis.opendocument.text-template" },
+	{ "glbuf", "application/gltf-buffer" },
+	{ "pfx", "application/pkcs12" },
+	{ "scs", "application/scvp-cv-response" },
+	{ "srt", "text/plain" },
+	{ NULL, NULL },
+	{ "csrattrs", "application/csrattrs" },
+	{ "class", "application/java-vm" },
+	{ NULL, NULL },
+	{ "mxl", "application/vnd.recordare.musicxml" },
+	{ "vss", "application/vnd.visio" },
+	{ "eps3", "application/postscript" },
+	{ NULL, NULL },
+	{ "smc", "application/vnd.nintendo.snes.rom" },
+	{ NULL, NULL },
+	{ "scala", "text/x-scala" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "rar", "application/vnd.rar" },
+	{ "ktx", "image/ktx" },
+	{ "cdkey", "application/vnd.mediastation.cdkey" },
+	{ "asf", "application/vnd.ms-asf" },
+	{ "texinfo", "application/x-texinfo" },
+	{ "vst", "application/vnd.visio" },
+	{ "rxt", "application/vnd.medicalholodeck.recordxr" },
+	{ "edm", "application/vnd.novadigm.EDM" },
+	{ "otf", "font/otf" },
+	{ "dot", "text/vnd.graphviz" },
+	{ "gex", "application/vnd.geometry-explorer" },
+	{ "spo", "text/vnd.in3d.spot" },
+	{ "s1w", "application/vnd.sealed.doc" },
+	{ NULL, NULL },
+	{ "xmt_bin", "model/vnd.parasolid.transmit.binary" },
+	{ "lin", "application/bbolin" },
+	{ "wbxml", "application/vnd.wap.wbxml" },
+	{ "tpl", "application/vnd.groove-tool-template" },
+	{ "sgm", "text/SGML" },
+	{ "roff", "text/troff" },
+	{ "tao", "application/vnd.tao.intent-module-archive" },
+	{ NULL, NULL },
+	{ "ps", "application/postscript" },
+	{ "dzr", "application/vnd.dzr" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "csm", "chemical/x-csml" },
+	{ "docjson", "application/vnd.document+json" },
+	{ "slt", "application/vnd.epson.salt" },
+	{ "odc", "application/vnd.oasis.opendocument.chart" },
+	{ "png", "image/png" },
+	{ "ignition", "application/vnd.coreos.ignition+json" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "p7r", "application/x-pkcs7-certreqresp" },
+	{ "fzs", "application/vnd.fuzzysheet" },
+	{ "xltm", "application/vnd.ms-excel.template.macroEnabled.12" },
+	{ "sqlite", "application/vnd.sqlite3" },
+	{ "igx", "application/vnd.micrografx.igx" },
+	{ "tam", "application/vnd.onepager" },
+	{ "wgt", "application/widget" },
+	{ "cil", "application/vnd.ms-artgalry" },
+	{ "rcprofile", "application/vnd.ipunplugged.rcprofile" },
+	{ "sdkd", "application/vnd.solent.sdkm+xml" },
+	{ NULL, NULL },
+	{ "otp", "application/vnd.oasis.opendocument.presentation-template" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "a2l", "application/A2L" },
+	{ NULL, NULL },
+	{ "otg", "application/vnd.oasis.opendocument.graphics-template" },
+	{ NULL, NULL },
+	{ "mcm", "chemical/x-macmolecule" },
+	{ "bk2", "video/vnd.radgamettools.bink" },
+	{ "tm.jsonld", "application/tm+json" },
+	{ "dive", "application/vnd.patentdive" },
+	{ "smk", "video/vnd.radgamettools.smacker" },
+	{ "smpg", "video/vnd.sealed.mpeg1" },
+	{ "wml", "text/vnd.wap.wml" },
+	{ NULL, NULL },
+	{ "kon", "application/vnd.kde.kontour" },
+	{ "aml", "application/AML" },
+	{ "ser", "application/java-serialized-object" },
+	{ "ppt", "application/vnd.ms-powerpoint" },
+	{ "htke", "application/vnd.kenameaapp" },
+	{ NULL, NULL },
+	{ "spp", "application/scvp-vp-response" },
+	{ "tm", "text/texmacs" },
+	{ "xmls", "application/dskpp+xml" },
+	{ "vwx", "application/vnd.vectorworks" },
+	{ NULL, NULL },
+	{ "ns2", "application/vnd.lotus-notes" },
+	{ "uvf", "application/vnd.dece.data" },
+	{ NULL, NULL },
+	{ "icc", "application/vnd.iccprofile" },
+	{ "qxb", "application/vnd.Quark.QuarkXPress" },
+	{ "jfif", "image/jpeg" },
+	{ "mmf", "application/vnd.smaf" },
+	{ "ddf", "application/vnd.syncml.dmddf+xml" },
+	{ "stf", "application/vnd.wt.stf" },
+	{ NULL, NULL },
+	{ "cdfx", "application/CDFX+XML" },
+	{ "pgb", "image/vnd.globalgraphics.pgb" },
+	{ "cu", "application/cu-seeme" },
+	{ "onetmp", "application/onenote" },
+	{ "sarif-external-properties", "application/sarif-external-properties+json" },
+	{ "cub", "chemical/x-gaussian-cube" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "hdr", "image/vnd.radiance" },
+	{ "sql", "application/sql" },
+	{ "urimap", "application/vnd.uri-map" },
+	{ "mqy", "application/vnd.Mobius.MQY" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "nnw", "application/vnd.noblenet-web" },
+	{ "sgl", "application/vnd.stardivision.writer-global" },
+	{ "pdb", "application/vnd.palm" },
+	{ "jpe", "image/jpeg" },
+	{ NULL, NULL },
+	{ "msty", "application/vnd.muvee.style" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "b16", "image/vnd.pco.b16" },
+	{ "ter", "application/tamp-error" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "mkv", "video/x-matroska" },
+	{ "teacher", "application/vnd.smart.teacher" },
+	{ "ecelp7470", "audio/vnd.nuera.ecelp7470" },
+	{ "ged", "text/vnd.familysearch.gedcom" },
+	{ "clkk", "application/vnd.crick.clicker.keyboard" },
+	{ "pqa", "application/vnd.palm" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "ac2", "application/vnd.banana-accounting" },
+	{ "prz", "application/vnd.lotus-freelance" },
+	{ "stpxz", "model/step-xml+zip" },
+	{ "djvu", "image/vnd.djvu" },
+	{ "sl", "text/vnd.wap.sl" },
+	{ NULL, NULL },
+	{ "bin", "application/octet-stream" },
+	{ "car", "application/vnd.ipld.car" },
+	{ "jpg", "image/jpeg" },
+	{ NULL, NULL },
+	{ "c4u", "application/vnd.clonk.c4group" },
+	{ "ram", "audio/x-pn-realaudio" },
+	{ "aal", "audio/ATRAC-ADVANCED-LOSSLESS" },
+	{ "mmr", "image/vnd.fujixerox.edmics-mmr" },
+	{ "flx", "text/vnd.fmi.flexstor" },
+	{ "acc", "application/vnd.americandynamics.acc" },
+	{ "tsv", "text/tab-separated-values" },
+	{ "jpf", "image/jpx" },
+	{ "heic", "image/heic" },
+	{ "m2v", "video/mpeg" },
+	{ "et3", "application/vnd.eszigno3+xml" },
+	{ "iif", "application/vnd.shana.informed.interchange" },
+	{ NULL, NULL },
+	{ "musd", "application/mmt-usd+xml" },
+	{ "726", "audio/32kadpcm" },
+	{ "xht", "application/xhtml+xml" },
+	{ "wmlsc", "application/vnd.wap.wmlscriptc" },
+	{ "sgif", "image/vnd.sealedmedia.softseal.gif" },
+	{ "ait", "application/vnd.dvb.ait" },
+	{ "cdbcmsg", "application/vnd.contact.cmsg" },
+	{ "hif", "image/avif" },
+	{ NULL, NULL },
+	{ "bak", "application/x-trash" },
+	{ "onetoc2", "application/onenote" },
+	{ "md", "text/markdown" },
+	{ "mpega", "audio/mpeg" },
+	{ "numbers", "application/vnd.apple.numbers" },
+	{ "sla", "application/vnd.scribus" },
+	{ NULL, NULL },
+	{ "mol", "chemical/x-mdl-molfile" },
+	{ "cbz", "application/vnd.comicbook+zip" },
+	{ "tpt", "application/vnd.trid.tpt" },
+	{ NULL, NULL },
+	{ NULL, NULL },
+	{ "abw", "application/x-abiword" },
+	{ "dxr", "application/x-director" },
+	{ "step", "model/step" },
+	{ "rpm", "application/x-redhat-package-manager" },
+	{ "ros", "chemical/x-rosdal" },
+	{ "xns", "application/xcap-ns+xml" },
+	{ "mopcrt", "chemical/x-mopac-input" },
+	{ "seed", "application/vnd.fdsn.seed" },
+	{ NULL, NULL },
+	{ "coffee", "application/vnd.coffeescript" },
+	{ NULL, NULL },
+	{ "vcj", "application/voucher-cms+json" },
+	{ NULL, NULL },
+	{ "sit", "application/x-stuffit" },
+	{ "hxx", "text/x-c++hdr" },
+	{ "uvd", "application/vnd.dece.data" },
+	{ "p7s", "application/pkcs7-signature" },
+	{ "twd", "application/vnd.SimTech-MindMapper" },
+	{ "c9s", "application/vnd.cryptomator.encrypted" },
+	{ "tst", "application/vnd.etsi.timestamp-token" },
+	{ "ttc", "font/collection" },
+	{ "scm", "application/vnd.lotus-screencam" },
+	{ NULL, NULL },
+	{ "vcard", "text/vcard" },
+	{ NULL, NULL },
+	{ "icm", "application/vnd.iccprofile" },
+	{ "pptm", "application/vnd.ms-powerpoint.presentation.macroEnabled.12" },
+	{ "esf", "application/vnd.epson.esf" },
+	{ "mads", "application/mads+xml" },
+	{ "pk", "application/x-tex-pk" },
+	{ "sml", "application/smil+xml" },
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <ctype.h>
+
+/*
+ * Builds mime_types.h, a minimal perfect hash from file extension to media type,
+ * out of a mime.types style list:
+ *
+ *   gcc -O2 mimegen.c -o mimegen && ./mimegen mime.types > mime_types.h
+ *
+ * Hash and displace: every extension hashes with seed 0 into one of MIME_BUCKETS
+ * buckets, and each bucket gets a displacement (a second seed) chosen so that all
+ * of its extensions land in free slots of a power of two table. A lookup is two
+ * hashes, one table read and one strcmp, however many types there are.
+ */
+#define MAX_EXTENSION 32
+#define MAX_ATTEMPTS 65536
+
+//Emitted verbatim into the header. Must stay identical to mime_hash() below
+#define MIME_HASH_SOURCE \
+	"static inline uint32_t mime_hash(const char *key, uint32_t seed){\n" \
+	"\tuint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);\n" \
+	"\twhile (*key){\n" \
+	"\t\thash ^= (unsigned char)*key++;\n" \
+	"\t\thash *= 16777619u;\n" \
+	"\t}\n" \
+	"\thash ^= hash >> 16;\n" \
+	"\thash *= 0x85ebca6bu;\n" \
+	"\thash ^= hash >> 13;\n" \
+	"\thash *= 0xc2b2ae35u;\n" \
+	"\thash ^= hash >> 16;\n" \
+	"\treturn hash;\n" \
+	"}\n"
+
+static inline uint32_t mime_hash(const char *key, uint32_t seed){
+	uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+	while (*key){
+		hash ^= (unsigned char)*key++;
+		hash *= 16777619u;
+	}
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35u;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+typedef struct{
+	char extension[MAX_EXTENSION];
+	char *type;
+	int bucket;
+} Key;
+
+Key *keys;
+int key_count;
+int key_cap;
+
+//Index of extension in keys, or -1
+int find_key(const char *extension){
+	for (int i = 0; i < key_count; i++){
+		if (strcmp(keys[i].extension, extension) == 0){
+			return i;
+		}
+	}
+	return -1;
+}
+
+//Returns 0 for success, 1 for failure
+int read_types(FILE *input){
+	char line[4096];
+	int line_number = 0;
+	while (fgets(line, sizeof(line), input) != NULL){
+		line_number++;
+		char *hash = strchr(line, '#');
+		if (hash != NULL){
+			*hash = '\0';
+		}
+		char *save;
+		char *type = strtok_r(line, " \t\r\n", &save);
+		if (type == NULL){
+			continue;
+		}
+		type = strdup(type);
+		char *extension;
+		while ((extension = strtok_r(NULL, " \t\r\n", &save)) != NULL){
+			if (strlen(extension) >= MAX_EXTENSION){
+				fprintf(stderr, "line %d: extension too long: %s\n", line_number, extension);
+				return 1;
+			}
+			for (char *c = extension; *c; c++){
+				*c = tolower((unsigned char)*c);
+			}
+			//First type listed for an extension wins
+			if (find_key(extension) >= 0){
+				continue;
+			}
+			if (key_count == key_cap){
+				key_cap = key_cap ? key_cap * 2 : 256;
+				keys = realloc(keys, key_cap * sizeof(Key));
+				if (keys == NULL){
+					perror("Memory allocation failed\n");
+					return 1;
+				}
+			}
+			snprintf(keys[key_count].extension, MAX_EXTENSION, "%s", extension);
+			keys[key_count].type = type;
+			key_count++;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[]){
+	if (argc != 2){
+		fprintf(stderr, "Usage: %s mime.types > mime_types.h\n", argv[0]);
+		return 1;
+	}
+	FILE *input = fopen(argv[1], "r");
+	if (input == NULL){
+		perror("Failed to open input\n");
+		return 1;
+	}
+	if (read_types(input) != 0){
+		return 1;
+	}
+	fclose(input);
+
+	//1. Size the table: about four extensions per bucket, slots a power of two at most 80% full
+	int bucket_count = key_count / 4 + 1;
+	int slot_count = 1;
+	while (slot_count * 4 < key_count * 5){
+		slot_count *= 2;
+	}
+	int *bucket_size = calloc(bucket_count, sizeof(int));
+	int *order = malloc(bucket_count * sizeof(int));
+	uint32_t *displacements = calloc(bucket_count, sizeof(uint32_t));
+	int *slots = malloc(slot_count * sizeof(int));
+	if (bucket_size == NULL || order == NULL || displacements == NULL || slots == NULL){
+		perror("Memory allocation failed\n");
+		return 1;
+	}
+	for (int i = 0; i < slot_count; i++){
+		slots[i] = -1;
+	}
+	for (int i = 0; i < key_count; i++){
+		keys[i].bucket = mime_hash(keys[i].extension, 0) % bucket_count;
+		bucket_size[keys[i].bucket]++;
+	}
+
+	//2. Place the fullest buckets first, while the table is emptiest
+	for (int i = 0; i < bucket_count; i++){
+		order[i] = i;
+	}
+	for (int i = 1; i < bucket_count; i++){
+		int bucket = order[i];
+		int j = i;
+		while (j > 0 && bucket_size[order[j - 1]] < bucket_size[bucket]){
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = bucket;
+	}
+
+	//3. Find each bucket a displacement that puts all of its keys in distinct free slots
+	for (int i = 0; i < bucket_count && bucket_size[order[i]] > 0; i++){
+		int bucket = order[i];
+		uint32_t displacement;
+		for (displacement = 1; displacement < MAX_ATTEMPTS; displacement++){
+			int fits = 1;
+			for (int k = 0; k < key_count && fits; k++){
+				if (keys[k].bucket != bucket){
+					continue;
+				}
+				int slot = mime_hash(keys[k].extension, displacement) & (slot_count - 1);
+				if (slots[slot] != -1){
+					fits = 0;
+					break;
+				}
+				slots[slot] = k;
+			}
+			if (fits){
+				break;
+			}
+			//Undo this attempt's placements
+			for (int s = 0; s < slot_count; s++){
+				if (slots[s] >= 0 && keys[slots[s]].bucket == bucket){
+					slots[s] = -1;
+				}
+			}
+		}
+		if (displacement == MAX_ATTEMPTS){
+			fprintf(stderr, "No displacement found for bucket %d, try a larger table\n", bucket);
+			return 1;
+		}
+		displacements[bucket] = displacement;
+	}
+
+	//4. Emit the header
+	printf("//Generated by mimegen from mime.types. Do not edit, regenerate instead\n");
+	printf("#ifndef MIME_TYPES_H\n#define MIME_TYPES_H\n\n");
+	printf("#define MIME_BUCKETS %d\n", bucket_count);
+	printf("#define MIME_SLOTS %d\n", slot_count);
+	printf("#define MIME_MAX_EXTENSION %d\n\n", MAX_EXTENSION);
+	printf("typedef struct{\n\tconst char *extension; // lower case, NULL for an empty slot\n\tconst char *type;\n} MimeSlot;\n\n");
+	fputs(MIME_HASH_SOURCE, stdout);
+	printf("\nstatic const uint16_t mime_displacements[MIME_BUCKETS] = {");
+	for (int i = 0; i < bucket_count; i++){
+		printf("%s%u,", i % 16 == 0 ? "\n\t" : " ", displacements[i]);
+	}
+	printf("\n};\n\nstatic const MimeSlot mime_slots[MIME_SLOTS] = {\n");
+	for (int i = 0; i < slot_count; i++){
+		if (slots[i] < 0){
+			printf("\t{ NULL, NULL },\n");
+		}
+		else {
+			printf("\t{ \"%s\", \"%s\" },\n", keys[slots[i]].extension, keys[slots[i]].type);
+		}
+	}
+	printf("};\n\n#endif\n");
+	return 0;
+}
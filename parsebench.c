@@ -0,0 +1,224 @@
+/*
+ * Request parser microbenchmark. Parses a corpus of captured request heads over and
+ * over with server.c's own parser, once per line scanning kernel the CPU supports,
+ * and reports the throughput in GB/s of request bytes:
+ *
+ *   gcc -O2 -pthread parsebench.c -o parsebench && ./parsebench parse_corpus.txt [seconds]
+ *
+ * The corpus is a text file of request heads separated by blank lines, sent with
+ * CRLF line ends; lines starting with # are skipped. server.c is compiled in with
+ * its main() renamed, so the benchmark always measures the parser as it is built.
+ */
+#define main server_main
+#include "server.c"
+#undef main
+
+#define BENCH_ROUND_BYTES (1024 * 1024) //The corpus is repeated up to this size so each timed round is long enough to measure
+
+typedef struct{
+	size_t offset; // into the round buffer
+	size_t len;
+} BenchRequest;
+
+char *round_data; // the corpus repeated, with CRLF line ends
+size_t round_len;
+BenchRequest *requests;
+int request_count;
+int request_cap;
+
+//Append a byte to the round buffer. Returns 0 for success, 1 for failure
+int round_append(char c, size_t *cap){
+	if (round_len == *cap){
+		*cap = *cap ? *cap * 2 : 65536;
+		round_data = realloc(round_data, *cap);
+		if (round_data == NULL){
+			perror("Memory allocation failed\n");
+			return 1;
+		}
+	}
+	round_data[round_len++] = c;
+	return 0;
+}
+
+//Record round_data[start, round_len) as one request. Returns 0 for success, 1 for failure
+int add_request(size_t start){
+	if (request_count == request_cap){
+		request_cap = request_cap ? request_cap * 2 : 64;
+		requests = realloc(requests, request_cap * sizeof(BenchRequest));
+		if (requests == NULL){
+			perror("Memory allocation failed\n");
+			return 1;
+		}
+	}
+	requests[request_count].offset = start;
+	requests[request_count].len = round_len - start;
+	request_count++;
+	return 0;
+}
+
+//Read the corpus into round_data, one CRLF terminated head per block. Returns the number of heads, -1 on failure
+int read_corpus(FILE *input, size_t *cap){
+	char line[65536];
+	int heads = 0;
+	int in_head = 0;
+	size_t start = round_len;
+	while (fgets(line, sizeof(line), input) != NULL){
+		line[strcspn(line, "\r\n")] = '\0';
+		if (line[0] == '#'){
+			continue;
+		}
+		if (line[0] == '\0'){
+			if (in_head){
+				if (round_append('\r', cap) != 0 || round_append('\n', cap) != 0 || add_request(start) != 0){
+					return -1;
+				}
+				heads++;
+				in_head = 0;
+			}
+			start = round_len;
+			continue;
+		}
+		for (char *c = line; *c; c++){
+			if (round_append(*c, cap) != 0){
+				return -1;
+			}
+		}
+		if (round_append('\r', cap) != 0 || round_append('\n', cap) != 0){
+			return -1;
+		}
+		in_head = 1;
+	}
+	if (in_head){
+		if (round_append('\r', cap) != 0 || round_append('\n', cap) != 0 || add_request(start) != 0){
+			return -1;
+		}
+		heads++;
+	}
+	return heads;
+}
+
+//Fold what the parser found into a hash, so every kernel can be checked against the first
+uint64_t fingerprint(uint64_t hash, HttpRequest *request){
+	uint64_t fields[] = {
+		request->method_id, request->path_slice.offset, request->path_slice.len,
+		request->query_slice.offset, request->query_slice.len, request->head_len,
+		request->content_length, request->connection, request->chunked, request->header_count,
+	};
+	for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++){
+		hash = (hash ^ fields[i]) * 1099511628211u;
+	}
+	for (int i = 0; i < HEADER_COUNT; i++){
+		hash = (hash ^ request->known_headers[i].offset ^ (request->known_headers[i].len << 32)) * 1099511628211u;
+	}
+	for (int i = 0; i < request->header_count; i++){
+		hash = (hash ^ request->headers[i].key.len ^ (request->headers[i].value.len << 32)) * 1099511628211u;
+	}
+	return hash;
+}
+
+/*
+ * Parse every request of one round in work, which must hold a fresh copy of round_data
+ * (the parser terminates tokens in place). Returns the time taken, or 0 if a request
+ * did not parse
+ */
+uint64_t parse_round(char *work, HttpRequest *request, Arena *arena, uint64_t *hash){
+	uint64_t start = monotonic_ns();
+	for (int i = 0; i < request_count; i++){
+		request_reset(request);
+		if (parse_client_request(request, work + requests[i].offset, requests[i].len) != PARSE_COMPLETE){
+			fprintf(stderr, "Request %d of the round did not parse\n", i);
+			return 0;
+		}
+		if (hash != NULL){
+			*hash = fingerprint(*hash, request);
+		}
+		arena_reset(arena);
+	}
+	return monotonic_ns() - start;
+}
+
+int main(int argc, char *argv[]){
+	if (argc < 2 || argc > 3){
+		fprintf(stderr, "Usage: %s corpus [seconds per kernel]\n", argv[0]);
+		return 1;
+	}
+	double seconds = argc == 3 ? atof(argv[2]) : 1.0;
+	FILE *input = fopen(argv[1], "r");
+	if (input == NULL){
+		perror("Failed to open corpus\n");
+		return 1;
+	}
+
+	//1. Load the corpus and repeat it until a round is BENCH_ROUND_BYTES
+	size_t cap = 0;
+	int heads = read_corpus(input, &cap);
+	fclose(input);
+	if (heads <= 0){
+		fprintf(stderr, "No request heads in %s\n", argv[1]);
+		return 1;
+	}
+	size_t corpus_len = round_len;
+	while (round_len < BENCH_ROUND_BYTES){
+		for (int i = 0; i < heads; i++){
+			size_t start = round_len;
+			for (size_t j = 0; j < requests[i].len; j++){
+				if (round_append(round_data[requests[i].offset + j], &cap) != 0){
+					return 1;
+				}
+			}
+			if (add_request(start) != 0){
+				return 1;
+			}
+		}
+	}
+	char *work = malloc(round_len);
+	if (work == NULL){
+		perror("Memory allocation failed\n");
+		return 1;
+	}
+	printf("%d request heads, %zu bytes, average %zu bytes; %d requests per round\n",
+		heads, corpus_len, corpus_len / heads, request_count);
+
+	//2. Time each kernel, checking it parses exactly what the first one did
+	Arena arena = {0};
+	HttpRequest request = {0};
+	request.arena = &arena;
+	uint64_t expected = 0;
+	for (size_t k = 0; k < LINE_SCAN_KERNELS; k++){
+		const LineScanKernel *kernel = &line_scan_kernels[k];
+		if (!kernel->supported()){
+			printf("%-8s not supported by this CPU\n", kernel->name);
+			continue;
+		}
+		scan_line = kernel->scan;
+
+		uint64_t hash = 14695981039346656037u;
+		memcpy(work, round_data, round_len);
+		if (parse_round(work, &request, &arena, &hash) == 0){
+			return 1;
+		}
+		if (expected == 0){
+			expected = hash;
+		}
+		else if (hash != expected){
+			fprintf(stderr, "%s parsed the corpus differently from %s\n", kernel->name, line_scan_kernels[0].name);
+			return 1;
+		}
+
+		uint64_t parse_ns = 0;
+		uint64_t rounds = 0;
+		while (parse_ns < seconds * 1e9){
+			memcpy(work, round_data, round_len);
+			uint64_t round_ns = parse_round(work, &request, &arena, NULL);
+			if (round_ns == 0){
+				return 1;
+			}
+			parse_ns += round_ns;
+			rounds++;
+		}
+		printf("%-8s %6.2f GB/s %7.1f ns/request\n", kernel->name,
+			(double)round_len * rounds / parse_ns, (double)parse_ns / (rounds * request_count));
+	}
+	arena_free(&arena);
+	return 0;
+}
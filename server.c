@@ -1,4 +1,6 @@
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <ctype.h>
 #include <string.h> 
 #include <stdlib.h> 
 #include <sys/types.h>
@@ -16,678 +18,6259 @@
 #include <limits.h>
 #include <netdb.h>
 #include <time.h>
+#include <errno.h>
+#include <getopt.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
+#include <sys/inotify.h>
+#include <netinet/tcp.h>
+#include <stdarg.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/openat2.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+#include "mime_types.h"
 
 #define OPEN_MAX 10 //Max number of forks
+#define MAX_EVENTS 1024 //Max epoll events handled per wakeup
+#define PIPELINE_MAX_REQUESTS 32 //Pipelined requests handled before their responses are flushed
+#define PIPELINE_MAX_QUEUED (256 * 1024) //Stop handling pipelined requests once this much output is queued
+#define READ_CHUNK 4096 //Bytes read from a socket per read() call
+#define BODY_CHUNK 16384 //Most request body bytes handed to a body handler per call
+#define BODY_BUFFER (64 * 1024) //Request body bytes read ahead of the handler before reading pauses
+#define ACCEPT_BATCH 64 //Connections accepted per listener wakeup before the other ready events get a turn
 
-//Header struct 
-typedef struct{
-	char *key;
-	char *value;
-}Header;
-
-typedef struct{ //Ordered from largest to smallest for better cache alignment
-	Header headers[20]; // Host: localhost:4040, Keep-alive: yes, Content-type: application/json etc
-	char *path; // /info.html
-	char *query_string; // ?pageNo=5
-	char *protocol; // HTTP/1.1
-	char *body; // Used in POST, PUT methods e.g form submissions
-	char method[8]; //GET, POST, etc
-	int header_count; // # of headers
-} HttpRequest;
+//=====================ARENA==================
+/*
+ * Per-connection bump allocator for everything that lives as long as one request:
+ * header storage, paths, request bodies. Nothing allocated from it is freed
+ * individually; arena_reset() between requests rewinds to the first block in O(1)
+ * and keeps the blocks, so a keep-alive connection in steady state never calls
+ * malloc. Allocations too big for a block get their own and are freed on reset
+ * so one large request does not pin memory for the life of the connection.
+ */
+#define ARENA_BLOCK 8192
+#define ARENA_ALIGN 16
 
-//Semaphore global declaration
-sem_t *semaphore;
+typedef struct ArenaBlock{
+	struct ArenaBlock *next;
+	size_t size; // usable bytes in data
+	size_t used;
+	char data[] __attribute__((aligned(ARENA_ALIGN)));
+} ArenaBlock;
 
-//Parse Header
-int parse_client_request(const char *raw_request_buffer, HttpRequest *client_request, char *request_line_end){
-	HttpRequest request = {0}; //initialize all struct values to NULL;
+typedef struct{
+	ArenaBlock *first; // NULL until the first allocation
+	ArenaBlock *current; // block being bumped, blocks after it are free
+	ArenaBlock *large; // oversized allocations, freed by arena_reset()
+} Arena;
 
-	//2. Fetch the HTTP Method
-	char *request_method_token = strtok((char *)raw_request_buffer, " \r\n");
-	if(request_method_token != NULL)
-	{
-		/*
-		 * Copy (at most) sizeof(client_request=>method) - 1 characters 
-		 * from the request line into the client_request->method, 
-		 * then manually set the null terminator
-		 */
-		strncpy(client_request->method, request_method_token, sizeof(client_request->method) - 1);
-		client_request->method[sizeof(client_request->method) - 1] = '\0';
-	}
-	else 
-	{
-		fprintf(stderr, "Request line not found\n");
-		return 1;
+ArenaBlock *arena_new_block(size_t size){
+	ArenaBlock *block = malloc(sizeof(ArenaBlock) + size);
+	if (block == NULL){
+		perror("Memory allocation failed\n");
+		return NULL;
 	}
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+	return block;
+}
 
-	//3. Fetch the path and query string
-	char *path_token = strtok(NULL ," ");
-	if (path_token != NULL)
-	{
-		/*
-		 * Check if path contains query. If it does, store query to 
-		 * client_request->query_string otherwise set it to null
-		 */
-		char *question_mark = strchr(path_token, '?');
-		if (question_mark != NULL)
-		{
-			//replace question mark with null terminator
-			*question_mark = '\0';
-			//set path and query
-			client_request->path = path_token;
-			client_request->query_string = question_mark + 1;
-		}
-		else
-		{
-			client_request->path = path_token;
-			client_request->query_string = NULL;	
-		}
-	}
-	else
-	{
-		fprintf(stderr, "Path not found\n");
-		return 1;
-	}
+//Returns size bytes aligned to ARENA_ALIGN, or NULL if memory is exhausted
+void *arena_alloc(Arena *arena, size_t size){
+	size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
 
-	//4. Fetch the protocol
-	char *protocol_token = strtok(NULL, " \r\n");
-	if (protocol_token != NULL)
-	{
-		client_request->protocol = protocol_token;
-		if (client_request->protocol == NULL)
-		{
-			fprintf(stderr, "Memory allocation failed\n");
-			return 1;
+	//1. Oversized: a block of its own
+	if (size > ARENA_BLOCK / 2){
+		ArenaBlock *block = arena_new_block(size);
+		if (block == NULL){
+			return NULL;
 		}
+		block->next = arena->large;
+		arena->large = block;
+		return block->data;
 	}
-	else
-	{
-		fprintf(stderr, "Protocol Not Found\n");
-		return 1;
+
+	//2. Bump the current block, moving on to a kept or new one when it is full
+	if (arena->current == NULL || arena->current->size - arena->current->used < size){
+		ArenaBlock *next = arena->current != NULL ? arena->current->next : arena->first;
+		if (next == NULL){
+			next = arena_new_block(ARENA_BLOCK);
+			if (next == NULL){
+				return NULL;
+			}
+			if (arena->current != NULL) arena->current->next = next;
+			else arena->first = next;
+		}
+		next->used = 0;
+		arena->current = next;
 	}
+	void *result = arena->current->data + arena->current->used;
+	arena->current->used += size;
+	return result;
+}
 
-	//5. Fetch the headers
-	/*
-	 * First we find the end of the request line then
-	 * we use that to find the beginning of the headers. We then
-	 * find the end of the headers and replace the delimiters with 
-	 * a null terminating character. Afterwards we eliminate any 
-	 * invalid headers then parse through the headers storing them
-	 * to the headers field. Finally we increament header_count by 1.
-	 */
+char *arena_strdup(Arena *arena, const char *text){
+	size_t len = strlen(text) + 1;
+	char *copy = arena_alloc(arena, len);
+	if (copy != NULL){
+		memcpy(copy, text, len);
+	}
+	return copy;
+}
 
-	if (request_line_end == NULL)
-	{
-		fprintf(stderr, "Malformed request line\n");
-		return 1;
+//Forget every allocation. Blocks are kept for the next request, oversized ones released
+void arena_reset(Arena *arena){
+	while (arena->large != NULL){
+		ArenaBlock *next = arena->large->next;
+		free(arena->large);
+		arena->large = next;
 	}
+	arena->current = NULL;
+}
 
-	char *headers_end = strstr(request_line_end + 2, "\r\n\r\n");
-	if (headers_end == NULL)
-	{
-		fprintf(stderr, "Malformed headers - missing \\r\\n\\r\\n terminators.\n");
-		return 1;
+void arena_free(Arena *arena){
+	arena_reset(arena);
+	while (arena->first != NULL){
+		ArenaBlock *next = arena->first->next;
+		free(arena->first);
+		arena->first = next;
 	}
+}
 
-	*headers_end = '\0';
-	char *raw_headers_block = request_line_end + 2;
+//=====================TIMER WHEEL==================
+/*
+ * Hierarchical timing wheel for connection timeouts. Four levels of 64 slots:
+ * level 0 holds timers due within 64 ticks, level 1 within 64^2 and so on, and a
+ * slot's timers are moved down a level when the level below wraps around to it.
+ * Arming and cancelling unlink/link one node of a circular list, O(1) however
+ * many connections are open; each tick touches one level 0 slot.
+ */
+#define TIMER_TICK_MS 100
+#define TIMER_LEVELS 4
+#define TIMER_SLOT_BITS 6
+#define TIMER_SLOTS (1 << TIMER_SLOT_BITS)
+#define TIMER_MAX_TICKS ((1ULL << (TIMER_LEVELS * TIMER_SLOT_BITS)) - 1)
 
-	char *header_token;
-	char *save_ptr;
+typedef struct TimerNode{
+	struct TimerNode *next; // NULL when not armed
+	struct TimerNode *prev;
+	uint64_t expires; // tick
+} TimerNode;
 
-	header_token = strtok_r(raw_headers_block, "\r\n", &save_ptr);
-	while (header_token != NULL)
-	{
-		if(client_request->header_count >= 20)
-		{
-			fprintf(stderr, "Max number of headers (20) reached\n");
-			break;
-		}
-		if(strlen(header_token) > 0)
-		{
-			//A header must have a colon & if not, skip it
-			char *colon = strchr(header_token, ':');
-			if (colon == NULL)
-			{
-				fprintf(stderr, "Colon not found in header\n");
-				header_token = strtok_r(NULL, "\r\n", &save_ptr);
-				continue;
-			}
+typedef struct{
+	TimerNode slots[TIMER_LEVELS][TIMER_SLOTS]; // list heads
+	uint64_t now; // last tick processed
+	int armed; // timers linked into the wheel
+} TimerWheel;
 
-			//Separate header key and value based on the colon 
-			*colon = '\0';
-			char *key = header_token;
-			char *value = colon + 1;
-
-			//Ensure whitespaces e.g. "Host: localhost" are eliminated
-			while(*value == ' ' || *value == '\t')
-			{
-				value++;
-			}
-			 
-			//Store key and value
-			client_request->headers[client_request->header_count].key = strdup(key);
-			client_request->headers[client_request->header_count].value = strdup(value);
-
-			if
-			(
-				client_request->headers[client_request->header_count].key == NULL ||
-				client_request->headers[client_request->header_count].value == NULL 
-			)
-			{
-				perror("Memory allocation failed for header\n");
-				return 1;
-			}
-			client_request->header_count++;
-		}
-		else
-		{
-			printf("Empty header token encountered. Skipping\n");
+TimerWheel timer_wheel;
+
+uint64_t timer_ticks_now(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * (1000 / TIMER_TICK_MS) + now.tv_nsec / (TIMER_TICK_MS * 1000000L);
+}
+
+void timer_wheel_init(TimerWheel *wheel){
+	for (int level = 0; level < TIMER_LEVELS; level++){
+		for (int slot = 0; slot < TIMER_SLOTS; slot++){
+			wheel->slots[level][slot].next = wheel->slots[level][slot].prev = &wheel->slots[level][slot];
 		}
-		
-		header_token = strtok_r(NULL, "\r\n", &save_ptr);
 	}
-	printf("Header parsing done. %d headers found\n", client_request->header_count);
-	return 0;
+	wheel->now = timer_ticks_now();
+	wheel->armed = 0;
 }
 
-void free_http_request(HttpRequest *request){
-	for (int i = 0; i < request->header_count; i++){
-		if (request->headers[i].key){
-			free(request->headers[i].key);
-		}
-		if (request->headers[i].value){
-			free(request->headers[i].value);
-		}
+void timer_unlink(TimerNode *node){
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->next = node->prev = NULL;
+}
+
+void timer_cancel(TimerWheel *wheel, TimerNode *node){
+	if (node->next != NULL){
+		timer_unlink(node);
+		wheel->armed--;
 	}
 }
 
-//Function to get header fields
-char *get_header_value(HttpRequest *request, char *name){
-	for (int i = 0; i < request->header_count; i++){
-		if (strncasecmp(request->headers[i].key, name, strlen(name)) == 0){
-			return request->headers[i].value;
+//Link node into the slot for its expiry: the lowest level whose span covers the distance
+void timer_place(TimerWheel *wheel, TimerNode *node){
+	uint64_t delta = node->expires - wheel->now;
+	int level = 0;
+	while (level < TIMER_LEVELS - 1 && delta >= (1ULL << ((level + 1) * TIMER_SLOT_BITS))){
+		level++;
+	}
+	TimerNode *head = &wheel->slots[level][(node->expires >> (level * TIMER_SLOT_BITS)) & (TIMER_SLOTS - 1)];
+	node->next = head;
+	node->prev = head->prev;
+	head->prev->next = node;
+	head->prev = node;
+}
+
+//(Re)arm node to expire after timeout_ms
+void timer_arm(TimerWheel *wheel, TimerNode *node, long timeout_ms){
+	uint64_t ticks = (timeout_ms + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+	if (ticks < 1) ticks = 1;
+	if (ticks > TIMER_MAX_TICKS) ticks = TIMER_MAX_TICKS;
+	if (node->next != NULL){
+		timer_unlink(node);
+	}
+	else {
+		//An empty wheel is not advanced while epoll sleeps, catch it up first
+		if (wheel->armed == 0){
+			wheel->now = timer_ticks_now();
 		}
+		wheel->armed++;
 	}
-	return NULL;
+	node->expires = wheel->now + ticks;
+	timer_place(wheel, node);
 }
 
-//Function to handle connection status. Returns 0 (close) or 1 (keep alive)
-int connection_close_or_keep_alive(HttpRequest *client_request){
-	int keep_alive = 0; /* Initialize keep alive to be 0 */
-	
-	//Get the request's connection status
-	char *request_connection_status = get_header_value(client_request, "Connection");	
+//Re-place every timer of a higher level slot now that it is within reach of the level below
+void timer_cascade(TimerWheel *wheel, int level, int slot){
+	TimerNode *head = &wheel->slots[level][slot];
+	while (head->next != head){
+		TimerNode *node = head->next;
+		timer_unlink(node);
+		timer_place(wheel, node);
+	}
+}
 
-	//Get the request's protocol. HTTP/1.0 deafult = close. HTTP/1.1 default = keep-alive.
-	char *protocol = client_request->protocol;
-	if (strcmp (protocol, "HTTP/1.0") == 0){
-		if (request_connection_status != NULL && strcasecmp(request_connection_status, "keep-alive") == 0) {
-			keep_alive = 1;
-		} else {
-			keep_alive = 0;
-		}
-	} else if(strcmp (protocol, "HTTP/1.1") == 0){
-		if (request_connection_status != NULL && strcasecmp(request_connection_status, "close") == 0){
-			keep_alive = 0;
-		} else {
-			keep_alive = 1;
-		}
+/*
+ * Advance the wheel to the current time, calling expire for each timer that came
+ * due. expire may arm or cancel any timer, including the one it was called for
+ */
+void timer_wheel_advance(TimerWheel *wheel, void (*expire)(TimerNode *node, void *context), void *context){
+	uint64_t target = timer_ticks_now();
+	while (wheel->now < target){
+		wheel->now++;
 
-	} else {
-		keep_alive = 0;
+		//1. Wrapping level 0 brings the next slot of level 1 (and, on its wrap, level 2...) down
+		uint64_t index = wheel->now;
+		for (int level = 1; level < TIMER_LEVELS && (index & (TIMER_SLOTS - 1)) == 0; level++){
+			index >>= TIMER_SLOT_BITS;
+			timer_cascade(wheel, level, index & (TIMER_SLOTS - 1));
+		}
 
+		//2. Everything left in this level 0 slot is due
+		TimerNode *head = &wheel->slots[0][wheel->now & (TIMER_SLOTS - 1)];
+		while (head->next != head){
+			TimerNode *node = head->next;
+			timer_cancel(wheel, node);
+			expire(node, context);
+		}
 	}
+}
 
-	return keep_alive;
+//epoll_wait() timeout: until the next tick while timers are armed, otherwise forever
+int timer_wheel_wait_ms(TimerWheel *wheel){
+	return wheel->armed > 0 ? TIMER_TICK_MS : -1;
 }
 
-//Function to handle the request method. Returns 0 for success, 1 for failure
-int handle_method(int client_socket, HttpRequest *client_request, char *buffer, int bytes_read){
-	if (strcmp(client_request->method, "GET") == 0)
-	{
-		printf("Handling GET request...\n");
+//=====================I/O POOL==================
+/*
+ * Threads that do the blocking file side of requests (opening, stat()ing and reading
+ * files) so a cold disk never stalls the event loop. Every thread owns a deque: the
+ * loop deals jobs out round robin, a thread takes the oldest job from its own deque
+ * and, once that is empty, steals the newest from another thread's, so one slow read
+ * does not hold up the jobs queued behind it. Finished jobs go on a list and an
+ * eventfd wakes the loop, which completes them on its own thread. A job only does
+ * its blocking work off the loop thread; the connection it was for may have gone by
+ * the time it finishes, in which case conn is NULL and complete just cleans up.
+ */
+#define IO_THREADS_MAX 64
+#define IO_DEQUE_SIZE 256 //Jobs queued per thread, a power of two. When every deque is full the loop does the work itself
 
-		//Canonical path for where files are
-		const char *directory_name = "files";
-		char canonical_directory_path[PATH_MAX];
-		if (realpath(directory_name, canonical_directory_path) == NULL){
-			fprintf(stderr, "Failed to canonicalize directory path\n");
-			return 1;
-		}
-		char *request_path = client_request->path;
-		
-		//Actual file path on disk
-		char *final_request_path;
-	
-		//1. Handle root requests
-		if (strcmp(request_path, "/") == 0 || strcmp(request_path, "") == 0){
-			final_request_path = "/index.html";
-		} else {
-			final_request_path = request_path;
-		}
+typedef struct IoJob{
+	struct IoJob *next; // completed list
+	void (*run)(struct IoJob *job); // pool thread: the blocking work and nothing else
+	void (*complete)(struct IoJob *job); // loop thread: use the result, or only release it when conn is NULL
+	struct Connection *conn; // NULL once the connection has gone
+	int done; // back on the loop thread
+} IoJob;
 
-		//2. Dynamically allocate memory for full path
-		size_t uncanonical_full_path_len = strlen(directory_name) + strlen(final_request_path) + 1;
-		char *uncanonical_full_path = malloc(uncanonical_full_path_len);
-		if (uncanonical_full_path == NULL){
-			perror("Memory allocation failed\n");
-			return 1;
-		}
+typedef struct{
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	IoJob *jobs[IO_DEQUE_SIZE];
+	unsigned head; // oldest job, taken by the owner
+	unsigned tail; // one past the newest job, taken by thieves
+	int idle; // asleep waiting for a job
+} IoWorker;
 
-		//3. Construct full path and canonicalize it
-		snprintf(uncanonical_full_path, uncanonical_full_path_len, "%s%s", directory_name, final_request_path);
-
-		char *full_path = malloc(PATH_MAX);
-		if (realpath(uncanonical_full_path, full_path) == NULL){
-			fprintf(stderr, "Path canonicalization failed: %s\n", full_path);
-			free(uncanonical_full_path);
-			free(full_path);
-			char *not_found = "HTTP/1.1 404 Not Found\r\n"
-				"Content-Type: text/plain; charset=utf-8\r\n"
-				"Content-Length: 15\r\n"
-				"\r\n"
-				"404 Not Found\r\n";
-			write(client_socket, not_found, strlen(not_found));
-			return 1;
-		}
+typedef struct{
+	IoWorker workers[IO_THREADS_MAX];
+	int configured; // --io-threads
+	int thread_count; // running threads, 0 when file work stays on the loop thread
+	unsigned next; // deque the next job goes to
+	int stop;
+	int event_fd; // readable while completed has jobs
+	pthread_mutex_t completed_lock;
+	IoJob *completed;
+} IoPool;
 
-		printf("THE FULL PATH IS: %s\n", full_path);
-
-		//Validate the path
-		if (strncmp(canonical_directory_path, full_path, strlen(canonical_directory_path)) != 0){
-			fprintf(stderr, "Security: Malicious path attack attempted: %s\n", full_path);
-			char *forbidden = "HTTP/1.1 403 Forbidden\r\n"
-				"Content-Type: text/plain; charset=utf-8\r\n"
-				"Content-Length: 11\r\n"
-				"\r\n"
-				"Forbidden\r\n";
-			write(client_socket, forbidden, strlen(forbidden));
-		}
-
-		//4. Open file. Use rb because not every file will be text.
-		FILE *fp = fopen(full_path, "rb");
-		if (fp == NULL){
-			perror("Failed to open file\n");
-			char *not_found = "HTTP/1.1 404 Not Found\r\n"
-				"Content-Type: text/plain; charset=utf-8\r\n"
-				"Content-Length: 15\r\n"
-				"\r\n"
-				"404 Not Found\r\n";
-			write(client_socket, not_found, strlen(not_found));
-			free(uncanonical_full_path);
-			free(full_path);
-			return 1;
-		} else {
-			//find out file size
-			fseek(fp, 0, SEEK_END);
-			long file_size = ftell(fp);
-			rewind(fp);
-			
-			//copy file into a buffer
-			char *file_content = malloc(file_size + 1);
-
-			if (file_content == NULL){
-				perror("Memory allocation failed\n");
-				fclose(fp);
-				free(uncanonical_full_path);
-				free(full_path);
-				char *server_error = "HTTP/1.1 500 Internal Server Error\r\n"
-					"Content-Type: text/plain; charset=utf-8\r\n"
-					"Content-Length: 23\r\n"
-					"\r\n"
-					"Internal Server Error\r\n";
-				write(client_socket, server_error, strlen(server_error));
-				return 1;
-			}
+IoPool io_pool = { .configured = 4, .event_fd = -1 };
 
-			if (fread(file_content, 1, file_size, fp) != file_size){
-				perror("File read incomplete");
-				free(file_content);
-				fclose(fp);
-				free(uncanonical_full_path);
-				free(full_path);
-				char *server_error = "HTTP/1.1 500 Internal Server Error\n"
-					"Content-Type: text/plain; charset=utf-8\r\n"
-					"Content-Length: 23\r\n"
-					"\r\n"
-					"Internal Server Error\r\n";
-				write(client_socket, server_error, strlen(server_error));
-				return 1;
+//Take the oldest job from a deque for its owner, or the newest for a thief. NULL if it is empty
+IoJob *io_deque_take(IoWorker *worker, int steal){
+	IoJob *job = NULL;
+	pthread_mutex_lock(&worker->lock);
+	if (worker->head != worker->tail){
+		job = steal ? worker->jobs[--worker->tail & (IO_DEQUE_SIZE - 1)] : worker->jobs[worker->head++ & (IO_DEQUE_SIZE - 1)];
+	}
+	pthread_mutex_unlock(&worker->lock);
+	return job;
+}
+
+//A job from the thread's own deque, else one stolen from the others in turn
+IoJob *io_pool_take(int self){
+	IoJob *job = io_deque_take(&io_pool.workers[self], 0);
+	for (int i = 1; job == NULL && i < io_pool.thread_count; i++){
+		job = io_deque_take(&io_pool.workers[(self + i) % io_pool.thread_count], 1);
+	}
+	return job;
+}
+
+void *io_worker_main(void *arg){
+	int self = (int)(intptr_t)arg;
+	IoWorker *worker = &io_pool.workers[self];
+	while (1){
+		IoJob *job = io_pool_take(self);
+		if (job == NULL){
+			//Say we are idle, then look once more: a job queued before a submitter saw the flag is found here
+			pthread_mutex_lock(&worker->lock);
+			worker->idle = 1;
+			pthread_mutex_unlock(&worker->lock);
+			job = io_pool_take(self);
+
+			pthread_mutex_lock(&worker->lock);
+			if (job != NULL){
+				worker->idle = 0;
 			}
-			
-			//8. Determine content type in response header
-			const char *content_type = "application/octet-stream"; //Default
-			char *file_extension = strrchr(final_request_path, '.');
-			if (file_extension != NULL && file_extension != final_request_path){
-				file_extension++;
-				if (strcmp(file_extension, "html") == 0) content_type = "text/html";
-				else if (strcmp(file_extension, "css") == 0) content_type = "text/css";
-				else if (strcmp(file_extension, "js") == 0) content_type = "application/js";
-				else if (strcmp(file_extension, "json") == 0) content_type = "application/json";
-				else if (strcmp(file_extension, "pdf") == 0) content_type = "application/pdf";
-				else if (strcmp(file_extension, "png") == 0) content_type = "image/png";
-				else if (strcmp(file_extension, "jpg") == 0 || strcmp(file_extension, "jpeg") == 0) content_type = "image/jpeg";
-			}
-
-			//9. Check the connection 
-			int conn_status = connection_close_or_keep_alive(client_request);
-			char *conn;
-			if (conn_status == 0){
-				conn = "close";
+			while (job == NULL && worker->idle && !io_pool.stop){
+				pthread_cond_wait(&worker->wake, &worker->lock);
 			}
-			else {
-				conn = "keep-alive";
-			}
-
-			//10. Build a Response header
-			char header[1024];
-			sprintf(header,
-					"HTTP/1.1 200 OK\r\n"
-					"Content-Type: %s\r\n"
-					"Content-Length: %ld\r\n"
-					"Connection: %s\r\n"
-					"\r\n",
-					content_type,
-					file_size,
-					conn);
-
-			//10. Send header then file content
-			write(client_socket, header, strlen(header));
-			write(client_socket, file_content, file_size);
-
-			//11. Free the memory
-			free(file_content);	
-			free(uncanonical_full_path);
-			free(full_path);
-
-			//12. Close the file
-			fclose(fp);
-		}
-		printf("Request handling done\n");
-		return 0;
-	}
+			int stop = io_pool.stop;
+			pthread_mutex_unlock(&worker->lock);
+			if (job == NULL){
+				if (stop){
+					return NULL;
+				}
+				continue;
+			}
+		}
+		job->run(job);
 
-	//=====================POST METHOD==================
-	/*
-	 *Check if the method is post. Check content length and convert it to an integer. Read that 
-	 *many bytes from the request body (after 'r/n/r/n') into a buffer. Perform different actions
-	 *based on the content type. Send a response.
-	 */
-	if (strcmp(client_request->method, "POST") == 0){
-		printf("Handling POST request...\n");
-
-		//1. Get Content-Length header
-		char *content_length_str = get_header_value(client_request, "Content-Length");
-		if (content_length_str == NULL){
-			perror("Content length not found in reqest header\n");
-			char *no_content_length = "HTTP/1.1 400 Bad Request\r\n\r\n";
-			write(client_socket, no_content_length, strlen(no_content_length));
-			return 1;
+		//Hand it back. The loop empties the list after reading the eventfd, so only the first job needs a wakeup
+		pthread_mutex_lock(&io_pool.completed_lock);
+		int was_empty = io_pool.completed == NULL;
+		job->next = io_pool.completed;
+		io_pool.completed = job;
+		pthread_mutex_unlock(&io_pool.completed_lock);
+		if (was_empty){
+			uint64_t one = 1;
+			if (write(io_pool.event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN){
+				perror("I/O pool wakeup failed\n");
+			}
 		}
+	}
+}
 
-		//2. Convert str to int
-		long content_length = atoi(content_length_str);
-		if (content_length <= 0){
-			perror("Invalid content length\n");
-			char *no_content_length = "HTTP/1.1 400 Bad Request\r\n\r\n";
-			write(client_socket, no_content_length, strlen(no_content_length));
-			return 1;
+//Wake the owner of a new job if it sleeps, otherwise any sleeping thread, which will steal it
+void io_pool_wake(int owner){
+	for (int i = 0; i < io_pool.thread_count; i++){
+		IoWorker *worker = &io_pool.workers[(owner + i) % io_pool.thread_count];
+		pthread_mutex_lock(&worker->lock);
+		int idle = worker->idle;
+		if (idle){
+			worker->idle = 0;
+			pthread_cond_signal(&worker->wake);
 		}
-		printf("The content length is %lu\n", content_length);
-		
-		//3. Allocate memory for request body
-		char *request_body = malloc(content_length + 1);
-		if (request_body == NULL){
-			perror("Failed to allocate memory\n");
-			char *server_error = "HTTP/1.1 500 Internal Server Error\r\n\r\n";
-			write(client_socket, server_error, strlen(server_error));
-			return 1;
+		pthread_mutex_unlock(&worker->lock);
+		if (idle){
+			return;
 		}
-		printf("Allocated memory to request body\n");
+	}
+}
 
-		//4. Read bytes from buffer to request_body
-		int total_bytes_read = 0;
-		if (buffer != NULL && bytes_read > 0){
-			int bytes_to_copy = (bytes_read < content_length) ? bytes_read : content_length;
-			memcpy(request_body, buffer, bytes_to_copy);
-			total_bytes_read = bytes_to_copy;
+//Queue a job for the pool. Returns 0 if queued, 1 if there is no pool or it is full and the caller should run the job itself
+int io_pool_submit(IoJob *job){
+	for (int i = 0; i < io_pool.thread_count; i++){
+		int owner = io_pool.next++ % io_pool.thread_count;
+		IoWorker *worker = &io_pool.workers[owner];
+		pthread_mutex_lock(&worker->lock);
+		int queued = worker->tail - worker->head < IO_DEQUE_SIZE;
+		if (queued){
+			worker->jobs[worker->tail++ & (IO_DEQUE_SIZE - 1)] = job;
 		}
-
-		//If not all bytes have been read from the buffer then check for the remaining ones 
-		//in the client socket
-		while (total_bytes_read < content_length) {
-			int bytes_read = read(client_socket, request_body + total_bytes_read, content_length - total_bytes_read);
-			if (bytes_read <= 0){
-				free(request_body);
-				return 1;
-			}
-			total_bytes_read += bytes_read;
+		pthread_mutex_unlock(&worker->lock);
+		if (queued){
+			job->done = 0;
+			io_pool_wake(owner);
+			return 0;
 		}
-		request_body[content_length] = '\0';
-		printf("Content Length: %ld\n", content_length);
-		printf("Request Body: %s\n", request_body);
+	}
+	return 1;
+}
 
-		//5. Send success response
-		char *success_response = "HTTP/1.1 200 OK\r\n"
-			"Content-Type: text/plain; charset=utf-8\r\n"
-			"Content-Length: 24\r\n"
-			"\r\n"
-			"POST request processed\r\n";
+//Take the jobs the pool has finished, oldest first. Read the eventfd before calling this
+IoJob *io_pool_completed(void){
+	pthread_mutex_lock(&io_pool.completed_lock);
+	IoJob *job = io_pool.completed;
+	io_pool.completed = NULL;
+	pthread_mutex_unlock(&io_pool.completed_lock);
 
-		int bytes_written = write(client_socket, success_response, strlen(success_response));
-		printf("Bytes written: %d (expected %zu)\n", bytes_written, strlen(success_response));
-		if (bytes_written < 0) 
-		{
-			perror("Write failed"); 
-			return 1;
-		}
-		free(request_body);
-		return 0;
+	IoJob *oldest_first = NULL;
+	while (job != NULL){
+		IoJob *next = job->next;
+		job->next = oldest_first;
+		job->done = 1;
+		oldest_first = job;
+		job = next;
 	}
+	return oldest_first;
+}
 
-	else {
-		fprintf(stderr, "Method Not Allowed\n");
-		char *method_not_allowed = "HTTP/1.1 405 Method Not Allowed\r\n"
-			"Content-Type: text/html; charset=utf-8\r\n"
-			"Content-Length: 20\r\n"
-			"\r\n"
-			"Method Not Allowed\r\n";
-		write(client_socket, method_not_allowed, strlen(method_not_allowed));
+//Start the configured threads in this process. Returns 0 for success, 1 for failure
+int io_pool_start(void){
+	if (io_pool.configured == 0){
+		return 0;
+	}
+	io_pool.event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (io_pool.event_fd < 0){
+		perror("eventfd failed\n");
 		return 1;
 	}
-	
+	pthread_mutex_init(&io_pool.completed_lock, NULL);
+	io_pool.thread_count = io_pool.configured;
+	for (int i = 0; i < io_pool.thread_count; i++){
+		pthread_mutex_init(&io_pool.workers[i].lock, NULL);
+		pthread_cond_init(&io_pool.workers[i].wake, NULL);
+	}
+	for (int i = 0; i < io_pool.thread_count; i++){
+		if (pthread_create(&io_pool.workers[i].thread, NULL, io_worker_main, (void *)(intptr_t)i) != 0){
+			perror("Failed to start I/O thread\n");
+			return 1;
+		}
+	}
+	return 0;
 }
 
-//Signal handler method
-void signal_handler(int sig){
-	pid_t pid;
-	int status;
-
-	while((pid = waitpid(-1, &status, WNOHANG)) > 0){
-		printf("Process %d has been terminated.\n", pid);
+//Stop and join the threads. Jobs still queued are dropped along with the process
+void io_pool_stop(void){
+	for (int i = 0; i < io_pool.thread_count; i++){
+		pthread_mutex_lock(&io_pool.workers[i].lock);
+		io_pool.stop = 1;
+		pthread_cond_signal(&io_pool.workers[i].wake);
+		pthread_mutex_unlock(&io_pool.workers[i].lock);
 	}
+	for (int i = 0; i < io_pool.thread_count; i++){
+		pthread_join(io_pool.workers[i].thread, NULL);
+	}
+	io_pool.thread_count = 0;
 }
 
+//=====================LINE SCANNING==================
+/*
+ * The parser walks a request head one line at a time and needs two things from
+ * each line: where it ends, and where its first ':' (a header) or '?' (the request
+ * line) is. scan_line() finds both in one pass. It uses libc's memchr() for each
+ * by default. On x86-64 there are also kernels that compare 16 (SSE2) or 32 (AVX2)
+ * bytes at a time and read the matches back as a bit mask; they are timed against
+ * memchr() once at startup and only used when they beat it on short and long lines.
+ */
+typedef const char *(*LineScanFn)(const char *p, const char *end, char mark, const char **mark_pos);
 
-int main(int argc, char *argv[]){
-	//0. Get address info
-	struct addrinfo hints, *results;
+typedef struct{
+	const char *name;
+	LineScanFn scan;
+	int (*supported)(void);
+} LineScanKernel;
 
-	hints.ai_family = AF_UNSPEC;
-	hints.ai_socktype = SOCK_STREAM;
-	hints.ai_flags = AI_PASSIVE;
-	
-	if(getaddrinfo(NULL, "4040", &hints, &results) != 0){
-		perror("Failed to find address\n");
-		return 1;
-	}
+/*
+ * Each kernel returns the first '\n' in [p, end), or NULL if the line is not complete
+ * yet, and sets *mark_pos to the first mark before it (NULL if there is none)
+ */
+const char *scan_line_memchr(const char *p, const char *end, char mark, const char **mark_pos){
+	const char *newline = memchr(p, '\n', end - p);
+	*mark_pos = memchr(p, mark, (newline != NULL ? newline : end) - p);
+	return newline;
+}
 
-	// 1. Create a socket
-	int server_fd = socket(results->ai_family, results->ai_socktype, results->ai_protocol);
-	if (server_fd < 0){
-		perror("Cannot create socket\n");
-		return 0;
+int scan_always(void){
+	return 1;
+}
+
+#ifdef __x86_64__
+//Bytes past the last full vector, one at a time
+const char *scan_line_tail(const char *p, const char *end, char mark, const char **mark_pos){
+	for (; p < end; p++){
+		if (*p == '\n'){
+			return p;
+		}
+		if (*p == mark && *mark_pos == NULL){
+			*mark_pos = p;
 		}
-	
-	// 2. Bind socket to address
-	if (bind(server_fd, results->ai_addr, results->ai_addrlen) < 0){
-		perror("Binding failed\n");
-		return 0;
 	}
+	return NULL;
+}
 
-	// 3. Listen for connections.
-	int listen_for_connection = listen(server_fd, 5);
-	if (listen_for_connection < 0){
-		perror("Listening failed\n");
-		exit(1);
+const char *scan_line_sse2(const char *p, const char *end, char mark, const char **mark_pos){
+	const __m128i newlines = _mm_set1_epi8('\n');
+	const __m128i marks = _mm_set1_epi8(mark);
+	*mark_pos = NULL;
+	for (; end - p >= 16; p += 16){
+		__m128i bytes = _mm_loadu_si128((const __m128i *)p);
+		unsigned newline_bits = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newlines));
+		unsigned mark_bits = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, marks));
+		//Only marks below the first newline belong to this line
+		if (newline_bits != 0){
+			mark_bits &= (newline_bits & -newline_bits) - 1;
+		}
+		if (mark_bits != 0 && *mark_pos == NULL){
+			*mark_pos = p + __builtin_ctz(mark_bits);
+		}
+		if (newline_bits != 0){
+			return p + __builtin_ctz(newline_bits);
+		}
 	}
-	printf("Server listening on port 4040...\n");
+	return scan_line_tail(p, end, mark, mark_pos);
+}
 
-	//Call signal_handler when a child process terminates
-	struct sigaction sa;
-	sa.sa_handler = signal_handler;
-	sigemptyset(&sa.sa_mask);
-	sa.sa_flags = SA_RESTART;
-	if(sigaction(SIGCHLD, &sa, NULL) == -1){
-		perror("Sigaction failed\n");
-		close(server_fd);
-		exit(1);
+__attribute__((target("avx2")))
+const char *scan_line_avx2(const char *p, const char *end, char mark, const char **mark_pos){
+	const __m256i newlines = _mm256_set1_epi8('\n');
+	const __m256i marks = _mm256_set1_epi8(mark);
+	*mark_pos = NULL;
+	for (; end - p >= 32; p += 32){
+		__m256i bytes = _mm256_loadu_si256((const __m256i *)p);
+		unsigned newline_bits = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newlines));
+		unsigned mark_bits = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, marks));
+		if (newline_bits != 0){
+			mark_bits &= (newline_bits & -newline_bits) - 1;
+		}
+		if (mark_bits != 0 && *mark_pos == NULL){
+			*mark_pos = p + __builtin_ctz(mark_bits);
+		}
+		if (newline_bits != 0){
+			return p + __builtin_ctz(newline_bits);
+		}
 	}
+	return scan_line_tail(p, end, mark, mark_pos);
+}
 
-	//Semaphore memory mapping
-	semaphore = mmap(NULL, sizeof(sem_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
-	if (semaphore == MAP_FAILED){
-		perror("Sempahore memory mapping failed\n");
-		exit(1);
-	}
+int scan_avx2_supported(void){
+	return __builtin_cpu_supports("avx2");
+}
+#endif
 
-	//Initialize semaphore with 10 max processes
-	if(sem_init(semaphore, 1, OPEN_MAX) != 0){
-		perror("Semaphore initialization failed\n");
-		exit(1);
-	}
-	// 4. Accept connections.
-	while(1){
-		struct sockaddr_in client_addy;
-		socklen_t client_addy_len = sizeof(client_addy);
-		int client_socket = accept(server_fd, (struct sockaddr *) &client_addy, &client_addy_len);
-		if (client_socket < 0){
-			perror("Connection failed\n");
-			continue;
-		}
+//Narrowest first
+const LineScanKernel line_scan_kernels[] = {
+	{ "memchr", scan_line_memchr, scan_always },
+#ifdef __x86_64__
+	{ "sse2", scan_line_sse2, scan_always },
+	{ "avx2", scan_line_avx2, scan_avx2_supported },
+#endif
+};
+#define LINE_SCAN_KERNELS (sizeof(line_scan_kernels) / sizeof(line_scan_kernels[0]))
 
-		//Print client's IP Address, port number and time of request
-		time_t current_time = time(&current_time);
-		struct tm *time_info = time_info = localtime(&current_time);
+#define SCAN_CALIBRATE_BYTES (256 * 1024) //Line bytes scanned per timing
+#define SCAN_CALIBRATE_ROUNDS 5 //Timings per kernel and line, the fastest counts
+#define SCAN_CALIBRATE_MARGIN 10 //Percent a kernel must beat memchr() by on every line
 
-		char client_ip[INET_ADDRSTRLEN];
-		inet_ntop(AF_INET, &(client_addy.sin_addr), client_ip, INET_ADDRSTRLEN);
-		printf("Client's IP Address: %s. Time: %s\n", client_ip, asctime(time_info));
+LineScanFn scan_line = scan_line_memchr;
+volatile uintptr_t scan_line_sink; // keeps the calibration scans from being optimised away
 
-		//Check if there's an available slot before creating a new child
-		if (sem_wait(semaphore) != 0){
-			perror("sem_wait failed\n");
-			close(client_socket);
-			continue;
+//Fastest of SCAN_CALIBRATE_ROUNDS timings of scanning line over and over, in ns
+uint64_t scan_line_time(LineScanFn scan, const char *line, size_t len){
+	uint64_t best = UINT64_MAX;
+	for (int round = 0; round < SCAN_CALIBRATE_ROUNDS; round++){
+		struct timespec start, end;
+		const char *mark;
+		uintptr_t sink = 0;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (size_t scanned = 0; scanned < SCAN_CALIBRATE_BYTES; scanned += len){
+			sink += (uintptr_t)scan(line, line + len, ':', &mark) + (uintptr_t)mark;
 		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		scan_line_sink = sink;
+		uint64_t ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ull + end.tv_nsec - start.tv_nsec;
+		if (ns < best){
+			best = ns;
+		}
+	}
+	return best;
+}
 
-		//Create child process to handle client request
-		pid_t pid = fork();
+//Keep memchr() unless a kernel this CPU supports is measurably faster on both a short and a multi-KB header line
+void scan_line_select(void){
+	static char long_line[4096];
+	const char short_line[] = "Host: www.example.com\r\n";
+	memset(long_line, 'a', sizeof(long_line));
+	memcpy(long_line, "Cookie: ", 8);
+	memcpy(long_line + sizeof(long_line) - 2, "\r\n", 2);
 
-		if (pid == -1){
-			perror("Fork failed\n");
-			sem_post(semaphore);
-			close(client_socket);
+	uint64_t memchr_short = scan_line_time(scan_line_memchr, short_line, sizeof(short_line) - 1);
+	uint64_t memchr_long = scan_line_time(scan_line_memchr, long_line, sizeof(long_line));
+	uint64_t best = memchr_short + memchr_long;
+	for (size_t i = 0; i < LINE_SCAN_KERNELS; i++){
+		const LineScanKernel *kernel = &line_scan_kernels[i];
+		if (kernel->scan == scan_line_memchr || !kernel->supported()){
 			continue;
 		}
+		uint64_t short_ns = scan_line_time(kernel->scan, short_line, sizeof(short_line) - 1);
+		uint64_t long_ns = scan_line_time(kernel->scan, long_line, sizeof(long_line));
+		if (short_ns * 100 < memchr_short * (100 - SCAN_CALIBRATE_MARGIN)
+				&& long_ns * 100 < memchr_long * (100 - SCAN_CALIBRATE_MARGIN)
+				&& short_ns + long_ns < best){
+			scan_line = kernel->scan;
+			best = short_ns + long_ns;
+		}
+	}
+}
 
-		if (pid == 0){
-			
-			//Child closes listening socket
-			close(server_fd);
+//Byte range of a token inside the connection's input buffer. Offsets stay valid when the buffer is reallocated
+typedef struct{
+	size_t offset;
+	size_t len;
+} Slice;
 
-			int connection_status;
-			do{
-				// 5. Read data.
-				char buffer[1024] = {0};
-				int valread = read(client_socket, buffer, sizeof(buffer) - 1);
-				if (valread ==  0){
-					sem_post(semaphore);
-					close(client_socket);
-					exit(0);
-				}
-				else if (valread < 0){
-					perror("Read failed or empty request\n");
-					sem_post(semaphore);
-					close(client_socket);
-					exit(1);
-				}
+//Header struct 
+typedef struct{
+	Slice key;
+	Slice value;
+}Header;
 
-				buffer[valread] = '\0';
-				//printf("Received from client: %s\n", buffer);
+/*
+ * Headers the server acts on. The parser classifies each header name once and
+ * records these in fixed slots of HttpRequest, so handlers read them by index;
+ * every other header goes to the headers overflow list
+ */
+typedef enum{
+	HEADER_UNKNOWN = -1,
+	HEADER_HOST,
+	HEADER_CONNECTION,
+	HEADER_CONTENT_LENGTH,
+	HEADER_CONTENT_TYPE,
+	HEADER_TRANSFER_ENCODING,
+	HEADER_EXPECT,
+	HEADER_RANGE,
+	HEADER_IF_RANGE,
+	HEADER_IF_NONE_MATCH,
+	HEADER_IF_MODIFIED_SINCE,
+	HEADER_ACCEPT_ENCODING,
+	HEADER_USER_AGENT,
+	HEADER_REFERER,
+	HEADER_COUNT
+} HeaderId;
 
-				//Find request body before parsing
-				char *body_in_buffer = NULL;
-				int body_bytes_in_buffer = 0;
+const char *header_names[HEADER_COUNT] = {
+	"Host", "Connection", "Content-Length", "Content-Type", "Transfer-Encoding", "Expect", "Range",
+	"If-Range", "If-None-Match", "If-Modified-Since", "Accept-Encoding", "User-Agent", "Referer",
+};
 
-				char *body_start = strstr(buffer, "\r\n\r\n");
-				if (body_start != NULL){
-					body_start += 4;
-					body_bytes_in_buffer = valread - (body_start - buffer);
-					if (body_bytes_in_buffer > 0){
-						body_in_buffer = body_start;
-					}
-				}
+//Connection header tokens
+#define CONNECTION_CLOSE 1
+#define CONNECTION_KEEP_ALIVE 2
 
-				//6. Parse request header
-				HttpRequest client_request = {0};
-				char *request_line_end = strstr(buffer, "\r\n");
-				int parse_result = parse_client_request(buffer, &client_request, request_line_end);
-				if (parse_result != 0){
-					const char *bad_result = "HTTP/1.1 400 Bad Request\r\n\r\n";
-					sem_post(semaphore);
-					close(client_socket);
-					exit(0);
-				}
+//Where the resumable parser is within the current request
+typedef enum{
+	PARSE_REQUEST_LINE,
+	PARSE_HEADERS,
+	PARSE_BODY
+} ParseState;
 
-				char *conn_header = get_header_value(&client_request, "Connection");
+typedef enum{
+	PARSE_INCOMPLETE, // need more bytes
+	PARSE_COMPLETE,   // the head (or, for body_feed(), the body) has arrived, pointers below are valid
+	PARSE_FAILED      // malformed or over a limit, see error_status
+} ParseResult;
 
-				//Handle the method
-				int method_status = handle_method(client_socket, &client_request, body_in_buffer, body_bytes_in_buffer);
-				if (method_status != 0){
-					fprintf(stderr, "Request handling failed for client socket\n");
-				}
-				if (strcmp(client_request.method, "POST") == 0){
-					printf("POST completed, closing connection\n");
-					connection_status = 0;
-				}
-				else{
-					//Determine the connection
-					connection_status = connection_close_or_keep_alive(&client_request);
-				}
+//Where the body decoder is within a chunked body
+typedef enum{
+	CHUNK_SIZE, // hex size line, with optional extensions
+	CHUNK_DATA,
+	CHUNK_DATA_END, // CRLF after the data
+	CHUNK_TRAILER // trailer fields up to the blank line
+} ChunkState;
 
-				//Free HttpRequest data
-				free_http_request(&client_request);
+typedef struct BodyHandler BodyHandler;
 
-			}while(connection_status == 1);
+//Request methods, classified once while parsing so handlers switch on an integer
+typedef enum{
+	METHOD_OTHER, // unrecognised, also the state before the request line is parsed
+	METHOD_GET,
+	METHOD_HEAD,
+	METHOD_POST,
+	METHOD_PUT,
+	METHOD_DELETE,
+	METHOD_CONNECT,
+	METHOD_OPTIONS,
+	METHOD_TRACE,
+	METHOD_PATCH
+} HttpMethod;
 
-			//Release the slot
-			sem_post(semaphore);
+typedef struct{ //Ordered from largest to smallest for better cache alignment
+	Header *headers; // headers without a HeaderId, e.g. Keep-alive: yes, X-Request-Id: 7. Allocated from arena
+	Arena *arena; // the connection's, reset after every request
+	char *buffer; // connection buffer the slices point into
+	char *path; // /info.html
+	char *query_string; // ?pageNo=5
+	char *protocol; // HTTP/1.1
+	const BodyHandler *body_handler; // set by the method handler to receive the body, NULL discards it
+	void *body_context; // for the body handler, e.g. allocated from arena
+	Slice path_slice;
+	Slice query_slice;
+	Slice protocol_slice;
+	Slice known_headers[HEADER_COUNT]; // value of each well-known header, offset 0 when absent
+	size_t parse_pos; // first byte not yet scanned
+	size_t head_len; // request line + headers + blank line, set once the head is complete
+	long content_length; // body length, 0 when there is no body
+	size_t body_pos; // first body byte not yet decoded, relative to buffer
+	long body_remaining; // bytes left of the Content-Length body or of the current chunk
+	long body_received; // decoded body bytes so far
+	ParseState parse_state;
+	ChunkState chunk_state;
+	HttpMethod method_id; // method, classified
+	char method[8]; //GET, POST, etc
+	int header_count; // # of headers in the overflow list
+	int header_cap; // allocated entries in headers
+	int header_lines; // known and unknown, limited by max_headers
+	int connection; // CONNECTION_* flags from the Connection header
+	int chunked; // Transfer-Encoding: chunked
+	int expect_continue; // client waits for 100 Continue before sending the body
+	int dispatched; // head handed to handle_method, the body is being streamed
+	int error_status; // HTTP status to answer with when parsing failed
+} HttpRequest;
 
-			//Close client socket for child process
+#define CACHE_CONTROL_MAX 32
+
+//Cache-Control max-age sent with static files of one extension
+typedef struct{
+	char extension[16]; // without the dot, "*" for every extension without a rule
+	long max_age; // seconds
+} CacheControlRule;
+
+/*
+ * What a connection is waiting for, each with its own timeout: the rest of a
+ * request head (from its first byte, so trickling it in does not help), the next
+ * piece of a body, the next request on an idle keep-alive connection, or the
+ * client to accept more of a response
+ */
+typedef enum{
+	TIMEOUT_NONE,
+	TIMEOUT_HEADER,
+	TIMEOUT_BODY,
+	TIMEOUT_IDLE,
+	TIMEOUT_WRITE,
+	TIMEOUT_KINDS
+} TimeoutKind;
+
+//Listener options, limits enforced while reading requests and static file policy, configurable from the command line
+typedef struct{
+	int backlog; // listen() queue length
+	int defer_accept; // seconds TCP_DEFER_ACCEPT holds a connection back until its first bytes arrive, 0 for off
+	int fastopen; // TCP_FASTOPEN queue length, 0 for off
+	size_t max_head_size; // request line + headers
+	long max_body_size; // decoded request body
+	int max_headers;
+	int keep_alive_max; // requests served per connection before it is closed
+	long timeouts_ms[TIMEOUT_KINDS]; // by TimeoutKind
+	int cache_control_count;
+	CacheControlRule cache_control[CACHE_CONTROL_MAX];
+} ServerConfig;
+
+ServerConfig config = {
+	.backlog = SOMAXCONN,
+	.max_head_size = 65536,
+	.max_body_size = 16 * 1024 * 1024,
+	.max_headers = 100,
+	.keep_alive_max = 1000,
+	.timeouts_ms = { 0, 10000, 30000, 15000, 30000 }
+};
+
+//Serving modes. The event loop is the default, fork is the original process-per-connection model
+typedef enum{
+	MODE_EPOLL,
+	MODE_FORK,
+	MODE_URING // the event loop's request handling with io_uring doing the socket I/O
+} ServeMode;
+
+//Per-connection state machine used by the event loop
+typedef enum{
+	CONN_READING, // waiting for a complete request (headers + body)
+	CONN_WRITING, // responses queued, waiting for the socket to drain
+	CONN_CLOSING  // last response queued, close once it has drained
+} ConnState;
+
+//One queued piece of response: a range of conn->out or a range of an open file
+typedef struct{
+	char *map; // mapping used when the file cannot be sendfile()d
+	size_t map_len;
+	off_t offset; // next byte to send, into conn->out or into the file
+	off_t len; // bytes still to send
+	int file_fd; // -1 for bytes in conn->out
+	int owns_fd; // close file_fd when this segment is done (the last segment using it)
+	off_t warm_end; // with an I/O pool: file bytes before this are in the page cache
+	uint64_t serial; // tells this segment apart from later ones queued in the same slot
+} OutSegment;
+
+//What the io_uring loop knows about a connection's requests in the kernel
+typedef struct{
+	int ops; // submitted requests that have not posted their last completion
+	int sending; // requests of the current send chain still in flight
+	int send_failed;
+	int recv_armed; // the multishot recv is active
+	int recv_cancelled; // asked the kernel to stop it while the input buffer is full
+	int peer_closed;
+	int closing; // shut down, freed once ops reaches 0
+	int pipe[2]; // file segments are spliced through this pipe
+	int pipe_size; // 0 until the pipe has been created
+	off_t piped; // bytes of the head file segment already in the pipe
+} UringState;
+
+typedef struct Connection{
+	HttpRequest request; // request being parsed from in + in_start
+	Arena arena; // per-request allocations, reset once the response is queued
+	char *in; // bytes read from the socket but not yet consumed
+	char *out; // response bytes referenced by queued memory segments
+	OutSegment *segments; // responses waiting to be sent, in order
+	size_t in_start; // start of the current request in in
+	size_t in_len;
+	size_t in_cap;
+	size_t out_len;
+	size_t out_cap;
+	int segment_head; // first unsent segment
+	int segment_count;
+	int segment_cap;
+	uint64_t segment_serial; // serial of the last segment queued
+	int fd;
+	int nonblocking; // 1 when owned by the event loop, 0 for forked children
+	int batching; // 1 while pipelined requests are handled (always in io_uring mode), responses are queued and flushed together
+	int keep_alive;
+	int status; // status of the last response sent, for metrics and the access log
+	off_t response_bytes; // body bytes of the last response
+	uint64_t parse_ns; // time spent parsing the current request so far
+	uint64_t dispatch_ns; // when the current request's head was handed to handle_method
+	uint64_t waiting_since_ns; // fork mode: when the current timeout_kind wait began
+	ConnState state;
+	TimeoutKind timeout_kind; // what timer is armed for, TIMEOUT_NONE to re-arm on the next event
+	TimerNode timer; // event loop only
+	UringState uring; // io_uring mode only
+	IoJob *io_job; // event loop only: file work on the I/O pool this connection waits for
+	int requests; // requests completed on this connection
+	char peer[INET6_ADDRSTRLEN]; // client address for the access log
+} Connection;
+
+/*
+ * Receives a request body as it arrives, decoded and in pieces of at most
+ * BODY_CHUNK bytes. Returning non-zero from data abandons the request and closes
+ * the connection (send a response first). end is called once the whole body has
+ * arrived and sends the response. Both return 0 for success, 1 for failure
+ */
+struct BodyHandler{
+	int (*data)(Connection *conn, const char *data, size_t len);
+	int (*end)(Connection *conn);
+};
+
+//Semaphore global declaration
+sem_t *semaphore;
+
+//=====================METRICS==================
+/*
+ * Counters and latency histograms live in one MAP_SHARED mapping created before any
+ * fork, one cache line aligned slot per worker, so /metrics in any process can add
+ * up every worker without locks. A worker is the only writer of its slot and updates
+ * it with relaxed loads and stores; fork mode children share slot 0 and use atomic
+ * adds instead.
+ */
+#define METRICS_SLOTS 64 //Workers beyond this share slots
+#define METRICS_HIST_BUCKETS 48 //Two per power of two from 1us to 16s, slower goes in +Inf
+#define METRICS_METHODS 3
+#define METRICS_STATUSES 14
+
+typedef enum{
+	PHASE_PARSE, // reading the request line and headers, summed over partial reads
+	PHASE_OPEN,  // resolving and opening the file
+	PHASE_SEND,  // building and writing or queueing the response
+	PHASE_REQUEST, // handling the whole request once parsed
+	PHASE_COUNT
+} MetricsPhase;
+
+const char *metrics_phase_names[PHASE_COUNT] = { "parse", "open", "send", "request" };
+const char *metrics_method_names[METRICS_METHODS] = { "GET", "POST", "other" };
+//The last slot counts every other status
+const int metrics_statuses[METRICS_STATUSES - 1] = { 200, 206, 304, 400, 403, 404, 405, 408, 413, 416, 431, 500, 501 };
+
+typedef struct{
+	uint64_t buckets[METRICS_HIST_BUCKETS + 1]; // the last one is +Inf
+	uint64_t count;
+	uint64_t sum_ns;
+} MetricsHistogram;
+
+typedef struct{
+	uint64_t requests[METRICS_METHODS][METRICS_STATUSES];
+	uint64_t bytes_in;
+	uint64_t bytes_out;
+	uint64_t connections_total;
+	uint64_t active_connections; // gauge, wraps below zero in a slot but the sum is exact
+	uint64_t parse_failures;
+	uint64_t log_dropped; // access log lines lost because the ring was full
+	MetricsHistogram phases[PHASE_COUNT];
+} __attribute__((aligned(64))) WorkerMetrics;
+
+WorkerMetrics metrics_private; // used until metrics_init() maps the shared slots
+WorkerMetrics *metrics_shared;
+WorkerMetrics *metrics = &metrics_private; // this process's slot
+int metrics_atomic; // the slot is shared by several processes
+
+uint64_t monotonic_ns(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+void metrics_add(uint64_t *counter, uint64_t value){
+	if (metrics_atomic){
+		__atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+	}
+	else {
+		__atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+	}
+}
+
+//Bucket for a duration: 0-1us, 1-2us, then 2-3, 3-4, 4-6, 6-8, 8-12us...
+int metrics_bucket(uint64_t ns){
+	uint64_t us = ns / 1000;
+	if (us < 2){
+		return us;
+	}
+	int msb = 63 - __builtin_clzll(us);
+	int index = 2 * msb + ((us >> (msb - 1)) & 1);
+	return index < METRICS_HIST_BUCKETS ? index : METRICS_HIST_BUCKETS;
+}
+
+//Exclusive upper bound of a bucket in microseconds
+uint64_t metrics_bucket_bound(int index){
+	if (index < 2){
+		return index + 1;
+	}
+	return (uint64_t)(3 + (index & 1)) << (index / 2 - 1);
+}
+
+void metrics_observe(MetricsPhase phase, uint64_t ns){
+	MetricsHistogram *histogram = &metrics->phases[phase];
+	metrics_add(&histogram->buckets[metrics_bucket(ns)], 1);
+	metrics_add(&histogram->count, 1);
+	metrics_add(&histogram->sum_ns, ns);
+}
+
+void metrics_count_request(HttpMethod method, int status){
+	int method_index = method == METHOD_GET ? 0 : method == METHOD_POST ? 1 : METRICS_METHODS - 1;
+	int status_index = METRICS_STATUSES - 1;
+	for (int i = 0; i < METRICS_STATUSES - 1; i++){
+		if (metrics_statuses[i] == status){
+			status_index = i;
+			break;
+		}
+	}
+	metrics_add(&metrics->requests[method_index][status_index], 1);
+}
+
+//Map the shared slots. Must run before any worker or child is forked. Returns 0 for success, 1 for failure
+int metrics_init(int shared_by_children){
+	metrics_shared = mmap(NULL, METRICS_SLOTS * sizeof(WorkerMetrics), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (metrics_shared == MAP_FAILED){
+		perror("Metrics memory mapping failed\n");
+		metrics_shared = NULL;
+		return 1;
+	}
+	metrics = &metrics_shared[0];
+	metrics_atomic = shared_by_children;
+	return 0;
+}
+
+//Called in a freshly forked worker. A respawned worker takes over its predecessor's counters
+void metrics_use_slot(int index){
+	if (metrics_shared == NULL){
+		return;
+	}
+	metrics = &metrics_shared[index % METRICS_SLOTS];
+	metrics_atomic = index >= METRICS_SLOTS;
+	//Connections of a worker that died are gone
+	__atomic_store_n(&metrics->active_connections, 0, __ATOMIC_RELAXED);
+}
+
+//=====================LOGGING==================
+/*
+ * Diagnostic output, compiled out unless built with -DLOG_VERBOSITY=1 (requests and
+ * connections) or 2 (bodies and child processes too), so release builds pay nothing
+ */
+#ifndef LOG_VERBOSITY
+#define LOG_VERBOSITY 0
+#endif
+#define DEBUG_LOG(level, ...) do { if (LOG_VERBOSITY >= (level)) fprintf(stderr, __VA_ARGS__); } while (0)
+
+/*
+ * Access log. The serving thread formats each line into a per-process ring buffer
+ * without any syscall and a background thread writes whatever has accumulated in one
+ * write() every ACCESS_LOG_FLUSH_MS. The ring has a single producer and a single
+ * consumer, so head and tail are the only shared state. Lines that do not fit are
+ * dropped and counted rather than blocking the event loop
+ */
+#define ACCESS_LOG_RING (1 << 20)
+#define ACCESS_LOG_FLUSH_MS 100
+#define ACCESS_LOG_LINE 4096
+
+typedef enum{
+	LOG_COMMON,   // NCSA common log format
+	LOG_COMBINED, // common plus Referer and User-Agent
+	LOG_JSON      // one JSON object per line
+} AccessLogFormat;
+
+typedef struct{
+	char *ring;
+	uint64_t head; // bytes produced, advanced by the serving thread
+	uint64_t tail; // bytes written out, advanced by the writer thread
+	uint64_t requests; // for sampling
+	pthread_t writer;
+	AccessLogFormat format;
+	int sample; // log one request in sample, server errors always
+	int fd; // -1 when disabled
+	int running; // writer thread started and not asked to stop
+	time_t clock_second; // second the cached timestamps are for
+	char clock_common[32]; // 10/Oct/2000:13:55:36 +0000
+	char clock_iso[32]; // 2000-10-10T13:55:36+0000
+} AccessLog;
+
+AccessLog access_log = { .fd = -1, .sample = 1 };
+
+//Write everything the serving thread has published
+void access_log_drain(void){
+	uint64_t head = __atomic_load_n(&access_log.head, __ATOMIC_ACQUIRE);
+	uint64_t tail = access_log.tail;
+	while (tail < head){
+		size_t start = tail % ACCESS_LOG_RING;
+		size_t chunk = head - tail < ACCESS_LOG_RING - start ? head - tail : ACCESS_LOG_RING - start;
+		ssize_t written = write(access_log.fd, access_log.ring + start, chunk);
+		if (written < 0 && errno == EINTR) continue;
+		if (written <= 0){
+			//Nowhere to write: discard rather than wedge the ring
+			tail = head;
+			break;
+		}
+		tail += written;
+	}
+	__atomic_store_n(&access_log.tail, tail, __ATOMIC_RELEASE);
+}
+
+void *access_log_writer(void *arg){
+	(void)arg;
+	struct timespec interval = { 0, ACCESS_LOG_FLUSH_MS * 1000000L };
+	while (__atomic_load_n(&access_log.running, __ATOMIC_ACQUIRE)){
+		nanosleep(&interval, NULL);
+		access_log_drain();
+	}
+	access_log_drain();
+	return NULL;
+}
+
+//Start the writer thread in the process that serves requests. Returns 0 for success, 1 for failure
+int access_log_start(void){
+	if (access_log.fd < 0 || access_log.running){
+		return 0;
+	}
+	if (access_log.ring == NULL){
+		access_log.ring = malloc(ACCESS_LOG_RING);
+		if (access_log.ring == NULL){
+			perror("Memory allocation failed\n");
+			return 1;
+		}
+	}
+	access_log.running = 1;
+	if (pthread_create(&access_log.writer, NULL, access_log_writer, NULL) != 0){
+		perror("Access log writer failed to start\n");
+		access_log.running = 0;
+		return 1;
+	}
+	return 0;
+}
+
+//Stop the writer thread after it has written everything logged so far
+void access_log_stop(void){
+	if (!access_log.running){
+		return;
+	}
+	__atomic_store_n(&access_log.running, 0, __ATOMIC_RELEASE);
+	pthread_join(access_log.writer, NULL);
+}
+
+//Reformat the cached timestamps only when the second changes
+void access_log_clock(void){
+	time_t now = time(NULL);
+	if (now == access_log.clock_second){
+		return;
+	}
+	struct tm tm;
+	localtime_r(&now, &tm);
+	strftime(access_log.clock_common, sizeof(access_log.clock_common), "%d/%b/%Y:%H:%M:%S %z", &tm);
+	strftime(access_log.clock_iso, sizeof(access_log.clock_iso), "%Y-%m-%dT%H:%M:%S%z", &tm);
+	access_log.clock_second = now;
+}
+
+//A log line being built on the stack
+typedef struct{
+	char data[ACCESS_LOG_LINE];
+	size_t len;
+} LogLine;
+
+void log_printf(LogLine *line, const char *format, ...){
+	size_t space = sizeof(line->data) - line->len;
+	va_list args;
+	va_start(args, format);
+	int written = vsnprintf(line->data + line->len, space, format, args);
+	va_end(args);
+	if (written > 0){
+		line->len += (size_t)written < space ? (size_t)written : space - 1;
+	}
+}
+
+//Append text, "-" when NULL, escaping quotes, backslashes and control bytes for the format
+void log_escaped(LogLine *line, const char *text, int json){
+	if (text == NULL){
+		text = json ? "" : "-";
+	}
+	for (const unsigned char *p = (const unsigned char *)text; *p; p++){
+		if (sizeof(line->data) - line->len < 8){
+			break;
+		}
+		if (*p == '"' || *p == '\\'){
+			line->data[line->len++] = '\\';
+			line->data[line->len++] = *p;
+		}
+		else if (*p < 0x20 || *p == 0x7f){
+			line->len += snprintf(line->data + line->len, 8, json ? "\\u%04x" : "\\x%02x", *p);
+		}
+		else {
+			line->data[line->len++] = *p;
+		}
+	}
+}
+
+//Copy a finished line into the ring, or count it as dropped if the writer is behind
+void access_log_push(LogLine *line){
+	uint64_t tail = __atomic_load_n(&access_log.tail, __ATOMIC_ACQUIRE);
+	if (access_log.head + line->len - tail > ACCESS_LOG_RING){
+		metrics_add(&metrics->log_dropped, 1);
+		return;
+	}
+	size_t start = access_log.head % ACCESS_LOG_RING;
+	size_t first = line->len < ACCESS_LOG_RING - start ? line->len : ACCESS_LOG_RING - start;
+	memcpy(access_log.ring + start, line->data, first);
+	memcpy(access_log.ring, line->data + first, line->len - first);
+	__atomic_store_n(&access_log.head, access_log.head + line->len, __ATOMIC_RELEASE);
+}
+
+//Point path, protocol, body etc. at the buffer. Only valid until the buffer is reallocated
+void request_bind(HttpRequest *request, char *buffer){
+	request->buffer = buffer;
+	request->path = buffer + request->path_slice.offset;
+	request->query_string = request->query_slice.len > 0 ? buffer + request->query_slice.offset : NULL;
+	request->protocol = buffer + request->protocol_slice.offset;
+}
+
+//Forget the current request but keep the header storage for the next one
+void request_reset(HttpRequest *request){
+	Arena *arena = request->arena;
+	memset(request, 0, sizeof(*request));
+	request->arena = arena;
+}
+
+ParseResult parse_failed(HttpRequest *request, int status, const char *reason){
+	DEBUG_LOG(1, "%s\n", reason);
+	request->error_status = status;
+	return PARSE_FAILED;
+}
+
+//Classify a method token by length, then by its bytes
+HttpMethod parse_method(const char *token, size_t len){
+	switch (len){
+		case 3:
+			if (memcmp(token, "GET", 3) == 0) return METHOD_GET;
+			if (memcmp(token, "PUT", 3) == 0) return METHOD_PUT;
+			break;
+		case 4:
+			if (memcmp(token, "POST", 4) == 0) return METHOD_POST;
+			if (memcmp(token, "HEAD", 4) == 0) return METHOD_HEAD;
+			break;
+		case 5:
+			if (memcmp(token, "PATCH", 5) == 0) return METHOD_PATCH;
+			if (memcmp(token, "TRACE", 5) == 0) return METHOD_TRACE;
+			break;
+		case 6:
+			if (memcmp(token, "DELETE", 6) == 0) return METHOD_DELETE;
+			break;
+		case 7:
+			if (memcmp(token, "OPTIONS", 7) == 0) return METHOD_OPTIONS;
+			if (memcmp(token, "CONNECT", 7) == 0) return METHOD_CONNECT;
+			break;
+	}
+	return METHOD_OTHER;
+}
+
+//METHOD SP TARGET SP PROTOCOL, already null terminated at end. question_mark is the line's first '?', if any
+ParseResult parse_request_line(HttpRequest *request, char *buffer, size_t start, size_t end, char *question_mark){
+	//2. Fetch the HTTP Method
+	char *line = buffer + start;
+	char *method_end = memchr(line, ' ', end - start);
+	if (method_end == NULL || method_end == line){
+		return parse_failed(request, 400, "Request line not found");
+	}
+	*method_end = '\0';
+	request->method_id = parse_method(line, method_end - line);
+	/*
+	 * Copy (at most) sizeof(request->method) - 1 characters 
+	 * from the request line into the request->method, 
+	 * then manually set the null terminator
+	 */
+	strncpy(request->method, line, sizeof(request->method) - 1);
+	request->method[sizeof(request->method) - 1] = '\0';
+
+	//3. Fetch the path and query string
+	char *path_token = method_end + 1;
+	char *path_end = memchr(path_token, ' ', buffer + end - path_token);
+	if (path_end == NULL || path_end == path_token){
+		return parse_failed(request, 400, "Path not found");
+	}
+
+	//Control bytes (NUL above all, which would cut the path short) never belong in a target
+	for (char *c = path_token; c < path_end; c++){
+		if ((unsigned char)*c < 0x20 || *c == 0x7f){
+			return parse_failed(request, 400, "Control character in request target");
+		}
+	}
+	*path_end = '\0';
+
+	/*
+	 * Check if path contains query. If it does, record it as the query string
+	 * and terminate the path at the question mark. The line's first '?' is the
+	 * path's unless the method had one
+	 */
+	if (question_mark != NULL && question_mark < path_token){
+		question_mark = memchr(path_token, '?', path_end - path_token);
+	}
+	else if (question_mark > path_end){
+		question_mark = NULL;
+	}
+	char *path_stop = question_mark != NULL ? question_mark : path_end;
+	request->path_slice.offset = path_token - buffer;
+	request->path_slice.len = path_stop - path_token;
+	if (question_mark != NULL){
+		*question_mark = '\0';
+		request->query_slice.offset = question_mark + 1 - buffer;
+		request->query_slice.len = path_end - (question_mark + 1);
+	}
+
+	//4. Fetch the protocol
+	char *protocol_token = path_end + 1;
+	if (buffer + end - protocol_token < 5 || strncmp(protocol_token, "HTTP/", 5) != 0){
+		return parse_failed(request, 400, "Protocol Not Found");
+	}
+	request->protocol_slice.offset = protocol_token - buffer;
+	request->protocol_slice.len = buffer + end - protocol_token;
+	return PARSE_INCOMPLETE;
+}
+
+//Classify a header name by length and first letter, then confirm with one comparison
+HeaderId header_id(const char *name, size_t len){
+	HeaderId id;
+	char first = tolower((unsigned char)name[0]);
+	switch (len){
+		case 4: id = HEADER_HOST; break;
+		case 5: id = HEADER_RANGE; break;
+		case 6: id = HEADER_EXPECT; break;
+		case 7: id = HEADER_REFERER; break;
+		case 8: id = HEADER_IF_RANGE; break;
+		case 10: id = first == 'c' ? HEADER_CONNECTION : HEADER_USER_AGENT; break;
+		case 12: id = HEADER_CONTENT_TYPE; break;
+		case 13: id = HEADER_IF_NONE_MATCH; break;
+		case 14: id = HEADER_CONTENT_LENGTH; break;
+		case 15: id = HEADER_ACCEPT_ENCODING; break;
+		case 17: id = first == 't' ? HEADER_TRANSFER_ENCODING : HEADER_IF_MODIFIED_SINCE; break;
+		default: return HEADER_UNKNOWN;
+	}
+	return strncasecmp(name, header_names[id], len) == 0 ? id : HEADER_UNKNOWN;
+}
+
+//CONNECTION_* flags for a comma separated Connection value such as "keep-alive, Upgrade"
+int parse_connection_tokens(const char *value){
+	int flags = 0;
+	while (*value != '\0'){
+		while (*value == ' ' || *value == '\t' || *value == ','){
+			value++;
+		}
+		size_t len = strcspn(value, ", \t");
+		if (len == 5 && strncasecmp(value, "close", 5) == 0) flags |= CONNECTION_CLOSE;
+		else if (len == 10 && strncasecmp(value, "keep-alive", 10) == 0) flags |= CONNECTION_KEEP_ALIVE;
+		value += len;
+	}
+	return flags;
+}
+
+//NAME ":" OWS VALUE OWS, already null terminated at end. colon is the line's first ':', if any
+ParseResult parse_header_line(HttpRequest *request, char *buffer, size_t start, size_t end, char *colon){
+	//RFC 9112 section 5.2: obs-fold continues the previous header, which this parser does not join
+	char *line = buffer + start;
+	if (line[0] == ' ' || line[0] == '\t'){
+		return parse_failed(request, 400, "Obsolete line folding");
+	}
+	if (colon == NULL || colon == line){
+		return parse_failed(request, 400, "Malformed header line");
+	}
+
+	if (request->header_lines++ >= config.max_headers){
+		return parse_failed(request, 431, "Too many request headers");
+	}
+
+	//RFC 9112 section 5.1: no whitespace between the name and the colon, a proxy may read the name differently
+	if (colon[-1] == ' ' || colon[-1] == '\t'){
+		return parse_failed(request, 400, "Whitespace before header colon");
+	}
+
+	//Separate header key and value based on the colon 
+	*colon = '\0';
+	char *value = colon + 1;
+	char *value_end = buffer + end;
+
+	//Ensure whitespaces e.g. "Host: localhost" are eliminated on both sides
+	while (value < value_end && (*value == ' ' || *value == '\t')){
+		value++;
+	}
+	while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t')){
+		value_end--;
+	}
+	*value_end = '\0';
+
+	//Well-known headers go to their slot, with numeric and token values decoded now
+	HeaderId id = header_id(line, colon - line);
+	if (id != HEADER_UNKNOWN){
+		Slice *slot = &request->known_headers[id];
+		if (id == HEADER_CONTENT_LENGTH){
+			//1*DIGIT only: strtol() would also take a sign or leading whitespace, which a proxy may frame differently
+			long content_length = 0;
+			if (value == value_end){
+				return parse_failed(request, 400, "Invalid content length");
+			}
+			for (char *digit = value; digit < value_end; digit++){
+				if (*digit < '0' || *digit > '9' || content_length > (LONG_MAX - (*digit - '0')) / 10){
+					return parse_failed(request, 400, "Invalid content length");
+				}
+				content_length = content_length * 10 + (*digit - '0');
+			}
+			//Conflicting lengths would let a proxy and this server disagree on where the request ends
+			if (slot->offset != 0 && content_length != request->content_length){
+				return parse_failed(request, 400, "Conflicting content lengths");
+			}
+			request->content_length = content_length;
+		}
+		else if (id == HEADER_CONNECTION){
+			request->connection |= parse_connection_tokens(value);
+		}
+		//Only the first would be looked at, while a proxy may go by the other
+		else if (id == HEADER_TRANSFER_ENCODING && slot->offset != 0){
+			return parse_failed(request, 400, "Repeated Transfer-Encoding");
+		}
+		if (slot->offset == 0){
+			slot->offset = value - buffer;
+			slot->len = value_end - value;
+		}
+		return PARSE_INCOMPLETE;
+	}
+
+	if (request->header_count == request->header_cap){
+		//Grow in the arena, the old array is reclaimed with everything else after the request
+		int new_cap = request->header_cap ? request->header_cap * 2 : 16;
+		Header *new_headers = arena_alloc(request->arena, new_cap * sizeof(Header));
+		if (new_headers == NULL){
+			return parse_failed(request, 500, "Memory allocation failed for header");
+		}
+		if (request->header_count > 0){
+			memcpy(new_headers, request->headers, request->header_count * sizeof(Header));
+		}
+		request->headers = new_headers;
+		request->header_cap = new_cap;
+	}
+
+	Header *header = &request->headers[request->header_count++];
+	header->key.offset = start;
+	header->key.len = colon - line;
+	header->value.offset = value - buffer;
+	header->value.len = value_end - value;
+	return PARSE_INCOMPLETE;
+}
+
+//Work out how the body is framed once the head is complete
+ParseResult parse_body_length(HttpRequest *request, char *buffer){
+	Slice *transfer_encoding = &request->known_headers[HEADER_TRANSFER_ENCODING];
+	if (transfer_encoding->offset != 0){
+		//chunked must be the final coding, and the only one since nothing else is decoded
+		if (strcasecmp(buffer + transfer_encoding->offset, "chunked") != 0){
+			return parse_failed(request, 501, "Transfer-Encoding is not supported");
+		}
+		//Both framings at once is how requests are smuggled past proxies
+		if (request->known_headers[HEADER_CONTENT_LENGTH].offset != 0){
+			return parse_failed(request, 400, "Content-Length with Transfer-Encoding");
+		}
+		request->chunked = 1;
+		request->chunk_state = CHUNK_SIZE;
+	}
+	request->body_pos = request->head_len;
+	request->body_remaining = request->content_length;
+	return PARSE_INCOMPLETE;
+}
+
+/*
+ * Resumable request parser. Each call scans only the bytes of buffer[0..len) it has not
+ * seen yet, so a request may arrive split across any number of reads. Lines are
+ * terminated in place and recorded as slices of the buffer, nothing is copied.
+ * Returns PARSE_COMPLETE once the head and the whole body are in the buffer
+ */
+ParseResult parse_client_request(HttpRequest *request, char *buffer, size_t len){
+	while (request->parse_state != PARSE_BODY){
+		//1. Find the end of the next line and, in the same pass, the '?' of the request line or a header's colon
+		size_t line_start = request->parse_pos;
+		const char *mark;
+		const char *newline = scan_line(buffer + line_start, buffer + len, request->parse_state == PARSE_REQUEST_LINE ? '?' : ':', &mark);
+		if (newline == NULL){
+			if (len > config.max_head_size){
+				return parse_failed(request, 431, "Request head too large");
+			}
+			return PARSE_INCOMPLETE; //resume from line_start once more bytes arrive
+		}
+
+		size_t line_end = newline - buffer;
+		if (line_end + 1 > config.max_head_size){
+			return parse_failed(request, 431, "Request head too large");
+		}
+		request->parse_pos = line_end + 1;
+
+		//Accept bare \n as well as \r\n
+		if (line_end > line_start && buffer[line_end - 1] == '\r'){
+			line_end--;
+		}
+		buffer[line_end] = '\0';
+
+		ParseResult result;
+		if (request->parse_state == PARSE_REQUEST_LINE){
+			if (line_end == line_start && request->header_count == 0 && request->method[0] == '\0'){
+				continue; //Ignore blank lines before the request line
+			}
+			result = parse_request_line(request, buffer, line_start, line_end, (char *)mark);
+			request->parse_state = PARSE_HEADERS;
+		}
+		else if (line_end == line_start){
+			//5. Blank line: end of the headers
+			request->head_len = request->parse_pos;
+			result = parse_body_length(request, buffer);
+			request->parse_state = PARSE_BODY;
+		}
+		else {
+			result = parse_header_line(request, buffer, line_start, line_end, (char *)mark);
+		}
+		if (result == PARSE_FAILED){
+			return PARSE_FAILED;
+		}
+	}
+
+	//6. The body is streamed separately by body_feed()
+	request_bind(request, buffer);
+	return PARSE_COMPLETE;
+}
+
+//Hex chunk size at the start of line, up to ';' or the line end. -1 if malformed or too large
+long parse_chunk_size(const char *line, const char *line_end){
+	long size = 0;
+	const char *c = line;
+	for (; c < line_end && isxdigit((unsigned char)*c); c++){
+		if (size > (LONG_MAX >> 4)){
+			return -1;
+		}
+		size = size * 16 + (isdigit((unsigned char)*c) ? *c - '0' : (tolower((unsigned char)*c) - 'a' + 10));
+	}
+	if (c == line){
+		return -1;
+	}
+	while (c < line_end && (*c == ' ' || *c == '\t')){
+		c++;
+	}
+	return c == line_end || *c == ';' ? size : -1;
+}
+
+/*
+ * Decode whatever part of the body is in buffer[body_pos, len), passing it to
+ * handler in pieces of at most BODY_CHUNK bytes. Returns PARSE_COMPLETE with
+ * body_pos just past the body, PARSE_INCOMPLETE to wait for more bytes, or
+ * PARSE_FAILED with error_status set (0 when the handler gave up)
+ */
+ParseResult body_feed(Connection *conn, HttpRequest *request, char *buffer, size_t len){
+	while (1){
+		size_t available = len - request->body_pos;
+		char *data = buffer + request->body_pos;
+
+		//1. Data: Content-Length bodies are one long chunk
+		if (!request->chunked || request->chunk_state == CHUNK_DATA){
+			if (request->body_remaining == 0){
+				if (!request->chunked){
+					return PARSE_COMPLETE;
+				}
+				request->chunk_state = CHUNK_DATA_END;
+				continue;
+			}
+			size_t piece = available < (size_t)request->body_remaining ? available : (size_t)request->body_remaining;
+			if (piece > BODY_CHUNK){
+				piece = BODY_CHUNK;
+			}
+			if (piece == 0){
+				return PARSE_INCOMPLETE;
+			}
+			if (request->body_handler != NULL && request->body_handler->data(conn, data, piece) != 0){
+				request->error_status = 0;
+				return PARSE_FAILED;
+			}
+			request->body_pos += piece;
+			request->body_remaining -= piece;
+			request->body_received += piece;
+			continue;
+		}
+
+		//2. Framing lines. The data end is a bare CRLF, the others are whole lines
+		if (request->chunk_state == CHUNK_DATA_END){
+			if (available < 2){
+				if (available == 1 && data[0] == '\n'){
+					request->body_pos++;
+					request->chunk_state = CHUNK_SIZE;
+					continue;
+				}
+				if (available == 1 && data[0] != '\r'){
+					return parse_failed(request, 400, "Chunk data not followed by CRLF");
+				}
+				return PARSE_INCOMPLETE;
+			}
+			size_t crlf = data[0] == '\n' ? 1 : (data[0] == '\r' && data[1] == '\n') ? 2 : 0;
+			if (crlf == 0){
+				return parse_failed(request, 400, "Chunk data not followed by CRLF");
+			}
+			request->body_pos += crlf;
+			request->chunk_state = CHUNK_SIZE;
+			continue;
+		}
+		char *newline = memchr(data, '\n', available);
+		if (newline == NULL){
+			//Size lines are short, trailers are bounded like the head
+			if (available > (request->chunk_state == CHUNK_SIZE ? 1024 : config.max_head_size)){
+				return parse_failed(request, 400, "Chunk line too long");
+			}
+			return PARSE_INCOMPLETE;
+		}
+		char *line_end = newline > data && newline[-1] == '\r' ? newline - 1 : newline;
+		request->body_pos += newline + 1 - data;
+
+		if (request->chunk_state == CHUNK_SIZE){
+			long size = parse_chunk_size(data, line_end);
+			if (size < 0){
+				return parse_failed(request, 400, "Invalid chunk size");
+			}
+			if (size > config.max_body_size - request->body_received){
+				return parse_failed(request, 413, "Request body too large");
+			}
+			request->body_remaining = size;
+			request->chunk_state = size > 0 ? CHUNK_DATA : CHUNK_TRAILER;
+		}
+		else if (line_end == data){
+			return PARSE_COMPLETE; //Blank line ends the trailers
+		}
+	}
+}
+
+//Value of a well-known header, NULL if the request does not have it
+char *header_value(HttpRequest *request, HeaderId id){
+	Slice *slot = &request->known_headers[id];
+	return slot->offset != 0 ? request->buffer + slot->offset : NULL;
+}
+
+//Value of any header by exact, case-insensitive name
+char *get_header_value(HttpRequest *request, char *name){
+	size_t name_len = strlen(name);
+	HeaderId id = header_id(name, name_len);
+	if (id != HEADER_UNKNOWN){
+		return header_value(request, id);
+	}
+	for (int i = 0; i < request->header_count; i++){
+		Header *header = &request->headers[i];
+		if (header->key.len == name_len && strncasecmp(request->buffer + header->key.offset, name, name_len) == 0){
+			return request->buffer + header->value.offset;
+		}
+	}
+	return NULL;
+}
+
+//Function to handle connection status. Returns 0 (close) or 1 (keep alive)
+int connection_close_or_keep_alive(HttpRequest *client_request){
+	int keep_alive = 0; /* Initialize keep alive to be 0 */
+	
+	//Connection tokens were decoded by the parser
+	int connection = client_request->connection;
+
+	//Get the request's protocol. HTTP/1.0 deafult = close. HTTP/1.1 default = keep-alive.
+	char *protocol = client_request->protocol;
+	if (strcmp (protocol, "HTTP/1.0") == 0){
+		if ((connection & CONNECTION_KEEP_ALIVE) && !(connection & CONNECTION_CLOSE)) {
+			keep_alive = 1;
+		} else {
+			keep_alive = 0;
+		}
+	} else if(strcmp (protocol, "HTTP/1.1") == 0){
+		if (connection & CONNECTION_CLOSE){
+			keep_alive = 0;
+		} else {
+			keep_alive = 1;
+		}
+
+	} else {
+		keep_alive = 0;
+
+	}
+
+	return keep_alive;
+}
+
+//1 while response bytes or files are still queued
+int conn_pending(Connection *conn){
+	return conn->segment_head < conn->segment_count;
+}
+
+//Reserve a new segment at the back of the queue
+OutSegment *conn_push_segment(Connection *conn){
+	if (conn->segment_count == conn->segment_cap){
+		int new_cap = conn->segment_cap ? conn->segment_cap * 2 : 8;
+		OutSegment *new_segments = realloc(conn->segments, new_cap * sizeof(OutSegment));
+		if (new_segments == NULL){
+			perror("Memory allocation failed\n");
+			return NULL;
+		}
+		conn->segments = new_segments;
+		conn->segment_cap = new_cap;
+	}
+	OutSegment *segment = &conn->segments[conn->segment_count++];
+	memset(segment, 0, sizeof(*segment));
+	segment->file_fd = -1;
+	segment->serial = ++conn->segment_serial;
+	return segment;
+}
+
+//Copy bytes to conn->out and queue them after everything already queued
+int conn_queue(Connection *conn, const char *data, size_t len){
+	if (conn->out_len + len > conn->out_cap){
+		size_t new_cap = conn->out_cap ? conn->out_cap : READ_CHUNK;
+		while (new_cap < conn->out_len + len){
+			new_cap *= 2;
+		}
+		char *new_out = realloc(conn->out, new_cap);
+		if (new_out == NULL){
+			perror("Memory allocation failed\n");
+			return 1;
+		}
+		conn->out = new_out;
+		conn->out_cap = new_cap;
+	}
+	memcpy(conn->out + conn->out_len, data, len);
+
+	//Grow the last segment if it ends where these bytes start
+	OutSegment *last = conn_pending(conn) ? &conn->segments[conn->segment_count - 1] : NULL;
+	if (last == NULL || last->file_fd >= 0 || (size_t)(last->offset + last->len) != conn->out_len){
+		last = conn_push_segment(conn);
+		if (last == NULL){
+			return 1;
+		}
+		last->offset = conn->out_len;
+	}
+	last->len += len;
+	conn->out_len += len;
+	return 0;
+}
+
+//Close the file, if any, held by a segment
+void conn_release_segment(OutSegment *segment){
+	if (segment->map != NULL){
+		munmap(segment->map, segment->map_len);
+		segment->map = NULL;
+	}
+	if (segment->file_fd >= 0 && segment->owns_fd){
+		close(segment->file_fd);
+	}
+	segment->file_fd = -1;
+}
+
+//Drop everything still queued
+void conn_discard_output(Connection *conn){
+	for (int i = conn->segment_head; i < conn->segment_count; i++){
+		conn_release_segment(&conn->segments[i]);
+	}
+	conn->segment_head = conn->segment_count = 0;
+	conn->out_len = 0;
+}
+
+//1 if file work for conn should go to the I/O pool: this process has threads and conn belongs to the event loop
+int io_pool_enabled(Connection *conn){
+	return io_pool.thread_count > 0 && conn->nonblocking && conn->io_job == NULL;
+}
+
+/*
+ * sendfile() on a file that is not in the page cache waits for the disk inside the
+ * loop. With an I/O pool, large file segments are read into the page cache on a pool
+ * thread one IO_WARM_WINDOW ahead of what is sent, and sendfile() only goes as far as
+ * has been read
+ */
+#define IO_WARM_MIN (64 * 1024) //Smaller segments are sent without warming
+#define IO_WARM_WINDOW (1024 * 1024)
+#define IO_WARM_CHUNK (64 * 1024) //pread() size when a window is not in the page cache yet
+
+typedef struct{
+	IoJob job;
+	int fd; // duplicate of the segment's file, owned
+	off_t offset;
+	off_t len;
+	int segment; // index into conn->segments
+	uint64_t serial; // the segment's serial, to recognise it on completion
+} FileWarmJob;
+
+/*
+ * Read the window into the page cache. mincore() on a mapping that is never touched
+ * says whether it is all there already; otherwise it is read into a scratch buffer,
+ * since faulting a MAP_SHARED mapping in would raise SIGBUS if the file has shrunk.
+ * A short read just ends the warm early and sendfile() finds the file shrank
+ */
+void file_warm_run(IoJob *job){
+	FileWarmJob *warm = (FileWarmJob *)job;
+	long page_size = sysconf(_SC_PAGESIZE);
+	off_t start = warm->offset & ~(off_t)(page_size - 1);
+	size_t len = warm->offset + warm->len - start;
+	unsigned char *map = mmap(NULL, len, PROT_READ, MAP_SHARED, warm->fd, start);
+	if (map == MAP_FAILED){
+		return;
+	}
+
+	//Usually it is all there already
+	size_t pages = (len + page_size - 1) / page_size;
+	unsigned char resident[IO_WARM_WINDOW / 4096 + 2];
+	int cold = pages > sizeof(resident) || mincore(map, len, resident) != 0;
+	for (size_t i = 0; !cold && i < pages; i++){
+		cold = !(resident[i] & 1);
+	}
+	munmap(map, len);
+	if (cold){
+		char scratch[IO_WARM_CHUNK];
+		posix_fadvise(warm->fd, warm->offset, warm->len, POSIX_FADV_WILLNEED);
+		for (off_t done = 0; done < warm->len; ){
+			size_t chunk = warm->len - done < IO_WARM_CHUNK ? warm->len - done : IO_WARM_CHUNK;
+			ssize_t bytes_read = pread(warm->fd, scratch, chunk, warm->offset + done);
+			if (bytes_read <= 0){
+				break;
+			}
+			done += bytes_read;
+		}
+	}
+}
+
+void file_warm_complete(IoJob *job){
+	FileWarmJob *warm = (FileWarmJob *)job;
+	Connection *conn = job->conn;
+	if (conn != NULL){
+		conn->io_job = NULL;
+		//The slot may have been sent, released and reused by another segment meanwhile
+		if (warm->segment >= conn->segment_head && warm->segment < conn->segment_count
+				&& conn->segments[warm->segment].serial == warm->serial){
+			conn->segments[warm->segment].warm_end = warm->offset + warm->len;
+		}
+	}
+	close(warm->fd);
+	free(warm);
+}
+
+//Bytes of a file segment sendfile() may send now, starting the next read ahead when none is running. 0 while waiting for one
+off_t file_segment_sendable(Connection *conn, OutSegment *segment){
+	off_t end = segment->offset + segment->len;
+	if (io_pool.thread_count == 0 || !conn->nonblocking || segment->len < IO_WARM_MIN || segment->warm_end >= end){
+		return segment->len;
+	}
+	if (segment->warm_end < segment->offset){
+		segment->warm_end = segment->offset;
+	}
+
+	//Read ahead only one window past what has been sent, however slowly the client reads
+	if (segment->warm_end - segment->offset < IO_WARM_WINDOW && io_pool_enabled(conn)){
+		FileWarmJob *warm = calloc(1, sizeof(FileWarmJob));
+		if (warm != NULL){
+			warm->fd = fcntl(segment->file_fd, F_DUPFD_CLOEXEC, 0);
+		}
+		if (warm == NULL || warm->fd < 0){
+			//Send it cold rather than not at all
+			free(warm);
+			segment->warm_end = end;
+			return segment->len;
+		}
+		warm->job.run = file_warm_run;
+		warm->job.complete = file_warm_complete;
+		warm->job.conn = conn;
+		warm->offset = segment->warm_end;
+		warm->len = end - warm->offset < IO_WARM_WINDOW ? end - warm->offset : IO_WARM_WINDOW;
+		warm->segment = segment - conn->segments;
+		warm->serial = segment->serial;
+		if (io_pool_submit(&warm->job) != 0){
+			close(warm->fd);
+			free(warm);
+			segment->warm_end = end;
+			return segment->len;
+		}
+		conn->io_job = &warm->job;
+	}
+	return segment->warm_end - segment->offset;
+}
+
+/*
+ * Stream a file segment straight from the page cache to the socket with sendfile().
+ * Files sendfile() refuses are mapped read-only and written from the mapping instead,
+ * so neither path copies the file into the heap. Returns 0 when the segment is done,
+ * 1 on error and 2 when a non-blocking socket is full or the I/O pool is still
+ * reading the next part of the file
+ */
+int conn_flush_file(Connection *conn, OutSegment *segment){
+	while (segment->len > 0){
+		ssize_t bytes_sent;
+		if (segment->map == NULL){
+			off_t sendable = file_segment_sendable(conn, segment);
+			if (sendable == 0) return 2;
+			bytes_sent = sendfile(conn->fd, segment->file_fd, &segment->offset, sendable);
+			if (bytes_sent < 0 && (errno == EINVAL || errno == ENOSYS)){
+				size_t map_len = segment->offset + segment->len;
+				void *map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, segment->file_fd, 0);
+				if (map == MAP_FAILED){
+					perror("File mapping failed\n");
+					return 1;
+				}
+				segment->map = map;
+				segment->map_len = map_len;
+				continue;
+			}
+		}
+		else {
+			bytes_sent = write(conn->fd, segment->map + segment->offset, segment->len);
+			if (bytes_sent > 0){
+				segment->offset += bytes_sent;
+			}
+		}
+
+		if (bytes_sent < 0){
+			if (errno == EINTR) continue;
+			if (conn->nonblocking && (errno == EAGAIN || errno == EWOULDBLOCK)) return 2;
+			perror("Sending file failed");
+			return 1;
+		}
+		if (bytes_sent == 0){
+			fprintf(stderr, "File shrank while it was being sent\n");
+			return 1;
+		}
+		metrics_add(&metrics->bytes_out, bytes_sent);
+		segment->len -= bytes_sent;
+	}
+	conn_release_segment(segment);
+	return 0;
+}
+
+//Drop bytes_sent bytes of memory segments from the head of the queue: whole segments, then part of one
+void conn_consume(Connection *conn, off_t bytes_sent){
+	while (bytes_sent > 0){
+		OutSegment *segment = &conn->segments[conn->segment_head];
+		if (bytes_sent >= segment->len){
+			bytes_sent -= segment->len;
+			conn->segment_head++;
+		}
+		else {
+			segment->offset += bytes_sent;
+			segment->len -= bytes_sent;
+			bytes_sent = 0;
+		}
+	}
+}
+
+/*
+ * Send everything queued, in order. Runs of memory segments go out in one writev(),
+ * files with sendfile(). Returns 0 when drained or when a non-blocking socket is
+ * full (check conn_pending), 1 on error
+ */
+int conn_flush(Connection *conn){
+	while (conn_pending(conn)){
+		OutSegment *segment = &conn->segments[conn->segment_head];
+		if (segment->file_fd >= 0){
+			int result = conn_flush_file(conn, segment);
+			if (result == 1) return 1;
+			if (result == 2) return 0;
+			conn->segment_head++;
+			continue;
+		}
+
+		//Gather consecutive memory segments
+		struct iovec iov[64];
+		int iov_count = 0;
+		int file_follows = 0;
+		for (int i = conn->segment_head; i < conn->segment_count && iov_count < 64; i++){
+			if (conn->segments[i].file_fd >= 0){
+				file_follows = 1;
+				break;
+			}
+			iov[iov_count].iov_base = conn->out + conn->segments[i].offset;
+			iov[iov_count].iov_len = conn->segments[i].len;
+			iov_count++;
+		}
+
+		//MSG_MORE corks a header that is followed by a file so both share packets
+		struct msghdr message = {0};
+		message.msg_iov = iov;
+		message.msg_iovlen = iov_count;
+		ssize_t bytes_written = sendmsg(conn->fd, &message, file_follows ? MSG_MORE : 0);
+		if (bytes_written < 0){
+			if (errno == EINTR) continue;
+			if (conn->nonblocking && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+			perror("Write failed");
+			return 1;
+		}
+		metrics_add(&metrics->bytes_out, bytes_written);
+		conn_consume(conn, bytes_written);
+	}
+	conn->segment_head = conn->segment_count = 0;
+	conn->out_len = 0;
+	return 0;
+}
+
+/*
+ * Send a list of buffers to the client with writev(). When nothing is queued and the
+ * connection is not batching pipelined responses the buffers are written straight
+ * away; blocking connections loop until everything is out, non-blocking ones queue
+ * whatever the socket does not accept. Returns 0 for success, 1 for failure
+ */
+int conn_writev(Connection *conn, struct iovec *iov, int iov_count){
+	//Only write directly if nothing is queued, otherwise bytes would go out of order
+	if (!conn->batching && !conn_pending(conn)){
+		conn->out_len = 0;
+		while (iov_count > 0){
+			ssize_t bytes_written = writev(conn->fd, iov, iov_count);
+			if (bytes_written < 0){
+				if (errno == EINTR) continue;
+				if (conn->nonblocking && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+				perror("Write failed");
+				return 1;
+			}
+			metrics_add(&metrics->bytes_out, bytes_written);
+
+			//Skip fully written buffers and trim a partially written one
+			while (iov_count > 0 && (size_t)bytes_written >= iov->iov_len){
+				bytes_written -= iov->iov_len;
+				iov++;
+				iov_count--;
+			}
+			if (iov_count > 0){
+				iov->iov_base = (char *)iov->iov_base + bytes_written;
+				iov->iov_len -= bytes_written;
+			}
+		}
+	}
+
+	//Queue the remainder until the socket is writable again
+	for (int i = 0; i < iov_count; i++){
+		if (conn_queue(conn, iov[i].iov_base, iov[i].iov_len) != 0){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void conn_init(Connection *conn, int fd, int nonblocking){
+	//Responses are always written whole, so Nagle's algorithm would only delay them
+	int enable = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+	memset(conn, 0, sizeof(*conn));
+	conn->fd = fd;
+	conn->nonblocking = nonblocking;
+	conn->state = CONN_READING;
+	conn->request.arena = &conn->arena;
+	metrics_add(&metrics->connections_total, 1);
+	metrics_add(&metrics->active_connections, 1);
+}
+
+/*
+ * Queue len bytes of file_fd starting at offset after everything already queued.
+ * With owns_fd the connection takes ownership of file_fd and closes it once this
+ * segment has been sent; earlier segments of the same file pass 0. Returns 0 for
+ * success, 1 for failure
+ */
+int conn_queue_file(Connection *conn, int file_fd, off_t offset, off_t len, int owns_fd){
+	OutSegment *segment = conn_push_segment(conn);
+	if (segment == NULL){
+		if (owns_fd){
+			close(file_fd);
+		}
+		return 1;
+	}
+	segment->file_fd = file_fd;
+	segment->owns_fd = owns_fd;
+	segment->offset = offset;
+	segment->len = len;
+	return 0;
+}
+
+//=====================RESPONSE BUILDER==================
+/*
+ * Every response goes through a Response: the status line and headers are rendered
+ * into one buffer, body pieces are referenced rather than copied, and ranges of an
+ * optional file are sent as sendfile() segments between them. response_send() adds
+ * Content-Length and Connection and hands the lot to the connection as a single
+ * iovec list, or queues it ahead of the file segments.
+ */
+#define RESPONSE_MAX_PIECES 24
+#define RESPONSE_HEADER_SIZE 2048
+#define RESPONSE_TRAILER_SIZE 160 //Kept free at the end of header for the Content-Length and Connection lines response_write() appends
+#define RESPONSE_SCRATCH_SIZE 2048
+
+//A piece of response body: memory, or a range of the response's file when data is NULL
+typedef struct{
+	const char *data;
+	off_t offset; // into the file
+	off_t len;
+} ResponsePiece;
+
+typedef struct{
+	Connection *conn;
+	const char *prefix; // pre-rendered status line and headers including Content-Length, or NULL
+	size_t prefix_len;
+	ResponsePiece pieces[RESPONSE_MAX_PIECES]; // memory must stay valid until response_send()
+	off_t body_len; // memory and file body bytes, for Content-Length
+	off_t content_length; // -1 to send body_len, otherwise sent instead (304 responses carry no body)
+	size_t header_len;
+	size_t scratch_len;
+	int file_fd; // -1 when there is no file body
+	int piece_count;
+	int status;
+	int failed; // a header or body piece did not fit, response_send() answers 500 instead
+	char header[RESPONSE_HEADER_SIZE];
+	char scratch[RESPONSE_SCRATCH_SIZE]; // small body pieces copied by response_body_printf()
+} Response;
+
+void response_start(Response *response, Connection *conn, int status, const char *reason){
+	response->conn = conn;
+	response->prefix = NULL;
+	response->prefix_len = 0;
+	response->body_len = 0;
+	response->content_length = -1;
+	response->scratch_len = 0;
+	response->file_fd = -1;
+	response->piece_count = 0;
+	response->status = status;
+	response->failed = 0;
+	response->header_len = snprintf(response->header, sizeof(response->header), "HTTP/1.1 %d %s\r\n", status, reason);
+}
+
+/*
+ * Start a response whose status line and headers, Content-Length included, were
+ * rendered ahead of time (the file cache). Only Connection is added when sent
+ */
+void response_start_prerendered(Response *response, Connection *conn, const char *prefix, size_t prefix_len){
+	response_start(response, conn, 200, "OK");
+	response->prefix = prefix;
+	response->prefix_len = prefix_len;
+	response->header_len = 0;
+}
+
+//Append "name: value" where value is printf formatted
+void response_header(Response *response, const char *name, const char *format, ...){
+	size_t space = sizeof(response->header) - RESPONSE_TRAILER_SIZE - response->header_len;
+	int written = snprintf(response->header + response->header_len, space, "%s: ", name);
+	if (written < 0 || (size_t)written >= space){
+		response->failed = 1;
+		return;
+	}
+	response->header_len += written;
+	space -= written;
+
+	va_list args;
+	va_start(args, format);
+	written = vsnprintf(response->header + response->header_len, space, format, args);
+	va_end(args);
+	if (written < 0 || (size_t)written + 2 >= space){
+		response->failed = 1;
+		return;
+	}
+	response->header_len += written;
+	memcpy(response->header + response->header_len, "\r\n", 2);
+	response->header_len += 2;
+}
+
+ResponsePiece *response_add_piece(Response *response){
+	if (response->piece_count == RESPONSE_MAX_PIECES){
+		response->failed = 1;
+		return NULL;
+	}
+	return &response->pieces[response->piece_count++];
+}
+
+//Reference len bytes of data as the next piece of the body
+void response_body(Response *response, const void *data, size_t len){
+	ResponsePiece *piece = response_add_piece(response);
+	if (piece == NULL){
+		return;
+	}
+	piece->data = data;
+	piece->len = len;
+	response->body_len += len;
+}
+
+//Format a small body piece (e.g. a multipart boundary) into the response's scratch space
+void response_body_printf(Response *response, const char *format, ...){
+	size_t space = sizeof(response->scratch) - response->scratch_len;
+	va_list args;
+	va_start(args, format);
+	int written = vsnprintf(response->scratch + response->scratch_len, space, format, args);
+	va_end(args);
+	if (written < 0 || (size_t)written >= space){
+		response->failed = 1;
+		return;
+	}
+	response_body(response, response->scratch + response->scratch_len, written);
+	response->scratch_len += written;
+}
+
+//Use file_fd for the file pieces of this response. The response takes ownership of file_fd
+void response_set_file(Response *response, int file_fd){
+	if (response->file_fd >= 0 && response->file_fd != file_fd){
+		close(response->file_fd);
+	}
+	response->file_fd = file_fd;
+}
+
+//Send len bytes of the response's file from offset as the next piece of the body
+void response_file_range(Response *response, off_t offset, off_t len){
+	ResponsePiece *piece = response_add_piece(response);
+	if (piece == NULL){
+		return;
+	}
+	piece->data = NULL;
+	piece->offset = offset;
+	piece->len = len;
+	response->body_len += len;
+}
+
+//Send len bytes of file_fd from offset as the body. The response takes ownership of file_fd
+void response_file(Response *response, int file_fd, off_t offset, off_t len){
+	response_set_file(response, file_fd);
+	response_file_range(response, offset, len);
+}
+
+//See response_send()
+int response_write(Response *response){
+	Connection *conn = response->conn;
+	if (response->failed){
+		fprintf(stderr, "Response too large for the builder\n");
+		if (response->file_fd >= 0){
+			close(response->file_fd);
+		}
+		response_start(response, conn, 500, "Internal Server Error");
+		response_header(response, "Content-Type", "text/plain; charset=utf-8");
+		response_body(response, "Internal Server Error\r\n", 23);
+	}
+	conn->status = response->status;
+	conn->response_bytes = response->body_len;
+
+	//Tell keep-alive clients how long the connection may idle and how many requests it has left
+	char connection_line[96];
+	if (conn->keep_alive){
+		snprintf(connection_line, sizeof(connection_line), "Connection: keep-alive\r\nKeep-Alive: timeout=%ld, max=%d\r\n\r\n",
+			config.timeouts_ms[TIMEOUT_IDLE] / 1000, config.keep_alive_max - conn->requests - 1);
+	}
+	else {
+		snprintf(connection_line, sizeof(connection_line), "Connection: close\r\n\r\n");
+	}
+	struct iovec iov[RESPONSE_MAX_PIECES + 2];
+	int iov_count = 0;
+	if (response->prefix != NULL){
+		iov[iov_count].iov_base = (void *)response->prefix;
+		iov[iov_count].iov_len = response->prefix_len;
+		iov_count++;
+		iov[iov_count].iov_base = (void *)connection_line;
+		iov[iov_count].iov_len = strlen(connection_line);
+		iov_count++;
+	}
+	else {
+		//Fits, response_header() leaves RESPONSE_TRAILER_SIZE bytes for it
+		response->header_len += snprintf(response->header + response->header_len, sizeof(response->header) - response->header_len,
+			"Content-Length: %lld\r\n%s", (long long)(response->content_length >= 0 ? response->content_length : response->body_len), connection_line);
+		iov[iov_count].iov_base = response->header;
+		iov[iov_count].iov_len = response->header_len;
+		iov_count++;
+	}
+
+	if (response->file_fd < 0){
+		for (int i = 0; i < response->piece_count; i++){
+			iov[iov_count].iov_base = (void *)response->pieces[i].data;
+			iov[iov_count].iov_len = response->pieces[i].len;
+			iov_count++;
+		}
+		return conn_writev(conn, iov, iov_count);
+	}
+
+	//Queue the headers and memory pieces so conn_flush sends them with MSG_MORE ahead of each file range
+	int last_file_piece = -1;
+	for (int i = 0; i < response->piece_count; i++){
+		if (response->pieces[i].data == NULL) last_file_piece = i;
+	}
+	int failed = 0;
+	int fd_owned = 0; // the segment that closes file_fd has been queued
+	for (int i = 0; i < iov_count && !failed; i++){
+		failed = conn_queue(conn, iov[i].iov_base, iov[i].iov_len);
+	}
+	for (int i = 0; i < response->piece_count && !failed; i++){
+		ResponsePiece *piece = &response->pieces[i];
+		if (piece->data != NULL){
+			failed = conn_queue(conn, piece->data, piece->len);
+		}
+		else {
+			//The last range of the file owns the descriptor and closes it, even on failure
+			fd_owned = i == last_file_piece;
+			failed = conn_queue_file(conn, response->file_fd, piece->offset, piece->len, fd_owned);
+		}
+	}
+	if (!fd_owned){
+		close(response->file_fd);
+	}
+	if (failed){
+		return 1;
+	}
+	if (conn->batching){
+		return 0;
+	}
+	return conn_flush(conn);
+}
+
+/*
+ * Finish the headers and send header + body with one writev(), or queue them around
+ * the file ranges, looping on partial writes. Returns 0 for success, 1 for failure
+ */
+int response_send(Response *response){
+	uint64_t start = monotonic_ns();
+	int status = response_write(response);
+	metrics_observe(PHASE_SEND, monotonic_ns() - start);
+	return status;
+}
+
+//Short canned response such as a 404 with a plain text body
+int send_simple_response(Connection *conn, int status, const char *reason, const char *content_type, const char *body){
+	Response response;
+	response_start(&response, conn, status, reason);
+	response_header(&response, "Content-Type", "%s", content_type);
+	response_body(&response, body, strlen(body));
+	return response_send(&response);
+}
+
+//=====================DOCUMENT ROOT==================
+/*
+ * The document root is resolved once at startup and held open as a directory
+ * descriptor. Request paths are opened relative to it with openat2(RESOLVE_BENEATH),
+ * so the kernel rejects "..", absolute symlinks and symlinks that lead outside in
+ * the same lookup that opens the file, instead of realpath() walking every
+ * component with lstat() first. Kernels without openat2 (before 5.6, or a seccomp
+ * filter that hides it) fall back to the realpath() check.
+ */
+typedef struct{
+	const char *name; // as given, for inotify
+	char path[PATH_MAX]; // canonical
+	size_t path_len;
+	int fd; // O_PATH directory descriptor, -1 until document_root_open()
+	int no_openat2; // set once openat2 turned out to be unavailable
+} DocumentRoot;
+
+DocumentRoot document_root = { .fd = -1 };
+
+//Returns 0 for success, 1 for failure
+int document_root_open(const char *name){
+	if (realpath(name, document_root.path) == NULL){
+		fprintf(stderr, "Failed to canonicalize directory path\n");
+		return 1;
+	}
+	document_root.fd = open(document_root.path, O_PATH | O_DIRECTORY | O_CLOEXEC);
+	if (document_root.fd < 0){
+		perror("Failed to open document root\n");
+		return 1;
+	}
+	document_root.name = name;
+	document_root.path_len = strlen(document_root.path);
+	return 0;
+}
+
+//Request path relative to the document root: leading slashes dropped, "." for the root itself
+const char *document_root_relative(const char *path){
+	while (*path == '/'){
+		path++;
+	}
+	return *path != '\0' ? path : ".";
+}
+
+//1 if path is "/a/b" form: no empty, "." or ".." components. Such paths name one cache key per file
+int path_is_canonical(const char *path){
+	if (*path != '/'){
+		return 0;
+	}
+	while (*path == '/'){
+		const char *start = ++path;
+		while (*path != '\0' && *path != '/'){
+			path++;
+		}
+		size_t len = path - start;
+		if (len == 0 || (len == 1 && start[0] == '.') || (len == 2 && start[0] == '.' && start[1] == '.')){
+			return 0;
+		}
+	}
+	return 1;
+}
+
+//Pre-openat2 lookup: canonicalize and check the result is the root or below it
+int document_root_open_fallback(const char *relative, int flags, int *followed_symlink){
+	char unresolved[PATH_MAX];
+	char resolved[PATH_MAX];
+	if (snprintf(unresolved, sizeof(unresolved), "%s/%s", document_root.path, relative) >= (int)sizeof(unresolved)){
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+	if (realpath(unresolved, resolved) == NULL){
+		return -1;
+	}
+	if (strncmp(resolved, document_root.path, document_root.path_len) != 0
+			|| (resolved[document_root.path_len] != '/' && resolved[document_root.path_len] != '\0')){
+		errno = EXDEV;
+		return -1;
+	}
+	*followed_symlink = strcmp(resolved, unresolved) != 0;
+	return open(resolved, flags | O_CLOEXEC);
+}
+
+/*
+ * Open path (a request path, leading slash optional) beneath the document root.
+ * followed_symlink is set when the lookup went through a symlink, in which case
+ * inotify events for the target will not name path. Returns the descriptor or -1
+ * with errno set, EXDEV meaning the path tried to leave the document root
+ */
+int document_root_open_file(const char *path, int flags, int *followed_symlink){
+	const char *relative = document_root_relative(path);
+	*followed_symlink = 0;
+	if (document_root.no_openat2){
+		return document_root_open_fallback(relative, flags, followed_symlink);
+	}
+
+	//1. Most files are reached without symlinks: forbid them so one syscall answers both questions
+	struct open_how how = {
+		.flags = flags | O_CLOEXEC,
+		.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS | RESOLVE_NO_SYMLINKS,
+	};
+	int fd = syscall(SYS_openat2, document_root.fd, relative, &how, sizeof(how));
+	if (fd >= 0 || (errno != ELOOP && errno != ENOSYS && errno != EPERM)){
+		return fd;
+	}
+	if (errno == ENOSYS || errno == EPERM){
+		document_root.no_openat2 = 1;
+		return document_root_open_fallback(relative, flags, followed_symlink);
+	}
+
+	//2. A symlink on the way (or O_NOFOLLOW on one): allow those that stay beneath the root
+	how.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS;
+	*followed_symlink = 1;
+	return syscall(SYS_openat2, document_root.fd, relative, &how, sizeof(how));
+}
+
+//=====================STATIC FILE CACHE==================
+/*
+ * Small files are kept in memory together with their rendered status line and
+ * headers, keyed by request path, so a hit is a hash lookup and one writev() with
+ * no filesystem syscalls. Files too large for that keep an open descriptor and their
+ * stat details instead, so a hit costs a dup() rather than a path lookup, open and
+ * fstat, and is streamed with sendfile(). Entries live on an LRU list and the least
+ * recently used ones are evicted once the cache exceeds its byte budget or
+ * descriptor limit. Each event loop process watches the document root with inotify
+ * and drops entries whose file changes.
+ */
+#define CACHE_BUCKETS 1024
+#define CACHE_MAX_FILE (1024 * 1024) //Larger files are cached as descriptors and streamed with sendfile()
+#define CACHE_DEFAULT_SIZE (64 * 1024 * 1024)
+#define CACHE_MAX_FDS 256 //Descriptor entries kept open per process
+
+/*
+ * Content codings served from pre-compressed sidecar files next to the original
+ * (files/app.js.br, .zst, .gz), in order of preference when q-values tie. Bit i
+ * of a "codings" mask means the sidecar for content_codings[i] exists
+ */
+#define CODING_COUNT 3
+
+typedef struct{
+	const char *name; // Content-Encoding token
+	const char *extension; // sidecar suffix
+} ContentCoding;
+
+const ContentCoding content_codings[CODING_COUNT] = {
+	{ "br", ".br" },
+	{ "zstd", ".zst" },
+	{ "gzip", ".gz" },
+};
+
+typedef struct CacheEntry{
+	struct CacheEntry *hash_next;
+	struct CacheEntry *lru_prev; // towards most recently used
+	struct CacheEntry *lru_next; // towards least recently used
+	char *path; // request path relative to the document root, e.g. /index.html
+	char *header; // status line and headers up to, not including, Connection
+	char *body; // NULL for descriptor entries
+	const char *content_type; // static string
+	const char *content_encoding; // NULL unless this is a sidecar variant
+	size_t header_len;
+	size_t body_len;
+	time_t mtime; // Last-Modified
+	long max_age; // Cache-Control max-age, -1 for none
+	int codings; // sidecars of the original file
+	int fd; // open file of a descriptor entry, -1 when body holds the bytes
+	unsigned int hash;
+	char etag[48];
+} CacheEntry;
+
+//A regular file about to be sent, either a cache entry or an open descriptor
+typedef struct{
+	CacheEntry *entry; // NULL when the file is streamed from fd. Descriptor entries set both
+	const char *content_type;
+	const char *content_encoding; // NULL for the original, else the sidecar's coding
+	off_t size;
+	time_t mtime;
+	long max_age; // Cache-Control max-age, -1 for none
+	int codings; // sidecars of the original file, non-zero adds Vary: Accept-Encoding
+	int fd; // owned, -1 for cache entries
+	char etag[48]; // strong validator, quoted
+	char *body; // contents already read by the I/O pool, adopted by cache_insert()
+} StaticFile;
+
+//Maps an inotify watch descriptor to the request path prefix of the directory it watches
+typedef struct{
+	int wd;
+	char *prefix; // "" for the document root, "/sub" for files/sub
+} CacheWatch;
+
+typedef struct{
+	CacheEntry *buckets[CACHE_BUCKETS];
+	CacheEntry *lru_head;
+	CacheEntry *lru_tail;
+	CacheWatch *watches;
+	size_t bytes;
+	size_t max_bytes; // 0 disables the cache
+	int fd_count; // descriptor entries
+	int watch_count;
+	int watch_cap;
+	const char *root; // document root directory being watched
+	int inotify_fd; // -1 until cache_start_watching()
+	int enabled;
+} FileCache;
+
+FileCache file_cache = { .max_bytes = CACHE_DEFAULT_SIZE, .inotify_fd = -1 };
+
+//FNV-1a
+unsigned int cache_hash(const char *path){
+	unsigned int hash = 2166136261u;
+	while (*path){
+		hash ^= (unsigned char)*path++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+void cache_lru_unlink(CacheEntry *entry){
+	if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+	else file_cache.lru_head = entry->lru_next;
+	if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+	else file_cache.lru_tail = entry->lru_prev;
+	entry->lru_prev = entry->lru_next = NULL;
+}
+
+void cache_lru_push_front(CacheEntry *entry){
+	entry->lru_prev = NULL;
+	entry->lru_next = file_cache.lru_head;
+	if (file_cache.lru_head) file_cache.lru_head->lru_prev = entry;
+	file_cache.lru_head = entry;
+	if (file_cache.lru_tail == NULL) file_cache.lru_tail = entry;
+}
+
+void cache_remove_entry(CacheEntry *entry){
+	CacheEntry **link = &file_cache.buckets[entry->hash % CACHE_BUCKETS];
+	while (*link != entry){
+		link = &(*link)->hash_next;
+	}
+	*link = entry->hash_next;
+	cache_lru_unlink(entry);
+	file_cache.bytes -= entry->header_len + (entry->body != NULL ? entry->body_len : 0);
+	if (entry->fd >= 0){
+		close(entry->fd);
+		file_cache.fd_count--;
+	}
+	free(entry->path);
+	free(entry->header);
+	free(entry->body);
+	free(entry);
+}
+
+void cache_clear(void){
+	while (file_cache.lru_head != NULL){
+		cache_remove_entry(file_cache.lru_head);
+	}
+}
+
+CacheEntry *cache_lookup(const char *path){
+	if (!file_cache.enabled){
+		return NULL;
+	}
+	unsigned int hash = cache_hash(path);
+	for (CacheEntry *entry = file_cache.buckets[hash % CACHE_BUCKETS]; entry != NULL; entry = entry->hash_next){
+		if (entry->hash == hash && strcmp(entry->path, path) == 0){
+			cache_lru_unlink(entry);
+			cache_lru_push_front(entry);
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+void cache_invalidate(const char *path){
+	unsigned int hash = cache_hash(path);
+	for (CacheEntry *entry = file_cache.buckets[hash % CACHE_BUCKETS]; entry != NULL; entry = entry->hash_next){
+		if (entry->hash == hash && strcmp(entry->path, path) == 0){
+			cache_remove_entry(entry);
+			return;
+		}
+	}
+}
+
+//Cache key of the sidecar variant of path. Request paths never contain a space
+void cache_coding_key(char *key, size_t key_len, const char *path, int coding){
+	snprintf(key, key_len, "%s %s", path, content_codings[coding].name);
+}
+
+//A sidecar changed: drop its cached variant and the original, whose codings mask is now stale
+void cache_invalidate_sidecar(const char *path){
+	size_t path_len = strlen(path);
+	for (int i = 0; i < CODING_COUNT; i++){
+		size_t extension_len = strlen(content_codings[i].extension);
+		if (path_len > extension_len && strcmp(path + path_len - extension_len, content_codings[i].extension) == 0){
+			char original[PATH_MAX];
+			char key[PATH_MAX + 8];
+			snprintf(original, sizeof(original), "%.*s", (int)(path_len - extension_len), path);
+			cache_coding_key(key, sizeof(key), original, i);
+			cache_invalidate(original);
+			cache_invalidate(key);
+		}
+	}
+}
+
+/*
+ * Read the bytes of file into a new entry for path, or keep a duplicate of its
+ * descriptor if it is too large, evicting least recently used entries to stay
+ * within budget. A file->body already read by the I/O pool is taken over instead
+ * of reading the file again; it belongs to the cache only if this returns an entry.
+ * Returns NULL if the file is not cacheable
+ */
+CacheEntry *cache_insert(const char *path, const char *header, size_t header_len, const StaticFile *file){
+	int file_fd = file->fd;
+	off_t file_size = file->size;
+	int by_descriptor = file_size > CACHE_MAX_FILE;
+	size_t cost = header_len + (by_descriptor ? 0 : file_size);
+	if (!file_cache.enabled || cost > file_cache.max_bytes){
+		return NULL;
+	}
+
+	CacheEntry *entry = calloc(1, sizeof(CacheEntry));
+	if (entry == NULL){
+		return NULL;
+	}
+	entry->fd = -1;
+	entry->path = strdup(path);
+	entry->header = malloc(header_len);
+	if (by_descriptor){
+		entry->fd = fcntl(file_fd, F_DUPFD_CLOEXEC, 0);
+		entry->body_len = file_size;
+	}
+	else if (file->body != NULL){
+		//Already read by the I/O pool
+		entry->body = file->body;
+		entry->body_len = file_size;
+	}
+	else {
+		entry->body = malloc(file_size > 0 ? file_size : 1);
+	}
+	if (entry->path == NULL || entry->header == NULL || (by_descriptor ? entry->fd < 0 : entry->body == NULL)){
+		if (entry->fd >= 0){
+			close(entry->fd);
+		}
+		if (entry->body != file->body){
+			free(entry->body);
+		}
+		free(entry->path);
+		free(entry->header);
+		free(entry);
+		return NULL;
+	}
+	memcpy(entry->header, header, header_len);
+	entry->header_len = header_len;
+	entry->content_type = file->content_type;
+	entry->content_encoding = file->content_encoding;
+	entry->mtime = file->mtime;
+	entry->max_age = file->max_age;
+	entry->codings = file->codings;
+	memcpy(entry->etag, file->etag, sizeof(entry->etag));
+
+	//Read the whole file. Give up if it changes size under us
+	while (!by_descriptor && entry->body_len < (size_t)file_size){
+		ssize_t bytes_read = pread(file_fd, entry->body + entry->body_len, file_size - entry->body_len, entry->body_len);
+		if (bytes_read < 0 && errno == EINTR) continue;
+		if (bytes_read <= 0){
+			free(entry->path);
+			free(entry->header);
+			free(entry->body);
+			free(entry);
+			return NULL;
+		}
+		entry->body_len += bytes_read;
+	}
+
+	cache_invalidate(path);
+	while (file_cache.lru_tail != NULL && file_cache.bytes + cost > file_cache.max_bytes){
+		cache_remove_entry(file_cache.lru_tail);
+	}
+	if (by_descriptor){
+		//Out of descriptors to spend: close the least recently used descriptor entry
+		if (file_cache.fd_count == CACHE_MAX_FDS){
+			CacheEntry *victim = file_cache.lru_tail;
+			while (victim->fd < 0){
+				victim = victim->lru_prev;
+			}
+			cache_remove_entry(victim);
+		}
+		file_cache.fd_count++;
+	}
+
+	entry->hash = cache_hash(path);
+	entry->hash_next = file_cache.buckets[entry->hash % CACHE_BUCKETS];
+	file_cache.buckets[entry->hash % CACHE_BUCKETS] = entry;
+	cache_lru_push_front(entry);
+	file_cache.bytes += cost;
+	return entry;
+}
+
+/*
+ * Send a cached response as pre-rendered header + Connection line + body in one
+ * writev(). Descriptor entries stream the body from file_fd, which this takes
+ */
+int cache_send(Connection *conn, CacheEntry *entry, int file_fd){
+	Response response;
+	response_start_prerendered(&response, conn, entry->header, entry->header_len);
+	if (entry->body != NULL){
+		response_body(&response, entry->body, entry->body_len);
+	}
+	else {
+		response_file(&response, file_fd, 0, entry->body_len);
+	}
+	return response_send(&response);
+}
+
+//Watch directory dir (mapped to request path prefix) and every directory below it
+void cache_watch_tree(const char *dir, const char *prefix){
+	int wd = inotify_add_watch(file_cache.inotify_fd, dir,
+		IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF);
+	if (wd < 0){
+		perror("inotify_add_watch failed\n");
+		return;
+	}
+
+	if (file_cache.watch_count == file_cache.watch_cap){
+		int new_cap = file_cache.watch_cap ? file_cache.watch_cap * 2 : 16;
+		CacheWatch *new_watches = realloc(file_cache.watches, new_cap * sizeof(CacheWatch));
+		if (new_watches == NULL){
+			perror("Memory allocation failed\n");
+			return;
+		}
+		file_cache.watches = new_watches;
+		file_cache.watch_cap = new_cap;
+	}
+	file_cache.watches[file_cache.watch_count].wd = wd;
+	file_cache.watches[file_cache.watch_count].prefix = strdup(prefix);
+	file_cache.watch_count++;
+
+	DIR *directory = opendir(dir);
+	if (directory == NULL){
+		return;
+	}
+	struct dirent *item;
+	while ((item = readdir(directory)) != NULL){
+		if (item->d_type != DT_DIR || strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0){
+			continue;
+		}
+		char child_dir[PATH_MAX];
+		char child_prefix[PATH_MAX];
+		snprintf(child_dir, sizeof(child_dir), "%s/%s", dir, item->d_name);
+		snprintf(child_prefix, sizeof(child_prefix), "%s/%s", prefix, item->d_name);
+		cache_watch_tree(child_dir, child_prefix);
+	}
+	closedir(directory);
+}
+
+/*
+ * Enable the cache for this process and start watching the document root. Must be
+ * called after fork() since inotify events are consumed by whoever reads them.
+ * Returns the inotify descriptor for the event loop to poll, or -1 if disabled
+ */
+int cache_start_watching(const char *directory_name){
+	if (file_cache.max_bytes == 0){
+		return -1;
+	}
+	file_cache.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (file_cache.inotify_fd < 0){
+		perror("inotify_init1 failed, file cache disabled\n");
+		return -1;
+	}
+	file_cache.root = directory_name;
+	cache_watch_tree(directory_name, "");
+	file_cache.enabled = 1;
+	return file_cache.inotify_fd;
+}
+
+//Drain pending inotify events and drop the cache entries they refer to
+void cache_handle_inotify(void){
+	char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	while (1){
+		ssize_t len = read(file_cache.inotify_fd, events, sizeof(events));
+		if (len <= 0){
+			if (len < 0 && errno == EINTR) continue;
+			return;
+		}
+
+		for (char *ptr = events; ptr < events + len; ){
+			struct inotify_event *event = (struct inotify_event *)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			//Lost events or a directory changed shape: start over
+			if (event->mask & (IN_Q_OVERFLOW | IN_ISDIR | IN_DELETE_SELF | IN_MOVE_SELF)){
+				cache_clear();
+			}
+
+			CacheWatch *watch = NULL;
+			for (int i = 0; i < file_cache.watch_count; i++){
+				if (file_cache.watches[i].wd == event->wd){
+					watch = &file_cache.watches[i];
+					break;
+				}
+			}
+			if (watch == NULL){
+				continue;
+			}
+
+			if (event->mask & IN_IGNORED){
+				free(watch->prefix);
+				*watch = file_cache.watches[--file_cache.watch_count];
+				continue;
+			}
+
+			if (event->len > 0){
+				char path[PATH_MAX];
+				snprintf(path, sizeof(path), "%s/%s", watch->prefix, event->name);
+				if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))){
+					char dir[PATH_MAX];
+					snprintf(dir, sizeof(dir), "%s%s", file_cache.root, path);
+					cache_watch_tree(dir, path);
+				}
+				else {
+					cache_invalidate(path);
+					cache_invalidate_sidecar(path);
+				}
+			}
+		}
+	}
+}
+
+//=====================STATIC BUNDLE==================
+/*
+ * A read-only snapshot of the document root packed into one file by bundlegen: a
+ * hash index of request paths followed by, for every file and pre-compressed
+ * sidecar, its rendered 200 header, metadata and bytes. --bundle maps it at startup,
+ * which costs the same however many files it holds, and a GET for a path in it is
+ * answered from the mapping after one hash probe with no filesystem calls at all.
+ * Paths it does not hold (files added since, or too large to pack) are looked up
+ * in the document root as usual.
+ *
+ * Layout: BundleHeader, slot_count BundleSlots, entry_count BundleEntries, then the
+ * keys, headers, content types and bodies they point at. Offsets are from the start
+ * of the file and the byte order is the packing machine's.
+ */
+#define BUNDLE_MAGIC "HTTPBNDL"
+#define BUNDLE_VERSION 1
+
+typedef struct{
+	char magic[8];
+	uint32_t version;
+	uint32_t slot_count; // power of two, at least twice entry_count
+	uint64_t entry_count;
+	uint64_t size; // of the whole file, so a truncated copy is refused
+} BundleHeader;
+
+//Linear probing: a key lives at the first slot from cache_hash(key) & (slot_count - 1) on whose hash matches
+typedef struct{
+	uint32_t hash;
+	uint32_t entry; // index into the entries plus one, 0 for an empty slot
+} BundleSlot;
+
+typedef struct{
+	uint64_t key_offset; // request path, or cache_coding_key() of it for a sidecar
+	uint64_t header_offset; // status line and headers up to Content-Length, as render_static_header()
+	uint64_t content_type_offset; // null terminated
+	uint64_t body_offset;
+	uint64_t body_len;
+	int64_t mtime;
+	int64_t max_age; // -1 for none
+	uint32_t key_len;
+	uint32_t header_len;
+	int32_t codings; // sidecars of the original file
+	int32_t coding; // content_codings index of a sidecar, -1 for the original
+	char etag[48];
+} BundleEntry;
+
+typedef struct{
+	const char *data; // NULL when no bundle is loaded
+	size_t size;
+	const BundleHeader *header;
+	const BundleSlot *slots;
+	const BundleEntry *entries;
+} Bundle;
+
+Bundle bundle;
+
+//Map a bundle for this process and every process forked from it. Returns 0 for success, 1 for failure
+int bundle_open(const char *name){
+	int fd = open(name, O_RDONLY | O_CLOEXEC);
+	if (fd < 0){
+		perror("Failed to open bundle\n");
+		return 1;
+	}
+	struct stat bundle_stat;
+	if (fstat(fd, &bundle_stat) != 0 || (size_t)bundle_stat.st_size < sizeof(BundleHeader)){
+		fprintf(stderr, "%s is not a bundle\n", name);
+		close(fd);
+		return 1;
+	}
+	void *data = mmap(NULL, bundle_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED){
+		perror("Failed to map bundle\n");
+		return 1;
+	}
+
+	//Only the fixed-size parts are checked here, entries are bounds checked when used
+	const BundleHeader *header = data;
+	uint64_t index_end = sizeof(BundleHeader) + (uint64_t)header->slot_count * sizeof(BundleSlot)
+		+ header->entry_count * sizeof(BundleEntry);
+	if (memcmp(header->magic, BUNDLE_MAGIC, sizeof(header->magic)) != 0 || header->version != BUNDLE_VERSION
+			|| header->size != (uint64_t)bundle_stat.st_size || header->slot_count == 0
+			|| (header->slot_count & (header->slot_count - 1)) != 0 || header->entry_count >= header->slot_count
+			|| index_end > header->size){
+		fprintf(stderr, "%s is not a bundle this server can read\n", name);
+		munmap(data, bundle_stat.st_size);
+		return 1;
+	}
+	bundle.data = data;
+	bundle.size = bundle_stat.st_size;
+	bundle.header = header;
+	bundle.slots = (const BundleSlot *)(header + 1);
+	bundle.entries = (const BundleEntry *)(bundle.slots + header->slot_count);
+	return 0;
+}
+
+//1 if every range the entry points at lies inside the bundle
+int bundle_entry_valid(const BundleEntry *entry){
+	uint64_t size = bundle.size;
+	return entry->key_offset <= size && entry->key_len <= size - entry->key_offset
+		&& entry->header_offset <= size && entry->header_len <= size - entry->header_offset
+		&& entry->body_offset <= size && entry->body_len <= size - entry->body_offset
+		&& entry->content_type_offset < size && memchr(bundle.data + entry->content_type_offset, '\0', size - entry->content_type_offset) != NULL
+		&& entry->coding >= -1 && entry->coding < CODING_COUNT && entry->etag[sizeof(entry->etag) - 1] == '\0';
+}
+
+//The entry for a cache key, or NULL if there is no bundle or it does not hold the key
+const BundleEntry *bundle_find(const char *key){
+	if (bundle.data == NULL){
+		return NULL;
+	}
+	unsigned int hash = cache_hash(key);
+	size_t key_len = strlen(key);
+	uint32_t mask = bundle.header->slot_count - 1;
+	//At most one lap: a corrupt index with no empty slot must not spin forever
+	uint32_t i = hash & mask;
+	for (uint32_t probes = 0; probes <= mask && bundle.slots[i].entry != 0; probes++, i = (i + 1) & mask){
+		const BundleSlot *slot = &bundle.slots[i];
+		if (slot->hash != hash || slot->entry > bundle.header->entry_count){
+			continue;
+		}
+		const BundleEntry *entry = &bundle.entries[slot->entry - 1];
+		if (bundle_entry_valid(entry) && entry->key_len == key_len && memcmp(bundle.data + entry->key_offset, key, key_len) == 0){
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+//Present a bundle entry as the in-memory cache entry it stands in for, pointing into the mapping
+void bundle_entry_describe(const BundleEntry *packed, CacheEntry *entry){
+	memset(entry, 0, sizeof(*entry));
+	entry->header = (char *)bundle.data + packed->header_offset;
+	entry->header_len = packed->header_len;
+	entry->body = (char *)bundle.data + packed->body_offset;
+	entry->body_len = packed->body_len;
+	entry->content_type = bundle.data + packed->content_type_offset;
+	entry->content_encoding = packed->coding >= 0 ? content_codings[packed->coding].name : NULL;
+	entry->mtime = packed->mtime;
+	entry->max_age = packed->max_age;
+	entry->codings = packed->codings;
+	entry->fd = -1;
+	memcpy(entry->etag, packed->etag, sizeof(entry->etag));
+}
+
+//=====================STATIC FILES==================
+/*
+ * send_static_file() answers Range requests (RFC 9110 section 14) with 206 and
+ * one range or a multipart/byteranges body, 416 when nothing is satisfiable, and
+ * the whole file otherwise. Ranges are sendfile() segments or slices of the cached
+ * body, so no range is ever copied. Accept-Encoding picks between the original
+ * and its pre-compressed sidecars. Every response carries a strong ETag built from
+ * inode, size and mtime plus Last-Modified, and matching If-None-Match or
+ * If-Modified-Since requests get a bodiless 304.
+ */
+#define RANGE_MAX 8 //More ranges than this and the Range header is ignored
+
+typedef struct{
+	off_t start;
+	off_t end; // inclusive
+} ByteRange;
+
+//Render time as an IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+void format_http_date(time_t time, char *out, size_t out_len){
+	struct tm tm;
+	gmtime_r(&time, &tm);
+	strftime(out, out_len, "%a, %d %b %Y %H:%M:%S GMT", &tm);
+}
+
+//Parse the non-negative decimal at *ptr, advancing it. Returns -1 if there are no digits or it overflows
+off_t parse_range_number(const char **ptr){
+	const char *p = *ptr;
+	off_t value = 0;
+	if (*p < '0' || *p > '9'){
+		return -1;
+	}
+	while (*p >= '0' && *p <= '9'){
+		if (value > (LLONG_MAX - 9) / 10){
+			return -1;
+		}
+		value = value * 10 + (*p++ - '0');
+	}
+	*ptr = p;
+	return value;
+}
+
+/*
+ * Parse a Range header value against a file of size bytes into at most max ranges.
+ * Returns the number of satisfiable ranges, 0 if the header must be ignored (not
+ * bytes, malformed or too many ranges) or -1 if no range is satisfiable
+ */
+int parse_range(const char *value, off_t size, ByteRange *ranges, int max){
+	if (strncasecmp(value, "bytes=", 6) != 0){
+		return 0;
+	}
+	const char *p = value + 6;
+	int count = 0;
+	int seen = 0;
+	while (1){
+		while (*p == ' ' || *p == '\t') p++;
+		off_t start, end;
+		if (*p == '-'){
+			//Suffix range: the last n bytes
+			p++;
+			off_t suffix = parse_range_number(&p);
+			if (suffix < 0){
+				return 0;
+			}
+			start = suffix >= size ? 0 : size - suffix;
+			end = suffix > 0 ? size - 1 : -1;
+		}
+		else {
+			start = parse_range_number(&p);
+			if (start < 0 || *p++ != '-'){
+				return 0;
+			}
+			end = size - 1;
+			if (*p >= '0' && *p <= '9'){
+				end = parse_range_number(&p);
+				if (end < start){
+					return 0;
+				}
+				if (end > size - 1) end = size - 1;
+			}
+		}
+		if (++seen > max){
+			return 0;
+		}
+		if (start < size && start <= end){
+			ranges[count].start = start;
+			ranges[count].end = end;
+			count++;
+		}
+
+		while (*p == ' ' || *p == '\t') p++;
+		if (*p == '\0'){
+			break;
+		}
+		if (*p++ != ','){
+			return 0;
+		}
+	}
+	return count > 0 ? count : -1;
+}
+
+/*
+ * If-Range only lets the Range through when the validator still matches: strong
+ * comparison for an entity tag, an exact Last-Modified match for a date
+ */
+int if_range_matches(const char *if_range, const StaticFile *file){
+	if (if_range[0] == '"' || strncmp(if_range, "W/", 2) == 0){
+		return strcmp(if_range, file->etag) == 0;
+	}
+	char date[64];
+	format_http_date(file->mtime, date, sizeof(date));
+	return strcmp(if_range, date) == 0;
+}
+
+//Weak comparison of etag against an If-None-Match list ("*" or comma separated entity tags)
+int etag_list_matches(const char *list, const char *etag){
+	const char *p = list;
+	while (*p){
+		while (*p == ' ' || *p == '\t' || *p == ',') p++;
+		if (*p == '*'){
+			return 1;
+		}
+		if (strncmp(p, "W/", 2) == 0){
+			p += 2;
+		}
+		if (*p != '"'){
+			return 0;
+		}
+		const char *end = strchr(p + 1, '"');
+		if (end == NULL){
+			return 0;
+		}
+		if ((size_t)(end + 1 - p) == strlen(etag) && strncmp(p, etag, end + 1 - p) == 0){
+			return 1;
+		}
+		p = end + 1;
+	}
+	return 0;
+}
+
+//Parse an IMF-fixdate. Returns -1 if it is not one
+time_t parse_http_date(const char *text){
+	struct tm tm;
+	memset(&tm, 0, sizeof(tm));
+	const char *end = strptime(text, "%a, %d %b %Y %H:%M:%S GMT", &tm);
+	if (end == NULL || *end != '\0'){
+		return -1;
+	}
+	return timegm(&tm);
+}
+
+/*
+ * Whether the client's copy is still current (RFC 9110 section 13.2.2): If-None-Match
+ * when present, otherwise If-Modified-Since
+ */
+int static_file_not_modified(HttpRequest *request, const StaticFile *file){
+	char *if_none_match = header_value(request, HEADER_IF_NONE_MATCH);
+	if (if_none_match != NULL){
+		return etag_list_matches(if_none_match, file->etag);
+	}
+	char *if_modified_since = header_value(request, HEADER_IF_MODIFIED_SINCE);
+	if (if_modified_since != NULL){
+		time_t since = parse_http_date(if_modified_since);
+		return since >= 0 && file->mtime <= since;
+	}
+	return 0;
+}
+
+//Media type for the extension of path from the generated table in mime_types.h, application/octet-stream if unknown
+const char *mime_type(const char *path){
+	const char *dot = strrchr(path, '.');
+	const char *slash = strrchr(path, '/');
+	if (dot == NULL || dot == path || (slash != NULL && dot <= slash + 1)){
+		return "application/octet-stream";
+	}
+
+	//1. Extensions are matched case-insensitively
+	char extension[MIME_MAX_EXTENSION];
+	size_t len = 0;
+	for (const char *c = dot + 1; *c != '\0'; c++){
+		if (len == sizeof(extension) - 1){
+			return "application/octet-stream";
+		}
+		extension[len++] = tolower((unsigned char)*c);
+	}
+	extension[len] = '\0';
+
+	//2. Bucket gives the displacement, displacement gives the only slot the extension can be in
+	uint32_t bucket = mime_hash(extension, 0) % MIME_BUCKETS;
+	const MimeSlot *slot = &mime_slots[mime_hash(extension, mime_displacements[bucket]) & (MIME_SLOTS - 1)];
+	if (slot->extension != NULL && strcmp(slot->extension, extension) == 0){
+		return slot->type;
+	}
+	return "application/octet-stream";
+}
+
+//Cache-Control max-age configured for path's extension, -1 for none
+long cache_control_max_age(const char *path){
+	const char *extension = strrchr(path, '.');
+	const char *slash = strrchr(path, '/');
+	if (extension != NULL && (slash == NULL || extension > slash + 1)){
+		extension++;
+	}
+	else {
+		extension = NULL;
+	}
+	long fallback = -1;
+	for (int i = 0; i < config.cache_control_count; i++){
+		if (extension != NULL && strcasecmp(config.cache_control[i].extension, extension) == 0){
+			return config.cache_control[i].max_age;
+		}
+		if (strcmp(config.cache_control[i].extension, "*") == 0){
+			fallback = config.cache_control[i].max_age;
+		}
+	}
+	return fallback;
+}
+
+//Fill in the size, Last-Modified and strong ETag of file from stat
+void static_file_stat(StaticFile *file, const struct stat *file_stat){
+	file->size = file_stat->st_size;
+	file->mtime = file_stat->st_mtime;
+	snprintf(file->etag, sizeof(file->etag), "\"%llx-%llx-%llx\"",
+		(unsigned long long)file_stat->st_ino, (unsigned long long)file_stat->st_size,
+		(unsigned long long)file_stat->st_mtim.tv_sec * 1000000000ull + file_stat->st_mtim.tv_nsec);
+}
+
+//Random multipart boundary, different for every response
+void make_boundary(char *out, size_t out_len){
+	static unsigned long long state;
+	if (state == 0){
+		state = ((unsigned long long)time(NULL) << 20) ^ (unsigned long long)getpid() ^ 0x9e3779b97f4a7c15ull;
+	}
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	snprintf(out, out_len, "%016llx", state);
+}
+
+//Parse a qvalue ("1", "0.5", "0.125") into thousandths. Returns -1 if malformed
+int parse_qvalue(const char *p, size_t len){
+	if (len == 0 || (p[0] != '0' && p[0] != '1')){
+		return -1;
+	}
+	int q = (p[0] - '0') * 1000;
+	if (len == 1){
+		return q;
+	}
+	if (p[1] != '.' || len > 5){
+		return -1;
+	}
+	int scale = 100;
+	for (size_t i = 2; i < len; i++, scale /= 10){
+		if (p[i] < '0' || p[i] > '9'){
+			return -1;
+		}
+		q += (p[i] - '0') * scale;
+	}
+	return q > 1000 ? -1 : q;
+}
+
+/*
+ * Pick the coding to send for an Accept-Encoding value out of the available sidecars.
+ * The highest q wins, ties go to the order of content_codings and the original is
+ * only preferred when "identity" is listed with a higher q. Returns the index into
+ * content_codings, or -1 to send the original
+ */
+int choose_coding(const char *accept, int available){
+	if (accept == NULL || available == 0){
+		return -1;
+	}
+	int q[CODING_COUNT] = { -1, -1, -1 };
+	int star_q = -1;
+	int identity_q = 0;
+
+	//1. Walk the comma separated list of "coding *( OWS ";" OWS param )"
+	const char *p = accept;
+	while (*p){
+		while (*p == ' ' || *p == '\t' || *p == ',') p++;
+		const char *token = p;
+		while (*p && *p != ',' && *p != ';' && *p != ' ' && *p != '\t') p++;
+		size_t token_len = p - token;
+		int token_q = 1000;
+		while (*p && *p != ','){
+			while (*p == ' ' || *p == '\t' || *p == ';') p++;
+			const char *param = p;
+			while (*p && *p != ',' && *p != ';') p++;
+			const char *param_end = p;
+			while (param_end > param && (param_end[-1] == ' ' || param_end[-1] == '\t')) param_end--;
+			if (param_end - param >= 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '='){
+				token_q = parse_qvalue(param + 2, param_end - param - 2);
+			}
+		}
+		if (token_len == 0 || token_q < 0){
+			continue;
+		}
+
+		//2. Remember the q of every coding we know
+		if (token_len == 1 && token[0] == '*'){
+			star_q = token_q;
+		}
+		else if (token_len == 8 && strncasecmp(token, "identity", 8) == 0){
+			identity_q = token_q;
+		}
+		else if (token_len == 6 && strncasecmp(token, "x-gzip", 6) == 0){
+			q[CODING_COUNT - 1] = token_q;
+		}
+		else {
+			for (int i = 0; i < CODING_COUNT; i++){
+				if (strlen(content_codings[i].name) == token_len && strncasecmp(token, content_codings[i].name, token_len) == 0){
+					q[i] = token_q;
+				}
+			}
+		}
+	}
+
+	//3. Best available sidecar, unlisted codings take the q of "*"
+	int best = -1;
+	int best_q = 0;
+	for (int i = 0; i < CODING_COUNT; i++){
+		int coding_q = q[i] >= 0 ? q[i] : (star_q >= 0 ? star_q : 0);
+		if ((available & (1 << i)) && coding_q > best_q){
+			best = i;
+			best_q = coding_q;
+		}
+	}
+	return best_q >= identity_q ? best : -1;
+}
+
+//Bit i set for each sidecar of path (a request path under the document root) that is a regular file
+int find_sidecars(const char *path){
+	int codings = 0;
+	for (int i = 0; i < CODING_COUNT; i++){
+		char sidecar[PATH_MAX + 8];
+		struct stat sidecar_stat;
+		snprintf(sidecar, sizeof(sidecar), "%s%s", document_root_relative(path), content_codings[i].extension);
+		if (fstatat(document_root.fd, sidecar, &sidecar_stat, AT_SYMLINK_NOFOLLOW) == 0 && S_ISREG(sidecar_stat.st_mode)){
+			codings |= 1 << i;
+		}
+	}
+	return codings;
+}
+
+//Render the 200 status line and headers, up to and including Content-Length, for the file cache
+int render_static_header(char *header, size_t header_size, const StaticFile *file){
+	char last_modified[64];
+	char cache_control[48] = "";
+	format_http_date(file->mtime, last_modified, sizeof(last_modified));
+	if (file->max_age >= 0){
+		snprintf(cache_control, sizeof(cache_control), "Cache-Control: max-age=%ld\r\n", file->max_age);
+	}
+	return snprintf(header, header_size,
+			"HTTP/1.1 200 OK\r\n"
+			"Content-Type: %s\r\n"
+			"%s%s%s"
+			"%s"
+			"ETag: %s\r\n"
+			"Last-Modified: %s\r\n"
+			"%s"
+			"Accept-Ranges: bytes\r\n"
+			"Content-Length: %lld\r\n",
+			file->content_type,
+			file->content_encoding ? "Content-Encoding: " : "", file->content_encoding ? file->content_encoding : "", file->content_encoding ? "\r\n" : "",
+			file->codings ? "Vary: Accept-Encoding\r\n" : "",
+			file->etag,
+			last_modified,
+			cache_control,
+			(long long)file->size);
+}
+
+//Validators, caching policy, Content-Encoding and Vary for a response built on the fly
+void static_file_headers(Response *response, const StaticFile *file){
+	char last_modified[64];
+	format_http_date(file->mtime, last_modified, sizeof(last_modified));
+	if (file->content_encoding != NULL){
+		response_header(response, "Content-Encoding", "%s", file->content_encoding);
+	}
+	if (file->codings){
+		response_header(response, "Vary", "Accept-Encoding");
+	}
+	response_header(response, "ETag", "%s", file->etag);
+	response_header(response, "Last-Modified", "%s", last_modified);
+	if (file->max_age >= 0){
+		response_header(response, "Cache-Control", "max-age=%ld", file->max_age);
+	}
+}
+
+//Describe a cache entry as a StaticFile. Returns 0 for success, 1 if a descriptor entry's fd could not be duplicated
+int static_file_from_entry(StaticFile *file, CacheEntry *entry){
+	file->entry = entry;
+	file->content_type = entry->content_type;
+	file->content_encoding = entry->content_encoding;
+	file->size = entry->body_len;
+	file->mtime = entry->mtime;
+	file->max_age = entry->max_age;
+	file->codings = entry->codings;
+	file->fd = -1;
+	memcpy(file->etag, entry->etag, sizeof(file->etag));
+	if (entry->fd >= 0){
+		file->fd = fcntl(entry->fd, F_DUPFD_CLOEXEC, 0);
+		if (file->fd < 0){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//Add bytes [start, end] of the file as the next body piece
+void static_file_body(Response *response, StaticFile *file, off_t start, off_t end){
+	if (file->entry != NULL && file->entry->body != NULL){
+		response_body(response, file->entry->body + start, end - start + 1);
+	}
+	else {
+		response_file_range(response, start, end - start + 1);
+	}
+}
+
+//Send file, or the ranges of it the request asks for. Takes ownership of file->fd. Returns 0 for success, 1 for failure
+int send_static_file(Connection *conn, HttpRequest *request, StaticFile *file){
+	Response response;
+	if (static_file_not_modified(request, file)){
+		if (file->fd >= 0){
+			close(file->fd);
+		}
+		response_start(&response, conn, 304, "Not Modified");
+		static_file_headers(&response, file);
+		response.content_length = file->size;
+		return response_send(&response);
+	}
+
+	ByteRange ranges[RANGE_MAX];
+	int range_count = 0;
+	char *range = header_value(request, HEADER_RANGE);
+	if (range != NULL){
+		char *if_range = header_value(request, HEADER_IF_RANGE);
+		if (if_range == NULL || if_range_matches(if_range, file)){
+			//Parts of a multipart body cannot carry the Content-Encoding, so encoded variants take one range
+			range_count = parse_range(range, file->size, ranges, file->content_encoding ? 1 : RANGE_MAX);
+		}
+	}
+
+	if (range_count == 0){
+		if (file->entry != NULL){
+			return cache_send(conn, file->entry, file->fd);
+		}
+		response_start(&response, conn, 200, "OK");
+		response_header(&response, "Content-Type", "%s", file->content_type);
+		static_file_headers(&response, file);
+		response_header(&response, "Accept-Ranges", "bytes");
+		response_file(&response, file->fd, 0, file->size);
+		return response_send(&response);
+	}
+
+	if (range_count < 0){
+		if (file->fd >= 0){
+			close(file->fd);
+		}
+		response_start(&response, conn, 416, "Range Not Satisfiable");
+		response_header(&response, "Content-Range", "bytes */%lld", (long long)file->size);
+		static_file_headers(&response, file);
+		response_header(&response, "Content-Type", "text/plain; charset=utf-8");
+		response_body(&response, "Range Not Satisfiable\r\n", 23);
+		return response_send(&response);
+	}
+
+	response_start(&response, conn, 206, "Partial Content");
+	response_header(&response, "Accept-Ranges", "bytes");
+	if (file->fd >= 0){
+		response_set_file(&response, file->fd);
+	}
+	if (range_count == 1){
+		response_header(&response, "Content-Type", "%s", file->content_type);
+		static_file_headers(&response, file);
+		response_header(&response, "Content-Range", "bytes %lld-%lld/%lld",
+			(long long)ranges[0].start, (long long)ranges[0].end, (long long)file->size);
+		static_file_body(&response, file, ranges[0].start, ranges[0].end);
+		return response_send(&response);
+	}
+
+	char boundary[32];
+	make_boundary(boundary, sizeof(boundary));
+	response_header(&response, "Content-Type", "multipart/byteranges; boundary=%s", boundary);
+	static_file_headers(&response, file);
+	for (int i = 0; i < range_count; i++){
+		response_body_printf(&response, "%s--%s\r\nContent-Type: %s\r\nContent-Range: bytes %lld-%lld/%lld\r\n\r\n",
+			i == 0 ? "" : "\r\n", boundary, file->content_type,
+			(long long)ranges[i].start, (long long)ranges[i].end, (long long)file->size);
+		static_file_body(&response, file, ranges[i].start, ranges[i].end);
+	}
+	response_body_printf(&response, "\r\n--%s--\r\n", boundary);
+	return response_send(&response);
+}
+
+//Sum a counter over every worker slot
+uint64_t metrics_sum(size_t offset){
+	if (metrics_shared == NULL){
+		return __atomic_load_n((uint64_t *)((char *)metrics + offset), __ATOMIC_RELAXED);
+	}
+	uint64_t total = 0;
+	for (int i = 0; i < METRICS_SLOTS; i++){
+		total += __atomic_load_n((uint64_t *)((char *)&metrics_shared[i] + offset), __ATOMIC_RELAXED);
+	}
+	return total;
+}
+
+//Answer GET /metrics with every worker's counters in the Prometheus text format
+int metrics_send(Connection *conn){
+	char *text = NULL;
+	size_t text_len = 0;
+	FILE *out = open_memstream(&text, &text_len);
+	if (out == NULL){
+		perror("open_memstream failed\n");
+		send_simple_response(conn, 500, "Internal Server Error", "text/plain; charset=utf-8", "Internal Server Error\r\n");
+		return 1;
+	}
+
+	//1. Requests by method and status
+	fprintf(out, "# HELP http_requests_total Requests answered, by method and status.\n# TYPE http_requests_total counter\n");
+	for (int method = 0; method < METRICS_METHODS; method++){
+		for (int status = 0; status < METRICS_STATUSES; status++){
+			uint64_t count = metrics_sum(offsetof(WorkerMetrics, requests[method][status]));
+			if (count == 0) continue;
+			if (status < METRICS_STATUSES - 1){
+				fprintf(out, "http_requests_total{method=\"%s\",status=\"%d\"} %llu\n",
+					metrics_method_names[method], metrics_statuses[status], (unsigned long long)count);
+			}
+			else {
+				fprintf(out, "http_requests_total{method=\"%s\",status=\"other\"} %llu\n", metrics_method_names[method], (unsigned long long)count);
+			}
+		}
+	}
+
+	//2. Plain counters and the connection gauge
+	fprintf(out, "# HELP http_received_bytes_total Bytes read from clients.\n# TYPE http_received_bytes_total counter\n"
+		"http_received_bytes_total %llu\n", (unsigned long long)metrics_sum(offsetof(WorkerMetrics, bytes_in)));
+	fprintf(out, "# HELP http_sent_bytes_total Bytes written to clients.\n# TYPE http_sent_bytes_total counter\n"
+		"http_sent_bytes_total %llu\n", (unsigned long long)metrics_sum(offsetof(WorkerMetrics, bytes_out)));
+	fprintf(out, "# HELP http_connections_total Connections accepted.\n# TYPE http_connections_total counter\n"
+		"http_connections_total %llu\n", (unsigned long long)metrics_sum(offsetof(WorkerMetrics, connections_total)));
+	fprintf(out, "# HELP http_active_connections Connections currently open.\n# TYPE http_active_connections gauge\n"
+		"http_active_connections %lld\n", (long long)metrics_sum(offsetof(WorkerMetrics, active_connections)));
+	fprintf(out, "# HELP http_parse_failures_total Requests rejected by the parser.\n# TYPE http_parse_failures_total counter\n"
+		"http_parse_failures_total %llu\n", (unsigned long long)metrics_sum(offsetof(WorkerMetrics, parse_failures)));
+	fprintf(out, "# HELP http_access_log_dropped_total Access log lines dropped because the writer fell behind.\n"
+		"# TYPE http_access_log_dropped_total counter\n"
+		"http_access_log_dropped_total %llu\n", (unsigned long long)metrics_sum(offsetof(WorkerMetrics, log_dropped)));
+
+	//3. Phase histograms with cumulative buckets
+	fprintf(out, "# HELP http_phase_duration_seconds Time spent in each phase of a request.\n# TYPE http_phase_duration_seconds histogram\n");
+	for (int phase = 0; phase < PHASE_COUNT; phase++){
+		uint64_t cumulative = 0;
+		for (int bucket = 0; bucket < METRICS_HIST_BUCKETS; bucket++){
+			cumulative += metrics_sum(offsetof(WorkerMetrics, phases[phase].buckets[bucket]));
+			fprintf(out, "http_phase_duration_seconds_bucket{phase=\"%s\",le=\"%g\"} %llu\n",
+				metrics_phase_names[phase], metrics_bucket_bound(bucket) / 1e6, (unsigned long long)cumulative);
+		}
+		uint64_t count = metrics_sum(offsetof(WorkerMetrics, phases[phase].count));
+		fprintf(out, "http_phase_duration_seconds_bucket{phase=\"%s\",le=\"+Inf\"} %llu\n", metrics_phase_names[phase], (unsigned long long)count);
+		fprintf(out, "http_phase_duration_seconds_sum{phase=\"%s\"} %.9f\n", metrics_phase_names[phase],
+			metrics_sum(offsetof(WorkerMetrics, phases[phase].sum_ns)) / 1e9);
+		fprintf(out, "http_phase_duration_seconds_count{phase=\"%s\"} %llu\n", metrics_phase_names[phase], (unsigned long long)count);
+	}
+	fclose(out);
+
+	Response response;
+	response_start(&response, conn, 200, "OK");
+	response_header(&response, "Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+	response_header(&response, "Cache-Control", "no-store");
+	response_body(&response, text, text_len);
+	int status = response_send(&response);
+	free(text);
+	return status;
+}
+
+/*
+ * A GET that missed the cache: everything that may wait on the disk, run on the I/O
+ * pool when there is one. The loop thread fills in the request side, the pool thread
+ * the result, and send_opened_file() answers from it back on the loop thread
+ */
+typedef struct{
+	IoJob job;
+	char path[PATH_MAX];
+	signed char coding_for[1 << CODING_COUNT]; // choose_coding() for the request's Accept-Encoding and each set of sidecars
+	int want_body; // read files small enough for the in-memory cache
+
+	int fd; // -1 if the open failed
+	int error; // errno of the failure
+	int followed_symlink;
+	int codings; // sidecars found
+	int coding; // the one the client prefers, -1 for the original
+	int sidecar_fd; // -1 unless that sidecar opened as a regular file
+	struct stat file_stat;
+	struct stat sidecar_stat;
+	char *body; // want_body: contents, NULL when not read
+	char *sidecar_body;
+	uint64_t open_ns;
+} FileOpenJob;
+
+//Read all size bytes of a file into the heap. NULL on failure or if the file shrinks under us
+char *file_read_body(int fd, off_t size){
+	char *body = malloc(size > 0 ? size : 1);
+	off_t done = 0;
+	while (body != NULL && done < size){
+		ssize_t bytes_read = pread(fd, body + done, size - done, done);
+		if (bytes_read < 0 && errno == EINTR) continue;
+		if (bytes_read <= 0){
+			free(body);
+			return NULL;
+		}
+		done += bytes_read;
+	}
+	return body;
+}
+
+//1 if fd still has the size and modification time seen in file_stat
+int file_unchanged(int fd, const struct stat *file_stat){
+	struct stat now;
+	return fstat(fd, &now) == 0 && now.st_size == file_stat->st_size
+		&& now.st_mtim.tv_sec == file_stat->st_mtim.tv_sec && now.st_mtim.tv_nsec == file_stat->st_mtim.tv_nsec;
+}
+
+void file_open_run(IoJob *job){
+	FileOpenJob *open_job = (FileOpenJob *)job;
+	uint64_t start = monotonic_ns();
+
+	//1. Open the file beneath the document root. The kernel refuses paths that escape it
+	errno = 0;
+	open_job->fd = document_root_open_file(open_job->path, O_RDONLY, &open_job->followed_symlink);
+	if (open_job->fd < 0 || fstat(open_job->fd, &open_job->file_stat) != 0 || !S_ISREG(open_job->file_stat.st_mode)){
+		open_job->error = errno;
+		if (open_job->fd >= 0){
+			close(open_job->fd);
+			open_job->fd = -1;
+		}
+		open_job->open_ns = monotonic_ns() - start;
+		return;
+	}
+
+	//2. Look for pre-compressed sidecars and open the one the client prefers
+	open_job->codings = find_sidecars(open_job->path);
+	open_job->coding = open_job->coding_for[open_job->codings];
+	if (open_job->coding >= 0){
+		char sidecar_path[PATH_MAX + 8];
+		int sidecar_followed_symlink;
+		snprintf(sidecar_path, sizeof(sidecar_path), "%s%s", open_job->path, content_codings[open_job->coding].extension);
+		int sidecar_fd = document_root_open_file(sidecar_path, O_RDONLY | O_NOFOLLOW, &sidecar_followed_symlink);
+		if (sidecar_fd >= 0 && fstat(sidecar_fd, &open_job->sidecar_stat) == 0 && S_ISREG(open_job->sidecar_stat.st_mode)){
+			open_job->sidecar_fd = sidecar_fd;
+		}
+		else if (sidecar_fd >= 0){
+			close(sidecar_fd);
+		}
+	}
+	open_job->open_ns = monotonic_ns() - start;
+
+	//3. Read whatever the cache will keep in memory, so caching it does not touch the disk
+	if (open_job->want_body && !open_job->followed_symlink){
+		if (open_job->file_stat.st_size <= CACHE_MAX_FILE){
+			open_job->body = file_read_body(open_job->fd, open_job->file_stat.st_size);
+		}
+		if (open_job->sidecar_fd >= 0 && open_job->sidecar_stat.st_size <= CACHE_MAX_FILE){
+			open_job->sidecar_body = file_read_body(open_job->sidecar_fd, open_job->sidecar_stat.st_size);
+		}
+	}
+}
+
+void file_open_release(FileOpenJob *open_job){
+	if (open_job->fd >= 0){
+		close(open_job->fd);
+	}
+	if (open_job->sidecar_fd >= 0){
+		close(open_job->sidecar_fd);
+	}
+	free(open_job->body);
+	free(open_job->sidecar_body);
+	free(open_job);
+}
+
+//The connection picks the result up in conn_process(). If it has gone there is only cleaning up to do
+void file_open_complete(IoJob *job){
+	if (job->conn == NULL){
+		file_open_release((FileOpenJob *)job);
+	}
+}
+
+FileOpenJob *file_open_job_new(Connection *conn, const char *path, const char *accept_encoding){
+	FileOpenJob *open_job = calloc(1, sizeof(FileOpenJob));
+	if (open_job == NULL){
+		perror("Memory allocation failed\n");
+		return NULL;
+	}
+	open_job->job.run = file_open_run;
+	open_job->job.complete = file_open_complete;
+	open_job->job.conn = conn;
+	snprintf(open_job->path, sizeof(open_job->path), "%s", path);
+	for (int codings = 0; codings < 1 << CODING_COUNT; codings++){
+		open_job->coding_for[codings] = choose_coding(accept_encoding, codings);
+	}
+	open_job->want_body = file_cache.enabled && path_is_canonical(path);
+	open_job->fd = open_job->sidecar_fd = -1;
+	return open_job;
+}
+
+//Answer a GET from what file_open_run() found, caching the file on the way. Releases open_job. Returns 0 for success, 1 for failure
+int send_opened_file(Connection *conn, HttpRequest *request, FileOpenJob *open_job){
+	metrics_observe(PHASE_OPEN, open_job->open_ns);
+	if (open_job->fd < 0){
+		if (open_job->error == EXDEV){
+			fprintf(stderr, "Security: Malicious path attack attempted: %s\n", open_job->path);
+			send_simple_response(conn, 403, "Forbidden", "text/plain; charset=utf-8", "Forbidden\r\n");
+		}
+		else {
+			DEBUG_LOG(1, "Failed to open file %s: %s\n", open_job->path, strerror(open_job->error));
+			send_simple_response(conn, 404, "Not Found", "text/plain; charset=utf-8", "404 Not Found\r\n");
+		}
+		file_open_release(open_job);
+		return 1;
+	}
+
+	//1. Determine content type in response header. Cache entries keep it, so hits skip this
+	const char *path = open_job->path;
+	StaticFile file = { NULL, mime_type(path), NULL, 0, 0, cache_control_max_age(path), open_job->codings, open_job->fd, "", NULL };
+	static_file_stat(&file, &open_job->file_stat);
+	open_job->fd = -1;
+
+	//2. Cache the original (and the chosen sidecar below) if the request path names it canonically
+	// (no "..", "//" or symlinks) so inotify events for the file map back to this key. A file that
+	// changed since the pool looked at it may already have had its inotify event: leave it uncached
+	int cacheable = file_cache.enabled && !open_job->followed_symlink && path_is_canonical(path)
+		&& file_unchanged(file.fd, &open_job->file_stat);
+	char header[1024];
+	if (cacheable){
+		int header_len = render_static_header(header, sizeof(header), &file);
+		file.body = open_job->body;
+		file.entry = cache_insert(path, header, header_len, &file);
+		if (file.entry != NULL){
+			open_job->body = NULL;
+		}
+	}
+
+	//3. Send the sidecar the client prefers instead, if it opened
+	if (open_job->sidecar_fd >= 0){
+		close(file.fd);
+		file.fd = open_job->sidecar_fd;
+		open_job->sidecar_fd = -1;
+		file.entry = NULL;
+		file.content_encoding = content_codings[open_job->coding].name;
+		static_file_stat(&file, &open_job->sidecar_stat);
+		if (cacheable && file_unchanged(file.fd, &open_job->sidecar_stat)){
+			char key[PATH_MAX + 8];
+			cache_coding_key(key, sizeof(key), path, open_job->coding);
+			int header_len = render_static_header(header, sizeof(header), &file);
+			file.body = open_job->sidecar_body;
+			file.entry = cache_insert(key, header, header_len, &file);
+			if (file.entry != NULL){
+				open_job->sidecar_body = NULL;
+			}
+		}
+	}
+	if (file.entry != NULL && file.entry->body != NULL){
+		close(file.fd);
+		file.fd = -1;
+	}
+
+	//Send header then the file or the requested ranges of it. This takes ownership of file.fd
+	if (send_static_file(conn, request, &file) != 0){
+		fprintf(stderr, "Failed to send file: %s\n", path);
+	}
+	file_open_release(open_job);
+	return 0;
+}
+
+//=====================ROUTES==================
+/*
+ * Requests are dispatched through a route table. Handlers are registered with
+ * route_add() for a method and a path pattern before serving starts, and
+ * routes_compile() then indexes the trie they were inserted into. A pattern is
+ * exact ("/healthz"), takes one path segment per ":name" ("/users/:id/posts"), or
+ * has "*" (or "*name") as its last segment, which takes the rest of the path,
+ * possibly empty.
+ *
+ * The trie is a radix tree of the static text with a :param and a * child where a
+ * segment starts, so a lookup reads the path once: static text is tried before a
+ * :param and a :param before a *, and only where two of them overlap is the next
+ * one tried after the first fails. Parameters and the query string are kept as
+ * slices of the path and only percent-decoded when a handler asks for them, so the
+ * static file route pays nothing for them.
+ */
+#define ROUTE_METHODS (METHOD_PATCH + 1) //Handler slots per trie node, indexed by HttpMethod
+#define ROUTE_MAX_PARAMS 8 //Most :name and * parameters in one pattern
+
+const char *route_method_names[ROUTE_METHODS] = { "", "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH" };
+
+//A decoded path parameter, query string or form field
+typedef struct{
+	char *name;
+	char *value;
+} RouteParam;
+
+typedef struct RouteMatch RouteMatch;
+typedef int (*RouteHandler)(Connection *conn, HttpRequest *request, RouteMatch *match);
+
+typedef struct RouteNode{
+	char *label; // static text matched on the way into this node, empty for :param and * nodes
+	size_t label_len;
+	struct RouteNode **children; // static children, no two labels starting with the same byte
+	int child_count;
+	unsigned char child_index[256]; // first label byte to children index + 1, filled by routes_compile()
+	struct RouteNode *param; // :name child, one non-empty segment
+	struct RouteNode *wildcard; // * child, the rest of the path
+	RouteHandler handlers[ROUTE_METHODS]; // of the routes ending here, by method
+	int methods; // bit per method with a handler
+	char *param_names[ROUTE_MAX_PARAMS]; // of the routes ending here, in pattern order
+	int param_count;
+} RouteNode;
+
+struct RouteMatch{
+	HttpRequest *request;
+	RouteNode *node;
+	Slice params[ROUTE_MAX_PARAMS]; // raw values, into request->path
+	int param_count;
+	RouteParam *query; // decoded by the first route_query()
+	int query_count; // -1 until then
+};
+
+RouteNode route_root;
+
+RouteNode *route_node_new(const char *label, size_t len){
+	RouteNode *node = calloc(1, sizeof(RouteNode));
+	if (node == NULL || (node->label = strndup(label, len)) == NULL){
+		perror("Memory allocation failed\n");
+		free(node);
+		return NULL;
+	}
+	node->label_len = len;
+	return node;
+}
+
+//Index of node's static child whose label starts with c, -1 if there is none
+int route_child(RouteNode *node, char c){
+	for (int i = 0; i < node->child_count; i++){
+		if (node->children[i]->label[0] == c){
+			return i;
+		}
+	}
+	return -1;
+}
+
+//Returns 0 for success, 1 for failure
+int route_append_child(RouteNode *node, RouteNode *child){
+	RouteNode **children = realloc(node->children, (node->child_count + 1) * sizeof(RouteNode *));
+	if (children == NULL){
+		perror("Memory allocation failed\n");
+		return 1;
+	}
+	node->children = children;
+	node->children[node->child_count++] = child;
+	return 0;
+}
+
+//Insert static text below node, splitting a label where the two diverge. Returns the node the text ends at, NULL on failure
+RouteNode *route_insert_text(RouteNode *node, const char *text, size_t len){
+	while (len > 0){
+		int slot = route_child(node, text[0]);
+		if (slot < 0){
+			RouteNode *child = route_node_new(text, len);
+			if (child == NULL || route_append_child(node, child) != 0){
+				return NULL;
+			}
+			return child;
+		}
+
+		RouteNode *child = node->children[slot];
+		size_t common = 1;
+		while (common < child->label_len && common < len && child->label[common] == text[common]){
+			common++;
+		}
+		if (common < child->label_len){
+			//The shared start becomes a node of its own with the old child below it
+			RouteNode *shared = route_node_new(child->label, common);
+			if (shared == NULL || route_append_child(shared, child) != 0){
+				return NULL;
+			}
+			memmove(child->label, child->label + common, child->label_len - common + 1);
+			child->label_len -= common;
+			node->children[slot] = shared;
+			child = shared;
+		}
+		node = child;
+		text += common;
+		len -= common;
+	}
+	return node;
+}
+
+/*
+ * Register handler for method requests whose path matches pattern. Registering the
+ * same pattern twice for one method, or patterns that differ only in their parameter
+ * names, is an error. Call routes_compile() after the last one. Returns 0 for
+ * success, 1 for failure
+ */
+int route_add(HttpMethod method, const char *pattern, RouteHandler handler){
+	if (pattern[0] != '/' || method <= METHOD_OTHER || method >= ROUTE_METHODS){
+		fprintf(stderr, "Invalid route: %s %s\n", route_method_names[method < ROUTE_METHODS ? method : 0], pattern);
+		return 1;
+	}
+
+	//1. Walk the pattern, inserting static text and descending into :param and * children
+	RouteNode *node = &route_root;
+	char *names[ROUTE_MAX_PARAMS];
+	int name_count = 0;
+	const char *p = pattern;
+	while (*p != '\0' && node != NULL){
+		if ((*p == ':' || *p == '*') && p[-1] == '/'){
+			const char *end = *p == ':' ? strchrnul(p, '/') : p + strlen(p);
+			if (name_count == ROUTE_MAX_PARAMS || (*p == ':' && end == p + 1) || memchr(p, '/', end - p) != NULL){
+				fprintf(stderr, "Invalid route pattern: %s\n", pattern);
+				return 1;
+			}
+			names[name_count++] = end == p + 1 ? "*" : strndup(p + 1, end - p - 1);
+			RouteNode **child = *p == ':' ? &node->param : &node->wildcard;
+			if (*child == NULL){
+				*child = route_node_new("", 0);
+			}
+			node = *child;
+			p = end;
+			continue;
+		}
+		size_t len = 1;
+		while (p[len] != '\0' && !((p[len] == ':' || p[len] == '*') && p[len - 1] == '/')){
+			len++;
+		}
+		node = route_insert_text(node, p, len);
+		p += len;
+	}
+	if (node == NULL){
+		return 1;
+	}
+
+	//2. Every route ending at one node shares its parameter names
+	if (node->methods != 0){
+		int same = node->param_count == name_count;
+		for (int i = 0; same && i < name_count; i++){
+			same = strcmp(node->param_names[i], names[i]) == 0;
+		}
+		if (!same || node->handlers[method] != NULL){
+			fprintf(stderr, "Route %s %s conflicts with one registered before\n", route_method_names[method], pattern);
+			return 1;
+		}
+	}
+	memcpy(node->param_names, names, name_count * sizeof(char *));
+	node->param_count = name_count;
+	node->handlers[method] = handler;
+	node->methods |= 1 << method;
+	return 0;
+}
+
+//Index every node's static children by the first byte of their label
+void routes_compile(RouteNode *node){
+	memset(node->child_index, 0, sizeof(node->child_index));
+	for (int i = 0; i < node->child_count; i++){
+		node->child_index[(unsigned char)node->children[i]->label[0]] = i + 1;
+		routes_compile(node->children[i]);
+	}
+	if (node->param != NULL){
+		routes_compile(node->param);
+	}
+	if (node->wildcard != NULL){
+		routes_compile(node->wildcard);
+	}
+}
+
+/*
+ * The node below node, whose label has been matched, where the rest of path ends with
+ * a handler for method. The methods of every route the path matches are collected
+ * in allowed, for the Allow header of a 405
+ */
+RouteNode *route_find(RouteNode *node, const char *path, HttpMethod method, RouteMatch *match, int *allowed){
+	if (*path == '\0'){
+		*allowed |= node->methods;
+		if (node->handlers[method] != NULL){
+			return node;
+		}
+	}
+
+	//1. Static text
+	int slot = node->child_index[(unsigned char)*path];
+	if (slot != 0){
+		RouteNode *child = node->children[slot - 1];
+		if (strncmp(path, child->label, child->label_len) == 0){
+			RouteNode *found = route_find(child, path + child->label_len, method, match, allowed);
+			if (found != NULL){
+				return found;
+			}
+		}
+	}
+
+	//2. One segment. Children other than static ones only hang off labels ending in '/'
+	const char *base = match->request->path;
+	if (node->param != NULL && *path != '\0' && *path != '/' && match->param_count < ROUTE_MAX_PARAMS){
+		const char *end = strchrnul(path, '/');
+		match->params[match->param_count++] = (Slice){ path - base, end - path };
+		RouteNode *found = route_find(node->param, end, method, match, allowed);
+		if (found != NULL){
+			return found;
+		}
+		match->param_count--;
+	}
+
+	//3. The rest of the path
+	if (node->wildcard != NULL && match->param_count < ROUTE_MAX_PARAMS){
+		size_t len = strlen(path);
+		match->params[match->param_count++] = (Slice){ path - base, len };
+		RouteNode *found = route_find(node->wildcard, path + len, method, match, allowed);
+		if (found != NULL){
+			return found;
+		}
+		match->param_count--;
+	}
+	return NULL;
+}
+
+//Decode %XX escapes, and '+' to a space in form data, in place
+void url_decode(char *text, int plus_is_space){
+	char *out = text;
+	for (char *in = text; *in != '\0'; in++){
+		if (*in == '%' && isxdigit((unsigned char)in[1]) && isxdigit((unsigned char)in[2])){
+			char hex[3] = { in[1], in[2], '\0' };
+			*out++ = (char)strtol(hex, NULL, 16);
+			in += 2;
+		}
+		else {
+			*out++ = plus_is_space && *in == '+' ? ' ' : *in;
+		}
+	}
+	*out = '\0';
+}
+
+/*
+ * Split name=value&name=value text, which is modified, into pairs allocated from
+ * arena and decode them. Returns the number of pairs, -1 if memory ran out
+ */
+int url_decode_pairs(Arena *arena, char *text, RouteParam **pairs){
+	int count = 1;
+	for (char *c = text; *c != '\0'; c++){
+		count += *c == '&';
+	}
+	*pairs = arena_alloc(arena, count * sizeof(RouteParam));
+	if (*pairs == NULL){
+		return -1;
+	}
+
+	int decoded = 0;
+	char *save = NULL;
+	for (char *pair = strtok_r(text, "&", &save); pair != NULL; pair = strtok_r(NULL, "&", &save)){
+		char *equals = strchr(pair, '=');
+		if (equals != NULL){
+			*equals = '\0';
+		}
+		(*pairs)[decoded].name = pair;
+		(*pairs)[decoded].value = equals != NULL ? equals + 1 : pair + strlen(pair);
+		url_decode((*pairs)[decoded].name, 1);
+		url_decode((*pairs)[decoded].value, 1);
+		decoded++;
+	}
+	return decoded;
+}
+
+//Value of the first pair called name, NULL if there is none
+const char *route_pair_value(const RouteParam *pairs, int count, const char *name){
+	for (int i = 0; i < count; i++){
+		if (strcmp(pairs[i].name, name) == 0){
+			return pairs[i].value;
+		}
+	}
+	return NULL;
+}
+
+//Decoded value of the path parameter called name ("*" for an unnamed rest of the path), NULL if the route has none
+const char *route_param(RouteMatch *match, const char *name){
+	for (int i = 0; i < match->param_count; i++){
+		if (strcmp(match->node->param_names[i], name) != 0){
+			continue;
+		}
+		Slice *param = &match->params[i];
+		char *value = arena_alloc(match->request->arena, param->len + 1);
+		if (value == NULL){
+			return NULL;
+		}
+		memcpy(value, match->request->path + param->offset, param->len);
+		value[param->len] = '\0';
+		url_decode(value, 0);
+		return value;
+	}
+	return NULL;
+}
+
+//Decoded value of the query string parameter called name, NULL if it is absent
+const char *route_query(RouteMatch *match, const char *name){
+	if (match->query_count < 0){
+		match->query_count = 0;
+		if (match->request->query_string != NULL){
+			char *query = arena_strdup(match->request->arena, match->request->query_string);
+			int count = query != NULL ? url_decode_pairs(match->request->arena, query, &match->query) : -1;
+			match->query_count = count > 0 ? count : 0;
+		}
+	}
+	return route_pair_value(match->query, match->query_count, name);
+}
+
+//=====================HANDLERS==================
+//GET for any path without a route of its own: the file at that path in the bundle or under files/
+int static_file_route(Connection *conn, HttpRequest *client_request, RouteMatch *match){
+	DEBUG_LOG(1, "Handling GET request...\n");
+
+	char *request_path = client_request->path;
+
+	//Actual file path on disk
+	char *final_request_path;
+
+	//1. Handle root requests
+	if (strcmp(request_path, "/") == 0 || strcmp(request_path, "") == 0){
+		final_request_path = "/index.html";
+	} else {
+		final_request_path = request_path;
+	}
+
+	//Bundled files are served from its mapping with no filesystem calls, as is their preferred sidecar
+	char *accept_encoding = header_value(client_request, HEADER_ACCEPT_ENCODING);
+	const BundleEntry *packed = bundle_find(final_request_path);
+	if (packed != NULL){
+		int coding = choose_coding(accept_encoding, packed->codings);
+		if (coding >= 0){
+			char key[PATH_MAX + 8];
+			cache_coding_key(key, sizeof(key), final_request_path, coding);
+			const BundleEntry *variant = bundle_find(key);
+			packed = variant != NULL ? variant : packed;
+		}
+		CacheEntry bundled;
+		StaticFile file;
+		bundle_entry_describe(packed, &bundled);
+		static_file_from_entry(&file, &bundled);
+		return send_static_file(conn, client_request, &file);
+	}
+
+	//Cached files are served straight from memory, as is their preferred sidecar once it is cached too
+	CacheEntry *cached = cache_lookup(final_request_path);
+	if (cached != NULL){
+		int coding = choose_coding(accept_encoding, cached->codings);
+		if (coding >= 0){
+			char key[PATH_MAX + 8];
+			cache_coding_key(key, sizeof(key), final_request_path, coding);
+			cached = cache_lookup(key);
+		}
+	}
+	if (cached != NULL){
+		StaticFile file;
+		if (static_file_from_entry(&file, cached) == 0){
+			return send_static_file(conn, client_request, &file);
+		}
+	}
+
+	//2. Everything from here may wait on the disk: hand it to the I/O pool, or do it now without one
+	if (strlen(final_request_path) >= PATH_MAX){
+		send_simple_response(conn, 404, "Not Found", "text/plain; charset=utf-8", "404 Not Found\r\n");
+		return 1;
+	}
+	FileOpenJob *open_job = file_open_job_new(conn, final_request_path, accept_encoding);
+	if (open_job == NULL){
+		send_simple_response(conn, 500, "Internal Server Error", "text/plain; charset=utf-8", "Internal Server Error\r\n");
+		return 1;
+	}
+	if (io_pool_enabled(conn) && io_pool_submit(&open_job->job) == 0){
+		//conn_process() sends the response once the job is back
+		conn->io_job = &open_job->job;
+		return 0;
+	}
+	file_open_run(&open_job->job);
+	if (send_opened_file(conn, client_request, open_job) != 0){
+		return 1;
+	}
+	DEBUG_LOG(1, "Request handling done\n");
+	return 0;
+}
+
+int metrics_route(Connection *conn, HttpRequest *request, RouteMatch *match){
+	return metrics_send(conn);
+}
+
+//Liveness check for load balancers: answered by the serving process itself and never cached
+int health_route(Connection *conn, HttpRequest *request, RouteMatch *match){
+	Response response;
+	response_start(&response, conn, 200, "OK");
+	response_header(&response, "Content-Type", "text/plain; charset=utf-8");
+	response_header(&response, "Cache-Control", "no-store");
+	response_body(&response, "OK\r\n", 4);
+	return response_send(&response);
+}
+
+#define FORM_MAX_BODY 16384 //Largest form submission form_route() accepts
+
+//A form submission collected in the request arena as it arrives
+typedef struct{
+	char *data; // null terminated
+	size_t len;
+	size_t cap;
+} FormBody;
+
+int form_body_data(Connection *conn, const char *data, size_t len){
+	FormBody *form = conn->request.body_context;
+	if (form->len + len > FORM_MAX_BODY){
+		conn->keep_alive = 0;
+		send_simple_response(conn, 413, "Content Too Large", "text/plain; charset=utf-8", "Content Too Large\r\n");
+		return 1;
+	}
+	if (form->len + len + 1 > form->cap){
+		size_t new_cap = form->cap ? form->cap * 2 : 1024;
+		while (new_cap < form->len + len + 1){
+			new_cap *= 2;
+		}
+		char *new_data = arena_alloc(conn->request.arena, new_cap);
+		if (new_data == NULL){
+			send_simple_response(conn, 500, "Internal Server Error", "text/plain; charset=utf-8", "Internal Server Error\r\n");
+			return 1;
+		}
+		if (form->len > 0){
+			memcpy(new_data, form->data, form->len);
+		}
+		form->data = new_data;
+		form->cap = new_cap;
+	}
+	memcpy(form->data + form->len, data, len);
+	form->len += len;
+	form->data[form->len] = '\0';
+	return 0;
+}
+
+//The whole form is in: check its fields and confirm what was received
+int form_body_end(Connection *conn){
+	FormBody *form = conn->request.body_context;
+	char empty[1] = "";
+	RouteParam *fields = NULL;
+	int count = url_decode_pairs(conn->request.arena, form->data != NULL ? form->data : empty, &fields);
+	const char *name = route_pair_value(fields, count, "user_name");
+	const char *age = route_pair_value(fields, count, "user_age");
+	DEBUG_LOG(2, "Form fields: %d, user_name: %s, user_age: %s\n", count, name ? name : "-", age ? age : "-");
+
+	char *age_end = NULL;
+	long age_value = age != NULL ? strtol(age, &age_end, 10) : -1;
+	if (count < 0 || name == NULL || name[0] == '\0' || age == NULL || age_end == age || *age_end != '\0' || age_value < 0){
+		return send_simple_response(conn, 400, "Bad Request", "text/plain; charset=utf-8", "Expected user_name and a numeric user_age\r\n");
+	}
+
+	Response response;
+	response_start(&response, conn, 200, "OK");
+	response_header(&response, "Content-Type", "text/plain; charset=utf-8");
+	response_body_printf(&response, "Form processed for %s, age %ld\r\n", name, age_value);
+	return response_send(&response);
+}
+
+const BodyHandler form_body_handler = { form_body_data, form_body_end };
+
+//POST /form.html: the URL-encoded name and age fields of the form on that page, streamed into the arena
+int form_route(Connection *conn, HttpRequest *client_request, RouteMatch *match){
+	DEBUG_LOG(1, "Handling POST request...\n");
+
+	//1. A body is required, with Content-Length or chunked. The parser already validated and converted the length
+	if (!client_request->chunked && client_request->content_length <= 0){
+		DEBUG_LOG(1, "Content length not found or invalid\n");
+		send_simple_response(conn, 400, "Bad Request", "text/plain; charset=utf-8", "Bad Request\r\n");
+		return 1;
+	}
+	if (client_request->content_length > FORM_MAX_BODY){
+		conn->keep_alive = 0;
+		send_simple_response(conn, 413, "Content Too Large", "text/plain; charset=utf-8", "Content Too Large\r\n");
+		return 1;
+	}
+
+	//2. Only what an HTML form sends
+	char *content_type = header_value(client_request, HEADER_CONTENT_TYPE);
+	if (content_type != NULL && strncasecmp(content_type, "application/x-www-form-urlencoded", 33) != 0){
+		send_simple_response(conn, 415, "Unsupported Media Type", "text/plain; charset=utf-8", "Unsupported Media Type\r\n");
+		return 1;
+	}
+
+	//3. Receive the body as it arrives
+	FormBody *form = arena_alloc(client_request->arena, sizeof(FormBody));
+	if (form == NULL){
+		send_simple_response(conn, 500, "Internal Server Error", "text/plain; charset=utf-8", "Internal Server Error\r\n");
+		return 1;
+	}
+	memset(form, 0, sizeof(*form));
+	client_request->body_context = form;
+	client_request->body_handler = &form_body_handler;
+	return 0;
+}
+
+//Register the built-in routes and compile the table. Returns 0 for success, 1 for failure
+int routes_init(void){
+	if (route_add(METHOD_GET, "/metrics", metrics_route) != 0
+			|| route_add(METHOD_GET, "/healthz", health_route) != 0
+			|| route_add(METHOD_POST, "/form.html", form_route) != 0
+			|| route_add(METHOD_GET, "/*", static_file_route) != 0){
+		return 1;
+	}
+	routes_compile(&route_root);
+	return 0;
+}
+
+/*
+ * Dispatch a request to the handler of its route, called once the head has arrived.
+ * Handlers that need the body set request->body_handler and answer from its end
+ * callback. Returns 0 for success, 1 for failure
+ */
+int handle_method(Connection *conn, HttpRequest *client_request){
+	//Only the counts are set, params are written as they are matched
+	RouteMatch match;
+	match.request = client_request;
+	match.param_count = 0;
+	match.query = NULL;
+	match.query_count = -1;
+	int allowed = 0;
+	match.node = route_find(&route_root, client_request->path, client_request->method_id, &match, &allowed);
+	if (match.node != NULL){
+		return match.node->handlers[client_request->method_id](conn, client_request, &match);
+	}
+
+	if (allowed == 0){
+		send_simple_response(conn, 404, "Not Found", "text/plain; charset=utf-8", "404 Not Found\r\n");
+		return 1;
+	}
+
+	//The path has routes, just not for this method
+	DEBUG_LOG(1, "Method Not Allowed\n");
+	char allow[64] = "";
+	for (int method = METHOD_GET; method < ROUTE_METHODS; method++){
+		if (allowed & (1 << method)){
+			snprintf(allow + strlen(allow), sizeof(allow) - strlen(allow), "%s%s", allow[0] ? ", " : "", route_method_names[method]);
+		}
+	}
+	Response response;
+	response_start(&response, conn, 405, "Method Not Allowed");
+	response_header(&response, "Allow", "%s", allow);
+	response_header(&response, "Content-Type", "text/plain; charset=utf-8");
+	response_body(&response, "Method Not Allowed\r\n", 20);
+	response_send(&response);
+	return 1;
+}
+
+//Signal handler method
+void signal_handler(int sig){
+	pid_t pid;
+	int status;
+
+	while((pid = waitpid(-1, &status, WNOHANG)) > 0){
+		DEBUG_LOG(2, "Process %d has been terminated.\n", pid);
+	}
+}
+
+//Record the client's IP address for the access log. IPv4 clients of the dual-stack listener are logged as plain IPv4
+void conn_set_peer(Connection *conn, struct sockaddr_storage *client_addy){
+	if (client_addy->ss_family == AF_INET6){
+		struct in6_addr *address = &((struct sockaddr_in6 *)client_addy)->sin6_addr;
+		if (IN6_IS_ADDR_V4MAPPED(address)){
+			inet_ntop(AF_INET, &address->s6_addr[12], conn->peer, sizeof(conn->peer));
+		}
+		else {
+			inet_ntop(AF_INET6, address, conn->peer, sizeof(conn->peer));
+		}
+	}
+	else if (client_addy->ss_family == AF_INET){
+		inet_ntop(AF_INET, &((struct sockaddr_in *)client_addy)->sin_addr, conn->peer, sizeof(conn->peer));
+	}
+	DEBUG_LOG(1, "Client's IP Address: %s\n", conn->peer);
+}
+
+//=====================CONNECTIONS==================
+/*
+ * Reading, parsing and dispatching requests, shared by the fork and event loop
+ * modes. Bytes are read into a growable per-connection buffer and fed to the
+ * resumable parser. A request is handed to handle_method() as soon as its head has
+ * arrived; its body is then streamed to the handler's BodyHandler as it comes in,
+ * with at most BODY_BUFFER read ahead, so no handler ever blocks on the socket.
+ */
+typedef enum{
+	PROCESS_MORE,  // need more bytes before a request is complete
+	PROCESS_DONE,  // one request has been handled
+	PROCESS_ERROR  // connection must be closed
+} ProcessResult;
+
+//Release everything a connection owns except the socket itself
+void conn_free(Connection *conn){
+	timer_cancel(&timer_wheel, &conn->timer);
+
+	//A job still on the I/O pool cleans up after itself once it finds conn gone
+	if (conn->io_job != NULL){
+		conn->io_job->conn = NULL;
+		if (conn->io_job->done){
+			conn->io_job->complete(conn->io_job);
+		}
+		conn->io_job = NULL;
+	}
+	conn_discard_output(conn);
+	arena_free(&conn->arena);
+	free(conn->in);
+	free(conn->out);
+	free(conn->segments);
+	conn->request.headers = NULL;
+	conn->in = conn->out = NULL;
+	conn->segments = NULL;
+	metrics_add(&metrics->active_connections, -1);
+}
+
+//Minimal response for requests that never reach handle_method()
+void send_error_response(Connection *conn, int status){
+	const char *reason;
+	switch (status){
+		case 411: reason = "Length Required"; break;
+		case 413: reason = "Content Too Large"; break;
+		case 417: reason = "Expectation Failed"; break;
+		case 408: reason = "Request Timeout"; break;
+		case 431: reason = "Request Header Fields Too Large"; break;
+		case 500: reason = "Internal Server Error"; break;
+		case 501: reason = "Not Implemented"; break;
+		default: status = 400; reason = "Bad Request"; break;
+	}
+	char body[64];
+	snprintf(body, sizeof(body), "%s\r\n", reason);
+	conn->keep_alive = 0;
+	send_simple_response(conn, status, reason, "text/plain; charset=utf-8", body);
+}
+
+//Most bytes worth buffering for the current request: its head, or a bounded amount of body ahead of the handler (TCP flow control holds back the rest)
+size_t conn_read_limit(Connection *conn){
+	HttpRequest *request = &conn->request;
+	return request->parse_state == PARSE_BODY ? request->body_pos + BODY_BUFFER : config.max_head_size + 1;
+}
+
+//Make room for len more bytes in conn->in, plus the byte that null terminates it. Returns 0 for success, 1 for failure
+int conn_reserve_input(Connection *conn, size_t len){
+	if (conn->in_cap - conn->in_len >= len + 1){
+		return 0;
+	}
+	size_t new_cap = conn->in_cap ? conn->in_cap * 2 : READ_CHUNK * 2;
+	while (new_cap - conn->in_len < len + 1){
+		new_cap *= 2;
+	}
+	char *new_in = realloc(conn->in, new_cap);
+	if (new_in == NULL){
+		perror("Memory allocation failed\n");
+		return 1;
+	}
+	conn->in = new_in;
+	conn->in_cap = new_cap;
+	return 0;
+}
+
+/*
+ * Read from the socket into conn->in. Non-blocking connections drain the socket until
+ * it would block, blocking ones do a single read. Stops early once the buffer holds
+ * the current request so a pipelining client cannot grow it without bound.
+ * Returns 0 on success (EAGAIN or buffer full), 1 if the peer closed or on error,
+ * 2 if a blocking read hit its SO_RCVTIMEO
+ */
+int conn_read(Connection *conn, int *readable){
+	while (*readable){
+		if (conn->in_len >= conn->in_start + conn_read_limit(conn)){
+			return 0;
+		}
+		if (conn_reserve_input(conn, READ_CHUNK) != 0){
+			return 1;
+		}
+
+		ssize_t valread = read(conn->fd, conn->in + conn->in_len, conn->in_cap - conn->in_len - 1);
+		if (valread > 0){
+			metrics_add(&metrics->bytes_in, valread);
+			conn->in_len += valread;
+			conn->in[conn->in_len] = '\0';
+			if (!conn->nonblocking){
+				*readable = 0;
+			}
+		}
+		else if (valread == 0){
+			return 1;
+		}
+		else if (errno == EAGAIN || errno == EWOULDBLOCK){
+			//A blocking socket only gets here when its SO_RCVTIMEO expires
+			if (!conn->nonblocking){
+				return 2;
+			}
+			*readable = 0;
+		}
+		else if (errno != EINTR){
+			perror("Read failed\n");
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//Append the access log line for a request that has just been answered
+void access_log_request(Connection *conn, HttpRequest *request, uint64_t duration_ns){
+	if (access_log.fd < 0){
+		return;
+	}
+	if (access_log.sample > 1 && ++access_log.requests % access_log.sample != 0 && conn->status < 500){
+		return;
+	}
+	access_log_clock();
+
+	const char *method = request->method[0] ? request->method : NULL;
+	LogLine line;
+	line.len = 0;
+	if (access_log.format == LOG_JSON){
+		log_printf(&line, "{\"time\":\"%s\",\"remote\":\"%s\",\"method\":\"", access_log.clock_iso, conn->peer);
+		log_escaped(&line, method, 1);
+		log_printf(&line, "\",\"path\":\"");
+		log_escaped(&line, request->path, 1);
+		log_printf(&line, "\",\"query\":\"");
+		log_escaped(&line, request->query_string, 1);
+		log_printf(&line, "\",\"protocol\":\"");
+		log_escaped(&line, request->protocol, 1);
+		log_printf(&line, "\",\"status\":%d,\"bytes\":%lld,\"duration_us\":%llu,\"referer\":\"",
+			conn->status, (long long)conn->response_bytes, (unsigned long long)(duration_ns / 1000));
+		log_escaped(&line, request->path ? header_value(request, HEADER_REFERER) : NULL, 1);
+		log_printf(&line, "\",\"user_agent\":\"");
+		log_escaped(&line, request->path ? header_value(request, HEADER_USER_AGENT) : NULL, 1);
+		log_printf(&line, "\"}\n");
+	}
+	else {
+		//host ident authuser [date] "request" status bytes
+		log_printf(&line, "%s - - [%s] \"", conn->peer, access_log.clock_common);
+		log_escaped(&line, method, 0);
+		log_printf(&line, " ");
+		log_escaped(&line, request->path, 0);
+		if (request->query_string != NULL){
+			log_printf(&line, "?");
+			log_escaped(&line, request->query_string, 0);
+		}
+		log_printf(&line, " ");
+		log_escaped(&line, request->protocol, 0);
+		if (conn->response_bytes > 0){
+			log_printf(&line, "\" %d %lld", conn->status, (long long)conn->response_bytes);
+		}
+		else {
+			log_printf(&line, "\" %d -", conn->status);
+		}
+		if (access_log.format == LOG_COMBINED){
+			log_printf(&line, " \"");
+			log_escaped(&line, request->path ? header_value(request, HEADER_REFERER) : NULL, 0);
+			log_printf(&line, "\" \"");
+			log_escaped(&line, request->path ? header_value(request, HEADER_USER_AGENT) : NULL, 0);
+			log_printf(&line, "\"");
+		}
+		log_printf(&line, "\n");
+	}
+	//A truncated line still ends the record
+	if (line.data[line.len - 1] != '\n'){
+		line.data[line.len - 1] = '\n';
+	}
+	access_log_push(&line);
+}
+
+//Account for the request, then move past it. With close the connection is closed without reading further
+ProcessResult conn_finish_request(Connection *conn, HttpRequest *request, int close){
+	uint64_t handled_ns = monotonic_ns() - conn->dispatch_ns;
+	conn->requests++;
+	conn->timeout_kind = TIMEOUT_NONE;
+	metrics_observe(PHASE_REQUEST, handled_ns);
+	metrics_count_request(request->method_id, conn->status);
+	access_log_request(conn, request, handled_ns);
+
+	//Anything the client pipelined after it stays buffered
+	if (close){
+		conn->keep_alive = 0;
+		conn->in_start = conn->in_len;
+	}
+	else {
+		conn->in_start += request->body_pos;
+	}
+	if (!conn->keep_alive){
+		DEBUG_LOG(1, "%s completed, closing connection\n", request->method);
+		conn->state = CONN_CLOSING;
+	}
+	request_reset(request);
+	arena_reset(&conn->arena);
+	return PROCESS_DONE;
+}
+
+/*
+ * Check the body framing against the limits and Expect before the handler runs.
+ * Returns 0 to go on, 1 if an error response was sent and the body must not be read
+ */
+int request_accept_body(Connection *conn, HttpRequest *request, size_t buffered){
+	if (!request->chunked && request->content_length > config.max_body_size){
+		send_error_response(conn, 413);
+		return 1;
+	}
+	char *expect = header_value(request, HEADER_EXPECT);
+	if (expect != NULL){
+		if (strcasecmp(expect, "100-continue") != 0){
+			send_error_response(conn, 417);
+			return 1;
+		}
+		//Only worth answering when the client is really holding a body back
+		request->expect_continue = (request->chunked || request->content_length > 0)
+			&& buffered == request->head_len && strcmp(request->protocol, "HTTP/1.1") == 0;
+	}
+	return 0;
+}
+
+//Parse and handle at most one request from conn->in, streaming its body to the handler as it arrives
+ProcessResult conn_process(Connection *conn){
+	HttpRequest *request = &conn->request;
+	char *buffer = conn->in + conn->in_start;
+	size_t len = conn->in_len - conn->in_start;
+
+	if (conn->io_job != NULL && conn->io_job->run == file_open_run){
+		//The handler's file work is on the I/O pool: answer once it is back
+		if (!conn->io_job->done){
+			return PROCESS_MORE;
+		}
+		FileOpenJob *open_job = (FileOpenJob *)conn->io_job;
+		conn->io_job = NULL;
+		request_bind(request, buffer);
+		send_opened_file(conn, request, open_job);
+		if (request->expect_continue){
+			return conn_finish_request(conn, request, 1);
+		}
+	}
+	else if (!request->dispatched){
+		//6. Parse whatever has arrived so far
+		uint64_t parse_start = monotonic_ns();
+		ParseResult parsed = parse_client_request(request, buffer, len);
+		uint64_t parse_end = monotonic_ns();
+		conn->parse_ns += parse_end - parse_start;
+		if (parsed == PARSE_INCOMPLETE){
+			return PROCESS_MORE;
+		}
+		metrics_observe(PHASE_PARSE, conn->parse_ns);
+		conn->parse_ns = 0;
+		if (parsed == PARSE_FAILED){
+			send_error_response(conn, request->error_status);
+			metrics_add(&metrics->parse_failures, 1);
+			metrics_count_request(request->method_id, conn->status);
+			access_log_request(conn, request, monotonic_ns() - parse_end);
+			request_reset(request);
+			arena_reset(&conn->arena);
+			conn->in_start = conn->in_len;
+			conn->state = CONN_CLOSING;
+			return PROCESS_DONE;
+		}
+
+		//7. Hand the head over. The handler either answers now or registers a body handler
+		request->dispatched = 1;
+		conn->dispatch_ns = parse_end;
+		conn->status = 0;
+		if (request_accept_body(conn, request, len) != 0){
+			return conn_finish_request(conn, request, 1);
+		}
+
+		//Determine the connection first so every response carries the right Connection header
+		int keep_alive = connection_close_or_keep_alive(request) && conn->requests + 1 < config.keep_alive_max;
+		conn->keep_alive = request->expect_continue ? 0 : keep_alive;
+		if (handle_method(conn, request) != 0){
+			DEBUG_LOG(1, "Request handling failed for client socket\n");
+		}
+		if (conn->io_job != NULL && conn->io_job->run == file_open_run){
+			return PROCESS_MORE;
+		}
+		if (request->expect_continue){
+			//Answered without the body, which the client may now never send: do not wait for it
+			if (request->body_handler == NULL || conn->status != 0){
+				return conn_finish_request(conn, request, 1);
+			}
+			conn->keep_alive = keep_alive;
+			if (conn_queue(conn, "HTTP/1.1 100 Continue\r\n\r\n", 25) != 0){
+				return PROCESS_ERROR;
+			}
+		}
+	}
+	else {
+		//The input buffer may have moved since the head was parsed
+		request_bind(request, buffer);
+	}
+
+	//8. Stream the body
+	ParseResult body = body_feed(conn, request, buffer, len);
+	if (body == PARSE_INCOMPLETE){
+		//Drop decoded bytes so the buffer holds the head plus at most BODY_BUFFER of body
+		size_t consumed = request->body_pos - request->head_len;
+		if (consumed > 0){
+			memmove(buffer + request->head_len, buffer + request->body_pos, len - request->body_pos);
+			conn->in_len -= consumed;
+			conn->in[conn->in_len] = '\0';
+			request->body_pos = request->head_len;
+		}
+		return PROCESS_MORE;
+	}
+	if (body == PARSE_FAILED){
+		if (request->error_status != 0){
+			metrics_add(&metrics->parse_failures, 1);
+			if (conn->status == 0){
+				send_error_response(conn, request->error_status);
+			}
+		}
+		return conn_finish_request(conn, request, 1);
+	}
+	if (request->body_handler != NULL && request->body_handler->end(conn) != 0){
+		DEBUG_LOG(1, "Request handling failed for client socket\n");
+	}
+	return conn_finish_request(conn, request, 0);
+}
+
+/*
+ * Handle every complete request already buffered (HTTP/1.1 pipelining). Responses are
+ * queued in request order and flushed together by the caller, so a burst of pipelined
+ * GETs goes out in as few writev()/sendfile() calls as possible. A batch stops early
+ * once enough output is queued so a client that never reads cannot grow it without
+ * bound. Returns the number of requests handled, or -1 if the connection must be closed
+ */
+int conn_process_batch(Connection *conn){
+	int handled = 0;
+	int batching = conn->batching;
+	conn->batching = 1;
+	while (conn->state == CONN_READING && handled < PIPELINE_MAX_REQUESTS && conn->out_len < PIPELINE_MAX_QUEUED){
+		ProcessResult result = conn_process(conn);
+		if (result == PROCESS_ERROR){
+			handled = -1;
+			break;
+		}
+		if (result == PROCESS_MORE){
+			break;
+		}
+		handled++;
+	}
+	conn->batching = batching;
+
+	//Move the unconsumed bytes (the next, partial request) to the front of the buffer
+	if (conn->in_start > 0){
+		memmove(conn->in, conn->in + conn->in_start, conn->in_len - conn->in_start);
+		conn->in_len -= conn->in_start;
+		conn->in_start = 0;
+	}
+
+	if (handled > 0 && conn->state == CONN_READING){
+		conn->state = CONN_WRITING;
+	}
+	return handled;
+}
+
+//=====================FORK MODE==================
+/*
+ * Original process-per-connection model. The parent accepts, waits on the
+ * semaphore for a free slot and forks a child that serves the connection
+ * with blocking reads until the client stops keeping it alive.
+ */
+/*
+ * Fork mode has no timer wheel: each blocking read gets an SO_RCVTIMEO covering what
+ * is left of the current wait. Header and idle waits count from when they began, so
+ * trickling bytes does not extend them; a body wait restarts with every read.
+ * Returns 0 with the timeout set, 1 if the wait has already run out
+ */
+int conn_set_read_timeout(Connection *conn){
+	TimeoutKind kind = TIMEOUT_IDLE;
+	if (conn->request.dispatched){
+		kind = TIMEOUT_BODY;
+	}
+	else if (conn->in_len > conn->in_start || conn->requests == 0){
+		kind = TIMEOUT_HEADER;
+	}
+	uint64_t now = monotonic_ns();
+	if (kind != conn->timeout_kind){
+		conn->timeout_kind = kind;
+		conn->waiting_since_ns = now;
+	}
+	long remaining_ms = config.timeouts_ms[kind];
+	if (kind != TIMEOUT_BODY){
+		remaining_ms -= (long)((now - conn->waiting_since_ns) / 1000000);
+	}
+	if (remaining_ms <= 0){
+		return 1;
+	}
+	struct timeval timeout = { remaining_ms / 1000, (remaining_ms % 1000) * 1000 };
+	setsockopt(conn->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	return 0;
+}
+
+int run_fork_loop(int server_fd){
+	//Call signal_handler when a child process terminates
+	struct sigaction sa;
+	sa.sa_handler = signal_handler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = SA_RESTART;
+	if(sigaction(SIGCHLD, &sa, NULL) == -1){
+		perror("Sigaction failed\n");
+		return 1;
+	}
+
+	//Semaphore memory mapping
+	semaphore = mmap(NULL, sizeof(sem_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (semaphore == MAP_FAILED){
+		perror("Sempahore memory mapping failed\n");
+		return 1;
+	}
+
+	//Initialize semaphore with 10 max processes
+	if(sem_init(semaphore, 1, OPEN_MAX) != 0){
+		perror("Semaphore initialization failed\n");
+		return 1;
+	}
+	// 4. Accept connections.
+	while(1){
+		struct sockaddr_storage client_addy;
+		socklen_t client_addy_len = sizeof(client_addy);
+		int client_socket = accept4(server_fd, (struct sockaddr *) &client_addy, &client_addy_len, SOCK_CLOEXEC);
+		if (client_socket < 0){
+			perror("Connection failed\n");
+			continue;
+		}
+
+		//Check if there's an available slot before creating a new child
+		if (sem_wait(semaphore) != 0){
+			perror("sem_wait failed\n");
+			close(client_socket);
+			continue;
+		}
+
+		//Create child process to handle client request
+		pid_t pid = fork();
+
+		if (pid == -1){
+			perror("Fork failed\n");
+			sem_post(semaphore);
+			close(client_socket);
+			continue;
+		}
+
+		if (pid == 0){
+			
+			//Child closes listening socket
+			close(server_fd);
+
+			//Blocking connection: conn_write loops until the whole response is sent
+			Connection conn;
+			conn_init(&conn, client_socket, 0);
+			conn_set_peer(&conn, &client_addy);
+			access_log_start();
+
+			//A client that stops reading gives up the slot after the write timeout
+			struct timeval send_timeout = { config.timeouts_ms[TIMEOUT_WRITE] / 1000, (config.timeouts_ms[TIMEOUT_WRITE] % 1000) * 1000 };
+			setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+
+			//Serve requests until the client closes or stops keeping the connection alive
+			int readable = 1;
+			while (1){
+				int handled = conn_process_batch(&conn);
+				if (handled < 0 || conn_flush(&conn) != 0 || conn.state == CONN_CLOSING){
+					break;
+				}
+				conn.state = CONN_READING;
+				if (handled > 0){
+					continue;
+				}
+
+				// 5. Read data, giving up when the current wait times out
+				readable = 1;
+				int read_result = conn_set_read_timeout(&conn) == 0 ? conn_read(&conn, &readable) : 2;
+				if (read_result == 2 && (conn.request.dispatched || conn.in_len > conn.in_start)){
+					send_error_response(&conn, 408);
+					conn_flush(&conn);
+				}
+				if (read_result != 0){
+					break;
+				}
+			}
+
+			//Release the slot
+			sem_post(semaphore);
+			access_log_stop();
+
+			//Close client socket for child process
+			conn_free(&conn);
 			close(client_socket);
 			exit(0);
 		}
-		
+		
+
+
+		//Close client socket for parent process
+		close(client_socket);
+	}
+	sem_destroy(semaphore);
+	munmap(semaphore, sizeof(sem_t));
+	return 0;
+}
+
+//=====================EVENT LOOP MODE==================
+/*
+ * Single process, edge-triggered epoll loop. Every socket is non-blocking and
+ * each connection moves through CONN_READING -> CONN_WRITING/CONN_CLOSING and
+ * back, so one slow client never holds up the others.
+ */
+void conn_close(int epoll_fd, Connection *conn){
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+	close(conn->fd);
+	conn_free(conn);
+	free(conn);
+}
+
+/*
+ * Arm the timer for whatever the connection now waits for. Header and idle
+ * deadlines run from when that wait began; body and write deadlines restart on
+ * every event, since an event while waiting for either means progress
+ */
+void conn_schedule_timeout(Connection *conn){
+	TimeoutKind kind;
+	int restart = 0;
+	if (conn_pending(conn)){
+		kind = TIMEOUT_WRITE;
+		restart = 1;
+	}
+	else if (conn->request.dispatched){
+		kind = TIMEOUT_BODY;
+		restart = 1;
+	}
+	else if (conn->in_len > conn->in_start || conn->requests == 0){
+		kind = TIMEOUT_HEADER;
+	}
+	else {
+		kind = TIMEOUT_IDLE;
+	}
+	if (kind != conn->timeout_kind || restart){
+		conn->timeout_kind = kind;
+		timer_arm(&timer_wheel, &conn->timer, config.timeouts_ms[kind]);
+	}
+}
+
+//1 if a timeout caught the client part way through sending a request
+int conn_mid_request(Connection *conn){
+	return conn->timeout_kind == TIMEOUT_BODY || (conn->timeout_kind == TIMEOUT_HEADER && conn->in_len > conn->in_start);
+}
+
+//Timer wheel callback: the connection waited too long. A stalled request is answered with 408 first
+void conn_timeout(TimerNode *node, void *context){
+	Connection *conn = (Connection *)((char *)node - offsetof(Connection, timer));
+	int epoll_fd = *(int *)context;
+	if (conn_mid_request(conn) && !conn_pending(conn)){
+		send_error_response(conn, 408);
+		metrics_count_request(conn->request.method_id, conn->status);
+	}
+	DEBUG_LOG(1, "Connection timed out waiting (%d)\n", conn->timeout_kind);
+	conn_close(epoll_fd, conn);
+}
+
+//Advance a connection's state machine after an epoll event. Closes and frees it when done
+void conn_handle_event(int epoll_fd, Connection *conn, uint32_t events){
+	int readable = (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+	int peer_closed = 0;
+
+	while (1){
+		//Write: responses are queued, drain them before handling more requests
+		if (conn->state == CONN_READING && conn_pending(conn) && conn_flush(conn) != 0){
+			conn_close(epoll_fd, conn);
+			return;
+		}
+		if (conn->state != CONN_READING){
+			if (conn_flush(conn) != 0){
+				conn_close(epoll_fd, conn);
+				return;
+			}
+			if (conn_pending(conn)){
+				conn_schedule_timeout(conn);
+				return; //wait for EPOLLOUT
+			}
+			if (conn->state == CONN_CLOSING){
+				conn_close(epoll_fd, conn);
+				return;
+			}
+			conn->state = CONN_READING;
+		}
+
+		//Read
+		if (!peer_closed && conn_read(conn, &readable) != 0){
+			peer_closed = 1;
+		}
+
+		//Parse + handle everything buffered, then go back to write it out
+		int handled = conn_process_batch(conn);
+		if (handled < 0){
+			conn_close(epoll_fd, conn);
+			return;
+		}
+		if (handled == 0){
+			//A 100 Continue may be queued while the body is still to come
+			if (conn_pending(conn) && conn_flush(conn) != 0){
+				conn_close(epoll_fd, conn);
+				return;
+			}
+			//A request waiting on the I/O pool is still answered, even if the client has stopped sending
+			if (peer_closed && conn->io_job == NULL){
+				conn_close(epoll_fd, conn);
+				return;
+			}
+			//Reading stopped at the body read-ahead limit and the handler has since consumed it
+			if (readable && conn->io_job == NULL){
+				continue;
+			}
+			conn_schedule_timeout(conn);
+			return;
+		}
+	}
+}
+
+//Finish the jobs the I/O pool has done and carry on with their connections
+void conn_complete_io(int epoll_fd){
+	uint64_t count;
+	if (read(io_pool.event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN){
+		perror("Reading the I/O pool eventfd failed\n");
+	}
+	IoJob *job = io_pool_completed();
+	while (job != NULL){
+		IoJob *next = job->next;
+		Connection *conn = job->conn;
+		job->complete(job);
+		if (conn != NULL){
+			conn_handle_event(epoll_fd, conn, EPOLLIN);
+		}
+		job = next;
+	}
+}
+
+int set_nonblocking(int fd){
+	int flags = fcntl(fd, F_GETFL, 0);
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0){
+		return 1;
+	}
+	return 0;
+}
+
+//Lift the descriptor limit so a loop can hold tens of thousands of connections
+void raise_fd_limit(void){
+	struct rlimit fd_limit;
+	if (getrlimit(RLIMIT_NOFILE, &fd_limit) == 0 && fd_limit.rlim_cur < fd_limit.rlim_max){
+		fd_limit.rlim_cur = fd_limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &fd_limit);
+	}
+}
+
+/*
+ * Accept up to ACCEPT_BATCH connections and register them with epoll. With
+ * TCP_DEFER_ACCEPT their first request has already arrived, so it is read and
+ * handled right away instead of after another epoll_wait(). Returns 1 if the batch
+ * was used up and more connections may be waiting, 0 once the queue is empty
+ */
+int accept_connections(int server_fd, int epoll_fd){
+	for (int accepted = 0; accepted < ACCEPT_BATCH; accepted++){
+		struct sockaddr_storage client_addy;
+		socklen_t client_addy_len = sizeof(client_addy);
+		int client_socket = accept4(server_fd, (struct sockaddr *) &client_addy, &client_addy_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (client_socket < 0){
+			if (errno == EINTR || errno == ECONNABORTED){
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK){
+				perror("Connection failed\n");
+			}
+			return 0;
+		}
+
+		Connection *new_conn = malloc(sizeof(Connection));
+		if (new_conn == NULL){
+			perror("Memory allocation failed\n");
+			close(client_socket);
+			continue;
+		}
+		conn_init(new_conn, client_socket, 1);
+		conn_set_peer(new_conn, &client_addy);
+		conn_schedule_timeout(new_conn);
+
+		struct epoll_event client_event = {0};
+		client_event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+		client_event.data.ptr = new_conn;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_socket, &client_event) < 0){
+			perror("epoll_ctl failed for client socket\n");
+			close(client_socket);
+			conn_free(new_conn);
+			free(new_conn);
+			continue;
+		}
+		if (config.defer_accept > 0){
+			conn_handle_event(epoll_fd, new_conn, EPOLLIN);
+		}
+	}
+	return 1;
+}
+
+int run_event_loop(int server_fd){
+	raise_fd_limit();
+
+	if (set_nonblocking(server_fd) != 0){
+		perror("Failed to make listening socket non-blocking\n");
+		return 1;
+	}
+
+	int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd < 0){
+		perror("epoll_create1 failed\n");
+		return 1;
+	}
+	if (access_log_start() != 0){
+		close(epoll_fd);
+		return 1;
+	}
+
+	//The listener is registered with a NULL pointer, the cache's inotify descriptor with
+	//&file_cache, the I/O pool's eventfd with &io_pool and connections with their Connection
+	if (io_pool_start() != 0){
+		close(epoll_fd);
+		return 1;
+	}
+	if (io_pool.event_fd >= 0){
+		struct epoll_event pool_event = {0};
+		pool_event.events = EPOLLIN | EPOLLET;
+		pool_event.data.ptr = &io_pool;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, io_pool.event_fd, &pool_event) < 0){
+			perror("epoll_ctl failed for the I/O pool\n");
+			close(epoll_fd);
+			return 1;
+		}
+	}
+
+	int inotify_fd = cache_start_watching(document_root.name);
+	if (inotify_fd >= 0){
+		struct epoll_event inotify_event = {0};
+		inotify_event.events = EPOLLIN | EPOLLET;
+		inotify_event.data.ptr = &file_cache;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, inotify_fd, &inotify_event) < 0){
+			perror("epoll_ctl failed for inotify, file cache disabled\n");
+			file_cache.enabled = 0;
+		}
+	}
+
+	struct epoll_event listen_event = {0};
+	listen_event.events = EPOLLIN | EPOLLET;
+	listen_event.data.ptr = NULL;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, &listen_event) < 0){
+		perror("epoll_ctl failed for listening socket\n");
+		close(epoll_fd);
+		return 1;
+	}
+
+	struct epoll_event events[MAX_EVENTS];
+	timer_wheel_init(&timer_wheel);
+	int accept_pending = 0; // the last batch was full, poll without sleeping until the queue is drained
+	while(1){
+		int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, accept_pending ? 0 : timer_wheel_wait_ms(&timer_wheel));
+		if (ready < 0){
+			if (errno == EINTR) continue;
+			perror("epoll_wait failed\n");
+			break;
+		}
+
+
+		int io_completed = 0;
+		for (int i = 0; i < ready; i++){
+			if (events[i].data.ptr == &file_cache){
+				cache_handle_inotify();
+				continue;
+			}
+			if (events[i].data.ptr == &io_pool){
+				io_completed = 1;
+				continue;
+			}
+
+			Connection *conn = events[i].data.ptr;
+			if (conn != NULL){
+				conn_handle_event(epoll_fd, conn, events[i].events);
+				continue;
+			}
+
+			accept_pending = 1;
+		}
+
+		// 4. Accept connections once the ready ones have had their turn. The listener is edge-triggered,
+		// so after a full batch it is polled again on the next pass instead of waiting for another edge
+		if (accept_pending){
+			accept_pending = accept_connections(server_fd, epoll_fd);
+		}
+
+		//Resume connections and expire timeouts once this batch of events is done with its connections
+		if (io_completed){
+			conn_complete_io(epoll_fd);
+		}
+		timer_wheel_advance(&timer_wheel, conn_timeout, &epoll_fd);
+	}
+
+	io_pool_stop();
+	access_log_stop();
+	close(epoll_fd);
+	return 1;
+}
+
+//=====================IO_URING MODE==================
+/*
+ * The event loop's request handling with io_uring doing the socket I/O, driven
+ * through the raw syscalls so there is nothing extra to link. One ring per process:
+ *  - one multishot accept on the listener posts a completion per new connection
+ *  - each connection has one multishot recv that takes buffers from a provided
+ *    buffer ring, so no read() calls and no per-connection buffer waits in the kernel
+ *  - queued output goes out as one send of the memory run at the head of the queue,
+ *    linked to splice()s of the next file segment through a per-connection pipe
+ * Requests go through the same conn_process_batch() as the other modes with every
+ * response queued. Everything prepared while a batch of completions is handled is
+ * submitted by the next io_uring_enter(), which also waits for more, so a cached
+ * GET costs one recv completion and one send in a batch shared by all connections.
+ * Opening and stat()ing files is left to the synchronous cache miss path: the
+ * response headers depend on the stat() result, and the file cache skips both.
+ */
+#define URING_ENTRIES 4096 //Submission queue size, the completion queue is four times larger
+#define URING_BUFFERS 1024 //Provided receive buffers, a power of two
+#define URING_BUFFER_SIZE READ_CHUNK
+#define URING_BUFFER_GROUP 0
+#define URING_PIPE_SIZE (256 * 1024) //Asked for, the kernel may grant less
+
+//What a completion is for, kept in the low bits of user_data under the Connection pointer
+typedef enum{
+	URING_ACCEPT,
+	URING_RECV,
+	URING_SEND, // memory run of the output queue
+	URING_SPLICE_IN, // file -> pipe
+	URING_SPLICE_OUT, // pipe -> socket
+	URING_INOTIFY,
+	URING_CANCEL,
+	URING_TAG_MASK = 7
+} UringTag;
+
+typedef struct{
+	int fd;
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_array;
+	unsigned sq_mask;
+	unsigned sq_entries;
+	unsigned sq_local_tail; // SQEs prepared, published to sq_tail by uring_enter()
+	unsigned to_submit;
+	struct io_uring_sqe *sqes;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned cq_mask;
+	struct io_uring_cqe *cqes;
+	struct io_uring_buf_ring *buffers;
+	char *buffer_memory;
+	uint16_t buffer_tail;
+	int listener;
+} Uring;
+
+Uring uring;
+
+//Hand receive buffer bid back to the kernel
+void uring_recycle_buffer(Uring *ring, int bid){
+	struct io_uring_buf *buffer = &ring->buffers->bufs[ring->buffer_tail & (URING_BUFFERS - 1)];
+	buffer->addr = (uint64_t)(uintptr_t)(ring->buffer_memory + (size_t)bid * URING_BUFFER_SIZE);
+	buffer->len = URING_BUFFER_SIZE;
+	buffer->bid = bid;
+	ring->buffer_tail++;
+	__atomic_store_n(&ring->buffers->tail, ring->buffer_tail, __ATOMIC_RELEASE);
+}
+
+//Returns 0 for success, 1 for failure
+int uring_setup(Uring *ring){
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN
+		| IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+	params.cq_entries = URING_ENTRIES * 4;
+	ring->fd = syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+	if (ring->fd < 0 && errno == EINVAL){
+		//Older kernels: keep only the flags that change nothing but speed
+		memset(&params, 0, sizeof(params));
+		params.flags = IORING_SETUP_CQSIZE;
+		params.cq_entries = URING_ENTRIES * 4;
+		ring->fd = syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+	}
+	if (ring->fd < 0){
+		perror("io_uring_setup failed\n");
+		return 1;
+	}
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)){
+		fprintf(stderr, "Kernel io_uring is too old\n");
+		close(ring->fd);
+		return 1;
+	}
+
+	//1. Map the submission and completion rings (one mapping) and the SQE array
+	size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	size_t ring_size = sq_size > cq_size ? sq_size : cq_size;
+	char *rings = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	ring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (rings == MAP_FAILED || ring->sqes == MAP_FAILED){
+		perror("io_uring ring mapping failed\n");
+		close(ring->fd);
+		return 1;
+	}
+	ring->sq_head = (unsigned *)(rings + params.sq_off.head);
+	ring->sq_tail = (unsigned *)(rings + params.sq_off.tail);
+	ring->sq_array = (unsigned *)(rings + params.sq_off.array);
+	ring->sq_mask = *(unsigned *)(rings + params.sq_off.ring_mask);
+	ring->sq_entries = params.sq_entries;
+	ring->sq_local_tail = *ring->sq_tail;
+	ring->to_submit = 0;
+	ring->cq_head = (unsigned *)(rings + params.cq_off.head);
+	ring->cq_tail = (unsigned *)(rings + params.cq_off.tail);
+	ring->cq_mask = *(unsigned *)(rings + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(rings + params.cq_off.cqes);
+
+	//2. Register the receive buffers. The ring of buffer descriptors must be page aligned
+	ring->buffers = mmap(NULL, URING_BUFFERS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ring->buffer_memory = mmap(NULL, (size_t)URING_BUFFERS * URING_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ring->buffers == MAP_FAILED || ring->buffer_memory == MAP_FAILED){
+		perror("Receive buffer allocation failed\n");
+		close(ring->fd);
+		return 1;
+	}
+	struct io_uring_buf_reg registration;
+	memset(&registration, 0, sizeof(registration));
+	registration.ring_addr = (uint64_t)(uintptr_t)ring->buffers;
+	registration.ring_entries = URING_BUFFERS;
+	registration.bgid = URING_BUFFER_GROUP;
+	if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0){
+		perror("Registering receive buffers failed\n");
+		close(ring->fd);
+		return 1;
+	}
+	ring->buffer_tail = 0;
+	for (int i = 0; i < URING_BUFFERS; i++){
+		uring_recycle_buffer(ring, i);
+	}
+	return 0;
+}
+
+/*
+ * Publish prepared SQEs and wait for at least wait_nr completions, or until
+ * timeout_ms passes (-1 waits forever). Returns 0 for success, 1 for failure
+ */
+int uring_enter(Uring *ring, unsigned wait_nr, int timeout_ms){
+	__atomic_store_n(ring->sq_tail, ring->sq_local_tail, __ATOMIC_RELEASE);
+	struct __kernel_timespec timeout = { timeout_ms / 1000, (timeout_ms % 1000) * 1000000L };
+	struct io_uring_getevents_arg arg;
+	memset(&arg, 0, sizeof(arg));
+	arg.ts = timeout_ms >= 0 ? (uint64_t)(uintptr_t)&timeout : 0;
+	unsigned flags = IORING_ENTER_EXT_ARG | (wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+	int submitted = syscall(__NR_io_uring_enter, ring->fd, ring->to_submit, wait_nr, flags, &arg, sizeof(arg));
+	if (submitted < 0){
+		//Timed out, interrupted, or completions must be reaped before more can be submitted
+		if (errno == ETIME || errno == EINTR || errno == EBUSY || errno == EAGAIN){
+			return 0;
+		}
+		perror("io_uring_enter failed\n");
+		return 1;
+	}
+	ring->to_submit -= submitted;
+	return 0;
+}
+
+//Zeroed SQE tagged for conn, submitting what is queued first if the submission queue is full. NULL on failure
+struct io_uring_sqe *uring_prepare(Uring *ring, int opcode, int fd, Connection *conn, UringTag tag){
+	if (ring->sq_local_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries){
+		if (uring_enter(ring, 0, 0) != 0 || ring->sq_local_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries){
+			fprintf(stderr, "io_uring submission queue full\n");
+			return NULL;
+		}
+	}
+	unsigned index = ring->sq_local_tail & ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->user_data = (uint64_t)(uintptr_t)conn | tag;
+	ring->sq_array[index] = index;
+	ring->sq_local_tail++;
+	ring->to_submit++;
+	if (conn != NULL){
+		conn->uring.ops++;
+	}
+	return sqe;
+}
+
+//Returns 0 for success, 1 for failure
+int uring_arm_accept(Uring *ring){
+	struct io_uring_sqe *sqe = uring_prepare(ring, IORING_OP_ACCEPT, ring->listener, NULL, URING_ACCEPT);
+	if (sqe == NULL){
+		return 1;
+	}
+	sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+	sqe->accept_flags = SOCK_CLOEXEC;
+	return 0;
+}
+
+//Returns 0 for success, 1 for failure
+int uring_arm_recv(Uring *ring, Connection *conn){
+	struct io_uring_sqe *sqe = uring_prepare(ring, IORING_OP_RECV, conn->fd, conn, URING_RECV);
+	if (sqe == NULL){
+		return 1;
+	}
+	sqe->ioprio = IORING_RECV_MULTISHOT;
+	sqe->flags = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = URING_BUFFER_GROUP;
+	conn->uring.recv_armed = 1;
+	conn->uring.recv_cancelled = 0;
+	return 0;
+}
+
+//Free a closed connection once the kernel holds no more requests for it
+void uring_conn_release(Connection *conn){
+	if (!conn->uring.closing || conn->uring.ops > 0){
+		return;
+	}
+	if (conn->uring.pipe_size > 0){
+		close(conn->uring.pipe[0]);
+		close(conn->uring.pipe[1]);
+	}
+	close(conn->fd);
+	conn_free(conn);
+	free(conn);
+}
+
+//Shutting the socket down ends the multishot recv and any send or splice still waiting on it
+void uring_conn_close(Connection *conn){
+	if (!conn->uring.closing){
+		conn->uring.closing = 1;
+		timer_cancel(&timer_wheel, &conn->timer);
+		shutdown(conn->fd, SHUT_RDWR);
+	}
+	uring_conn_release(conn);
+}
+
+/*
+ * Send the head of the output queue: the run of memory segments, which is contiguous
+ * in conn->out, linked to a splice of up to a pipe's worth of the file segment after
+ * it into the pipe and from there to the socket. A short splice breaks the chain and
+ * the bytes it left in the pipe go first next time. Returns 0 for success, 1 for failure
+ */
+int uring_send(Uring *ring, Connection *conn){
+	OutSegment *head = &conn->segments[conn->segment_head];
+	off_t run = 0;
+	int next = conn->segment_head;
+	while (next < conn->segment_count && conn->segments[next].file_fd < 0){
+		run += conn->segments[next].len;
+		next++;
+	}
+	OutSegment *file = next < conn->segment_count ? &conn->segments[next] : NULL;
+	if (file != NULL && conn->uring.pipe_size == 0){
+		if (pipe2(conn->uring.pipe, O_CLOEXEC) != 0){
+			perror("Pipe creation failed\n");
+			return 1;
+		}
+		fcntl(conn->uring.pipe[1], F_SETPIPE_SZ, URING_PIPE_SIZE);
+		conn->uring.pipe_size = fcntl(conn->uring.pipe[1], F_GETPIPE_SZ);
+		if (conn->uring.pipe_size <= 0){
+			conn->uring.pipe_size = 65536;
+		}
+	}
+
+	struct io_uring_sqe *sqe;
+	if (run > 0){
+		sqe = uring_prepare(ring, IORING_OP_SEND, conn->fd, conn, URING_SEND);
+		if (sqe == NULL){
+			return 1;
+		}
+		//MSG_WAITALL makes io_uring retry until the whole run is sent, MSG_MORE corks it with the file after
+		sqe->addr = (uint64_t)(uintptr_t)(conn->out + head->offset);
+		sqe->len = run;
+		sqe->msg_flags = MSG_WAITALL | (file != NULL ? MSG_MORE : 0);
+		sqe->flags = file != NULL ? IOSQE_IO_LINK : 0;
+		conn->uring.sending++;
+	}
+	if (file != NULL){
+		off_t in_len = file->len - conn->uring.piped;
+		if (in_len > conn->uring.pipe_size - conn->uring.piped){
+			in_len = conn->uring.pipe_size - conn->uring.piped;
+		}
+		if (in_len > 0){
+			sqe = uring_prepare(ring, IORING_OP_SPLICE, conn->uring.pipe[1], conn, URING_SPLICE_IN);
+			if (sqe == NULL){
+				return 1;
+			}
+			sqe->splice_fd_in = file->file_fd;
+			sqe->splice_off_in = file->offset + conn->uring.piped;
+			sqe->off = (uint64_t)-1;
+			sqe->len = in_len;
+			sqe->splice_flags = SPLICE_F_MOVE;
+			sqe->flags = IOSQE_IO_LINK;
+			conn->uring.sending++;
+		}
+		sqe = uring_prepare(ring, IORING_OP_SPLICE, conn->fd, conn, URING_SPLICE_OUT);
+		if (sqe == NULL){
+			return 1;
+		}
+		sqe->splice_fd_in = conn->uring.pipe[0];
+		sqe->splice_off_in = (uint64_t)-1;
+		sqe->off = (uint64_t)-1;
+		sqe->len = conn->uring.piped + in_len;
+		sqe->splice_flags = SPLICE_F_MOVE | (file->len > conn->uring.piped + in_len ? SPLICE_F_MORE : 0);
+		conn->uring.sending++;
+	}
+	conn->uring.send_failed = 0;
+	return 0;
+}
 
+//Account for one completion of a send chain. Returns 1 once the chain has finished and failed
+int uring_on_send(Connection *conn, UringTag tag, int res){
+	conn->uring.sending--;
+	if (res < 0 && res != -ECANCELED){
+		if (res != -EPIPE && res != -ECONNRESET){
+			fprintf(stderr, "Sending failed: %s\n", strerror(-res));
+		}
+		conn->uring.send_failed = 1;
+	}
+	else if (res >= 0 && tag == URING_SEND){
+		metrics_add(&metrics->bytes_out, res);
+		conn_consume(conn, res);
+	}
+	else if (res >= 0 && tag == URING_SPLICE_IN){
+		if (res == 0){
+			fprintf(stderr, "File shrank while it was being sent\n");
+			conn->uring.send_failed = 1;
+		}
+		conn->uring.piped += res;
+	}
+	else if (res >= 0 && tag == URING_SPLICE_OUT){
+		//The file segment is the head of the queue once the memory before it has gone
+		OutSegment *segment = &conn->segments[conn->segment_head];
+		metrics_add(&metrics->bytes_out, res);
+		conn->uring.piped -= res;
+		segment->offset += res;
+		segment->len -= res;
+		if (segment->len == 0){
+			conn_release_segment(segment);
+			conn->segment_head++;
+		}
+	}
+	if (conn->uring.sending > 0){
+		return 0;
+	}
+	if (!conn_pending(conn)){
+		conn->segment_head = conn->segment_count = 0;
+		conn->out_len = 0;
+	}
+	return conn->uring.send_failed;
+}
 
-		//Close client socket for parent process
-		close(client_socket);
+//Append received bytes to conn->in and give the buffer back. Returns 1 if the connection must be closed
+int uring_on_recv(Uring *ring, Connection *conn, int res, uint32_t flags, int more){
+	if (!more){
+		conn->uring.recv_armed = 0;
 	}
-	sem_destroy(semaphore);
-	munmap(semaphore, sizeof(sem_t));
+	if (flags & IORING_CQE_F_BUFFER){
+		int bid = flags >> IORING_CQE_BUFFER_SHIFT;
+		if (res > 0 && !conn->uring.closing){
+			if (conn_reserve_input(conn, res) != 0){
+				uring_recycle_buffer(ring, bid);
+				return 1;
+			}
+			memcpy(conn->in + conn->in_len, ring->buffer_memory + (size_t)bid * URING_BUFFER_SIZE, res);
+			conn->in_len += res;
+			conn->in[conn->in_len] = '\0';
+			metrics_add(&metrics->bytes_in, res);
+		}
+		uring_recycle_buffer(ring, bid);
+	}
+	if (res == 0){
+		conn->uring.peer_closed = 1;
+	}
+	else if (res < 0 && res != -ENOBUFS && res != -ECANCELED){
+		//Out of buffers just ends the multishot recv, it is armed again below
+		if (res != -ECONNRESET){
+			fprintf(stderr, "Receiving failed: %s\n", strerror(-res));
+		}
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * Move a connection on once nothing is being sent: send what is queued, otherwise
+ * handle the buffered requests, then make sure the recv is armed unless the buffer
+ * is full and set the timeout. Mirrors conn_handle_event(). May free conn
+ */
+void uring_conn_advance(Uring *ring, Connection *conn){
+	while (!conn->uring.sending){
+		//Write: responses are queued, send them before handling more requests
+		if (conn_pending(conn)){
+			if (uring_send(ring, conn) != 0){
+				uring_conn_close(conn);
+				return;
+			}
+			break;
+		}
+		if (conn->state == CONN_CLOSING){
+			uring_conn_close(conn);
+			return;
+		}
+		conn->state = CONN_READING;
+
+		//Parse + handle everything buffered
+		int handled = conn_process_batch(conn);
+		if (handled < 0){
+			uring_conn_close(conn);
+			return;
+		}
+		if (handled == 0 && !conn_pending(conn)){
+			if (conn->uring.peer_closed){
+				uring_conn_close(conn);
+				return;
+			}
+			break;
+		}
+	}
+
+	//Read: stop the recv while a full buffer waits for the handler, like conn_read() stops reading
+	int full = conn->in_len >= conn->in_start + conn_read_limit(conn);
+	if (full && conn->uring.recv_armed && !conn->uring.recv_cancelled){
+		struct io_uring_sqe *sqe = uring_prepare(ring, IORING_OP_ASYNC_CANCEL, -1, NULL, URING_CANCEL);
+		if (sqe != NULL){
+			sqe->addr = (uint64_t)(uintptr_t)conn | URING_RECV;
+			sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+			conn->uring.recv_cancelled = 1;
+		}
+	}
+	if (!full && !conn->uring.recv_armed && !conn->uring.peer_closed && uring_arm_recv(ring, conn) != 0){
+		uring_conn_close(conn);
+		return;
+	}
+	conn_schedule_timeout(conn);
+}
+
+//Returns 0 for success, 1 for failure
+int uring_on_accept(Uring *ring, int res, int more){
+	if (!more && uring_arm_accept(ring) != 0){
+		return 1;
+	}
+	if (res < 0){
+		if (res != -ECANCELED){
+			fprintf(stderr, "Connection failed: %s\n", strerror(-res));
+		}
+		return 0;
+	}
+
+	Connection *conn = malloc(sizeof(Connection));
+	if (conn == NULL){
+		perror("Memory allocation failed\n");
+		close(res);
+		return 0;
+	}
+	conn_init(conn, res, 1);
+	conn->batching = 1;
+
+	//The multishot accept has no per-connection address buffer, ask for it only when it is logged
+	if (access_log.fd >= 0 || LOG_VERBOSITY > 0){
+		struct sockaddr_storage client_addy;
+		socklen_t client_addy_len = sizeof(client_addy);
+		if (getpeername(res, (struct sockaddr *)&client_addy, &client_addy_len) == 0){
+			conn_set_peer(conn, &client_addy);
+		}
+	}
+	uring_conn_advance(ring, conn);
+	return 0;
+}
+
+//Returns 0 for success, 1 for failure
+int uring_watch_inotify(Uring *ring){
+	struct io_uring_sqe *sqe = uring_prepare(ring, IORING_OP_POLL_ADD, file_cache.inotify_fd, NULL, URING_INOTIFY);
+	if (sqe == NULL){
+		return 1;
+	}
+	sqe->poll32_events = POLLIN;
+	sqe->len = IORING_POLL_ADD_MULTI;
+	return 0;
+}
+
+//Dispatch one completion. Returns 0 for success, 1 if the loop cannot go on
+int uring_complete(Uring *ring, struct io_uring_cqe *cqe){
+	UringTag tag = cqe->user_data & URING_TAG_MASK;
+	Connection *conn = (Connection *)(uintptr_t)(cqe->user_data & ~(uint64_t)URING_TAG_MASK);
+	int more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+	switch (tag){
+		case URING_ACCEPT:
+			return uring_on_accept(ring, cqe->res, more);
+		case URING_INOTIFY:
+			cache_handle_inotify();
+			return more || cqe->res < 0 ? 0 : uring_watch_inotify(ring);
+		case URING_CANCEL:
+			return 0;
+		default:
+			break;
+	}
+
+	if (!more){
+		conn->uring.ops--;
+	}
+	int failed = tag == URING_RECV ? uring_on_recv(ring, conn, cqe->res, cqe->flags, more) : uring_on_send(conn, tag, cqe->res);
+	if (conn->uring.closing){
+		uring_conn_release(conn);
+	}
+	else if (failed){
+		uring_conn_close(conn);
+	}
+	else if (!conn->uring.sending){
+		uring_conn_advance(ring, conn);
+	}
+	return 0;
+}
+
+//Timer wheel callback: like conn_timeout(), but the 408 is queued and sent before closing
+void uring_conn_timeout(TimerNode *node, void *context){
+	Connection *conn = (Connection *)((char *)node - offsetof(Connection, timer));
+	Uring *ring = context;
+	DEBUG_LOG(1, "Connection timed out waiting (%d)\n", conn->timeout_kind);
+	if (conn_mid_request(conn) && !conn_pending(conn)){
+		send_error_response(conn, 408);
+		metrics_count_request(conn->request.method_id, conn->status);
+		conn->state = CONN_CLOSING;
+		uring_conn_advance(ring, conn);
+		return;
+	}
+	uring_conn_close(conn);
+}
+
+int run_uring_loop(int server_fd){
+	raise_fd_limit();
+	if (uring_setup(&uring) != 0){
+		fprintf(stderr, "io_uring unavailable, using epoll\n");
+		return run_event_loop(server_fd);
+	}
+	uring.listener = server_fd;
+	if (access_log_start() != 0){
+		return 1;
+	}
+	if (cache_start_watching(document_root.name) >= 0 && uring_watch_inotify(&uring) != 0){
+		file_cache.enabled = 0;
+	}
+	if (uring_arm_accept(&uring) != 0){
+		access_log_stop();
+		return 1;
+	}
+
+	timer_wheel_init(&timer_wheel);
+	while (1){
+		if (uring_enter(&uring, 1, timer_wheel_wait_ms(&timer_wheel)) != 0){
+			break;
+		}
+
+		//Completions may keep arriving while these are handled, so reap until the queue is empty
+		int failed = 0;
+		unsigned head = *uring.cq_head;
+		unsigned tail;
+		while (!failed && head != (tail = __atomic_load_n(uring.cq_tail, __ATOMIC_ACQUIRE))){
+			while (!failed && head != tail){
+				struct io_uring_cqe cqe = uring.cqes[head & uring.cq_mask];
+				head++;
+				__atomic_store_n(uring.cq_head, head, __ATOMIC_RELEASE);
+				failed = uring_complete(&uring, &cqe);
+			}
+		}
+		if (failed){
+			break;
+		}
+
+		timer_wheel_advance(&timer_wheel, uring_conn_timeout, &uring);
+	}
+
+	access_log_stop();
+	close(uring.fd);
+	return 1;
+}
+
+//=====================PRE-FORKED WORKERS==================
+/*
+ * Multi-core model. The parent forks N workers up front and then only supervises
+ * them. Each worker binds its own SO_REUSEPORT listener so the kernel spreads
+ * incoming connections across workers, then runs the event loop. There is no
+ * shared accept queue to fight over and no fork per connection.
+ */
+#define WORKER_SETUP_FAILED 2 //Exit code for workers that could not bind, never respawned
+
+volatile sig_atomic_t stop_requested = 0;
+
+void stop_handler(int sig){
+	(void)sig;
+	stop_requested = 1;
+}
+
+//Enable an optional TCP listener option, warning instead of failing where the kernel does not support it
+void listener_option(int server_fd, int option, int value, const char *name){
+	if (value > 0 && setsockopt(server_fd, IPPROTO_TCP, option, &value, sizeof(value)) < 0){
+		fprintf(stderr, "%s not enabled: %s\n", name, strerror(errno));
+	}
+}
+
+/*
+ * Create, bind and listen on port 4040, on every IPv6 and IPv4 address through one
+ * dual-stack socket where the host has IPv6, IPv4 only otherwise. Workers pass
+ * reuse_port = 1 so every worker can bind the same address. Returns the socket or
+ * -1 on failure
+ */
+int create_listener(int reuse_port){
+	//0. Get address info
+	struct addrinfo hints, *results;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+	
+	if(getaddrinfo(NULL, "4040", &hints, &results) != 0){
+		perror("Failed to find address\n");
+		return -1;
+	}
+
+	// 1. Create a socket, trying the IPv6 wildcard first since it also takes IPv4 clients
+	int server_fd = -1;
+	for (int pass = 0; pass < 2 && server_fd < 0; pass++){
+		for (struct addrinfo *address = results; address != NULL; address = address->ai_next){
+			if ((address->ai_family == AF_INET6) != (pass == 0)){
+				continue;
+			}
+			server_fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+			if (server_fd < 0){
+				continue;
+			}
+
+			int enable = 1;
+			int disable = 0;
+			setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+			if (address->ai_family == AF_INET6){
+				setsockopt(server_fd, IPPROTO_IPV6, IPV6_V6ONLY, &disable, sizeof(disable));
+			}
+			if (reuse_port && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0){
+				perror("SO_REUSEPORT failed\n");
+				close(server_fd);
+				freeaddrinfo(results);
+				return -1;
+			}
+
+			// 2. Bind socket to address
+			if (bind(server_fd, address->ai_addr, address->ai_addrlen) == 0){
+				break;
+			}
+			//Only an IPv6 wildcard the host cannot bind (IPv6 disabled) falls back to IPv4
+			if (pass == 1 || errno == EADDRINUSE){
+				perror("Binding failed\n");
+				close(server_fd);
+				freeaddrinfo(results);
+				return -1;
+			}
+			close(server_fd);
+			server_fd = -1;
+		}
+	}
+	freeaddrinfo(results);
+	if (server_fd < 0){
+		perror("Cannot create socket\n");
+		return -1;
+	}
+
+	//Only wake the server once a request arrives, and let repeat clients send it with the SYN
+	listener_option(server_fd, TCP_DEFER_ACCEPT, config.defer_accept, "TCP_DEFER_ACCEPT");
+	listener_option(server_fd, TCP_FASTOPEN, config.fastopen, "TCP Fast Open");
+
+	// 3. Listen for connections.
+	if (listen(server_fd, config.backlog) < 0){
+		perror("Listening failed\n");
+		close(server_fd);
+		return -1;
+	}
+	return server_fd;
+}
+
+//Pin the calling process to the index-th CPU it is allowed to run on
+void pin_to_cpu(int index){
+	cpu_set_t allowed;
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0){
+		perror("sched_getaffinity failed\n");
+		return;
+	}
+	int allowed_count = CPU_COUNT(&allowed);
+	if (allowed_count == 0){
+		return;
+	}
+
+	int target = index % allowed_count;
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++){
+		if (!CPU_ISSET(cpu, &allowed)) continue;
+		if (target-- == 0){
+			cpu_set_t pinned;
+			CPU_ZERO(&pinned);
+			CPU_SET(cpu, &pinned);
+			if (sched_setaffinity(0, sizeof(pinned), &pinned) != 0){
+				perror("sched_setaffinity failed\n");
+			}
+			return;
+		}
+	}
+}
+
+//Fork one worker. Returns the child's pid to the parent, never returns in the child
+pid_t spawn_worker(ServeMode mode, int index, int cpu_affinity){
+	fflush(stdout); //otherwise buffered output is duplicated into the child
+	pid_t pid = fork();
+	if (pid != 0){
+		return pid;
+	}
+
+	signal(SIGTERM, SIG_DFL);
+	signal(SIGINT, SIG_DFL);
+	metrics_use_slot(index);
+	if (cpu_affinity){
+		pin_to_cpu(index);
+	}
+
+	int server_fd = create_listener(1);
+	if (server_fd < 0){
+		exit(WORKER_SETUP_FAILED);
+	}
+	printf("Worker %d (pid %d) listening on port 4040...\n", index, getpid());
+	int status = mode == MODE_URING ? run_uring_loop(server_fd) : run_event_loop(server_fd);
 	close(server_fd);
+	exit(status);
+}
+
+//Start the workers and respawn any that die until SIGINT/SIGTERM
+int run_workers(ServeMode mode, int worker_count, int cpu_affinity){
+	pid_t *workers = calloc(worker_count, sizeof(pid_t));
+	if (workers == NULL){
+		perror("Memory allocation failed\n");
+		return 1;
+	}
+
+	struct sigaction sa;
+	sa.sa_handler = stop_handler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0; //no SA_RESTART so waitpid returns on a stop signal
+	sigaction(SIGTERM, &sa, NULL);
+	sigaction(SIGINT, &sa, NULL);
+
+	for (int i = 0; i < worker_count; i++){
+		workers[i] = spawn_worker(mode, i, cpu_affinity);
+		if (workers[i] < 0){
+			perror("Fork failed\n");
+		}
+	}
+
+	int running = worker_count;
+	while (running > 0 && !stop_requested){
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0){
+			if (errno == EINTR) continue;
+			break;
+		}
+
+		for (int i = 0; i < worker_count; i++){
+			if (workers[i] != pid) continue;
+
+			if (WIFEXITED(status) && WEXITSTATUS(status) == WORKER_SETUP_FAILED){
+				fprintf(stderr, "Worker %d failed to start\n", i);
+				workers[i] = -1;
+				running--;
+			}
+			else if (!stop_requested){
+				fprintf(stderr, "Worker %d (pid %d) exited, respawning\n", i, pid);
+				workers[i] = spawn_worker(mode, i, cpu_affinity);
+			}
+			break;
+		}
+	}
+
+	//Shut everything down
+	for (int i = 0; i < worker_count; i++){
+		if (workers[i] > 0) kill(workers[i], SIGTERM);
+	}
+	while (waitpid(-1, NULL, 0) > 0 || errno == EINTR);
+	free(workers);
+	return running > 0 ? 0 : 1;
+}
+
+//Parse a byte count such as 4096, 512K, 64M or 1G. Returns -1 if invalid
+long long parse_size(const char *text){
+	char *end;
+	long long value = strtoll(text, &end, 10);
+	if (end == text || value < 0){
+		return -1;
+	}
+	switch (*end){
+		case 'k': case 'K': value <<= 10; end++; break;
+		case 'm': case 'M': value <<= 20; end++; break;
+		case 'g': case 'G': value <<= 30; end++; break;
+	}
+	return *end == '\0' ? value : -1;
+}
+
+//Ids for options that only have a long form
+enum{
+	OPT_MAX_HEAD_SIZE = 256,
+	OPT_MAX_HEADERS,
+	OPT_MAX_BODY_SIZE,
+	OPT_CACHE_CONTROL,
+	OPT_ACCESS_LOG,
+	OPT_LOG_FORMAT,
+	OPT_LOG_SAMPLE,
+	OPT_KEEP_ALIVE_MAX,
+	//Same order as TimeoutKind
+	OPT_HEADER_TIMEOUT,
+	OPT_BODY_TIMEOUT,
+	OPT_IDLE_TIMEOUT,
+	OPT_WRITE_TIMEOUT,
+	OPT_IO_THREADS,
+	OPT_BUNDLE,
+	OPT_DEFER_ACCEPT,
+	OPT_FASTOPEN
+};
+
+//Add an EXT=SECONDS rule for Cache-Control: max-age. Returns 0 for success, 1 for failure
+int config_add_cache_control(const char *text){
+	const char *equals = strchr(text, '=');
+	char *end = NULL;
+	long max_age = equals != NULL ? strtol(equals + 1, &end, 10) : -1;
+	CacheControlRule *rule = &config.cache_control[config.cache_control_count];
+	if (equals == NULL || equals == text || (size_t)(equals - text) >= sizeof(rule->extension)
+			|| end == equals + 1 || *end != '\0' || max_age < 0 || config.cache_control_count == CACHE_CONTROL_MAX){
+		fprintf(stderr, "Invalid cache control rule: %s\n", text);
+		return 1;
+	}
+	const char *extension = text[0] == '.' ? text + 1 : text;
+	snprintf(rule->extension, sizeof(rule->extension), "%.*s", (int)(equals - extension), extension);
+	rule->max_age = max_age;
+	config.cache_control_count++;
 	return 0;
 }
 
+void print_usage(const char *program){
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -m, --mode=epoll|uring|fork\n"
+		"                          serving model: epoll event loop, the same with io_uring for socket I/O, or\n"
+		"                          process per connection (default epoll)\n"
+		"  -w, --workers[=N]       pre-fork N epoll or uring workers with SO_REUSEPORT listeners (default: one per core)\n"
+		"  -a, --cpu-affinity      pin each worker to its own CPU\n"
+		"  -b, --backlog=N         listen() backlog (default %d)\n"
+		"  --defer-accept=SECONDS  TCP_DEFER_ACCEPT: hand connections over only once their first request has\n"
+		"                          arrived, waiting up to SECONDS for it (default: off)\n"
+		"  --fastopen=N            accept TCP Fast Open, queueing up to N pending Fast Open connections (default: off)\n"
+		"  -c, --cache-size=BYTES  in-memory file cache budget per process, K/M/G suffixes allowed, 0 disables (default 64M)\n"
+		"  --max-head-size=BYTES   largest request line + headers accepted (default %zu)\n"
+		"  --max-headers=N         most headers accepted per request (default %d)\n"
+		"  --max-body-size=BYTES   largest request body accepted, K/M/G suffixes allowed (default 16M)\n"
+		"  --cache-control=EXT=SECONDS\n"
+		"                          send Cache-Control: max-age=SECONDS with .EXT files, \"*\" for any other\n"
+		"                          extension; repeatable (default: no Cache-Control)\n"
+		"  --access-log=FILE       append an access log line per request to FILE, - for stdout (default: off)\n"
+		"  --log-format=common|combined|json\n"
+		"                          access log format (default common)\n"
+		"  --log-sample=N          log one request in N; 5xx responses are always logged (default 1)\n"
+		"  --header-timeout=SECONDS\n"
+		"                          time allowed to send a whole request head, 408 after (default %ld)\n"
+		"  --body-timeout=SECONDS  longest pause allowed inside a request body, 408 after (default %ld)\n"
+		"  --idle-timeout=SECONDS  how long a keep-alive connection may sit between requests (default %ld)\n"
+		"  --write-timeout=SECONDS longest a client may stall reading a response (default %ld)\n"
+		"  --keep-alive-max=N      requests served on a connection before it is closed (default %d)\n"
+		"  --io-threads=N          threads per epoll process that open, stat and read files off the event loop,\n"
+		"                          0 does it on the loop (default %d)\n"
+		"  --bundle=FILE           serve the files packed in FILE by bundlegen from memory, others from files/\n"
+		"  -h, --help              show this message\n",
+		program, SOMAXCONN, config.max_head_size, config.max_headers,
+		config.timeouts_ms[TIMEOUT_HEADER] / 1000, config.timeouts_ms[TIMEOUT_BODY] / 1000,
+		config.timeouts_ms[TIMEOUT_IDLE] / 1000, config.timeouts_ms[TIMEOUT_WRITE] / 1000, config.keep_alive_max,
+		io_pool.configured);
+}
+
+int main(int argc, char *argv[]){
+	ServeMode mode = MODE_EPOLL;
+	int worker_count = 0;
+	int cpu_affinity = 0;
+	const char *bundle_name = NULL;
+
+	static struct option long_options[] = {
+		{"mode", required_argument, NULL, 'm'},
+		{"workers", optional_argument, NULL, 'w'},
+		{"cpu-affinity", no_argument, NULL, 'a'},
+		{"backlog", required_argument, NULL, 'b'},
+		{"cache-size", required_argument, NULL, 'c'},
+		{"max-head-size", required_argument, NULL, OPT_MAX_HEAD_SIZE},
+		{"max-headers", required_argument, NULL, OPT_MAX_HEADERS},
+		{"max-body-size", required_argument, NULL, OPT_MAX_BODY_SIZE},
+		{"cache-control", required_argument, NULL, OPT_CACHE_CONTROL},
+		{"access-log", required_argument, NULL, OPT_ACCESS_LOG},
+		{"log-format", required_argument, NULL, OPT_LOG_FORMAT},
+		{"log-sample", required_argument, NULL, OPT_LOG_SAMPLE},
+		{"keep-alive-max", required_argument, NULL, OPT_KEEP_ALIVE_MAX},
+		{"header-timeout", required_argument, NULL, OPT_HEADER_TIMEOUT},
+		{"body-timeout", required_argument, NULL, OPT_BODY_TIMEOUT},
+		{"idle-timeout", required_argument, NULL, OPT_IDLE_TIMEOUT},
+		{"write-timeout", required_argument, NULL, OPT_WRITE_TIMEOUT},
+		{"io-threads", required_argument, NULL, OPT_IO_THREADS},
+		{"bundle", required_argument, NULL, OPT_BUNDLE},
+		{"defer-accept", required_argument, NULL, OPT_DEFER_ACCEPT},
+		{"fastopen", required_argument, NULL, OPT_FASTOPEN},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+	int option;
+	while ((option = getopt_long(argc, argv, "m:w::ab:c:h", long_options, NULL)) != -1){
+		switch (option){
+			case 'm':
+				if (strcmp(optarg, "epoll") == 0) mode = MODE_EPOLL;
+				else if (strcmp(optarg, "fork") == 0) mode = MODE_FORK;
+				else if (strcmp(optarg, "uring") == 0) mode = MODE_URING;
+				else {
+					fprintf(stderr, "Unknown mode: %s\n", optarg);
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+			case 'w':
+				worker_count = optarg != NULL ? atoi(optarg) : 0;
+				if (worker_count <= 0){
+					worker_count = sysconf(_SC_NPROCESSORS_ONLN);
+				}
+				if (worker_count <= 0){
+					worker_count = 1;
+				}
+				break;
+			case 'a':
+				cpu_affinity = 1;
+				break;
+			case 'b':
+				config.backlog = atoi(optarg);
+				if (config.backlog <= 0){
+					fprintf(stderr, "Invalid backlog: %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'c': {
+				long long cache_size = parse_size(optarg);
+				if (cache_size < 0){
+					fprintf(stderr, "Invalid cache size: %s\n", optarg);
+					return 1;
+				}
+				file_cache.max_bytes = cache_size;
+				break;
+			}
+			case OPT_MAX_HEAD_SIZE: {
+				long long max_head_size = parse_size(optarg);
+				if (max_head_size <= 0){
+					fprintf(stderr, "Invalid head size: %s\n", optarg);
+					return 1;
+				}
+				config.max_head_size = max_head_size;
+				break;
+			}
+			case OPT_MAX_BODY_SIZE: {
+				long long max_body_size = parse_size(optarg);
+				if (max_body_size < 0){
+					fprintf(stderr, "Invalid body size: %s\n", optarg);
+					return 1;
+				}
+				config.max_body_size = max_body_size;
+				break;
+			}
+			case OPT_MAX_HEADERS:
+				config.max_headers = atoi(optarg);
+				if (config.max_headers <= 0){
+					fprintf(stderr, "Invalid header count: %s\n", optarg);
+					return 1;
+				}
+				break;
+			case OPT_CACHE_CONTROL:
+				if (config_add_cache_control(optarg) != 0){
+					return 1;
+				}
+				break;
+			case OPT_ACCESS_LOG:
+				if (access_log.fd > STDOUT_FILENO){
+					close(access_log.fd);
+				}
+				access_log.fd = strcmp(optarg, "-") == 0 ? STDOUT_FILENO : open(optarg, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+				if (access_log.fd < 0){
+					perror("Failed to open access log\n");
+					return 1;
+				}
+				break;
+			case OPT_LOG_FORMAT:
+				if (strcmp(optarg, "common") == 0) access_log.format = LOG_COMMON;
+				else if (strcmp(optarg, "combined") == 0) access_log.format = LOG_COMBINED;
+				else if (strcmp(optarg, "json") == 0) access_log.format = LOG_JSON;
+				else {
+					fprintf(stderr, "Invalid log format: %s\n", optarg);
+					return 1;
+				}
+				break;
+			case OPT_LOG_SAMPLE:
+				access_log.sample = atoi(optarg);
+				if (access_log.sample <= 0){
+					fprintf(stderr, "Invalid log sample rate: %s\n", optarg);
+					return 1;
+				}
+				break;
+			case OPT_KEEP_ALIVE_MAX:
+				config.keep_alive_max = atoi(optarg);
+				if (config.keep_alive_max <= 0){
+					fprintf(stderr, "Invalid keep-alive maximum: %s\n", optarg);
+					return 1;
+				}
+				break;
+			case OPT_BUNDLE:
+				bundle_name = optarg;
+				break;
+			case OPT_DEFER_ACCEPT:
+				config.defer_accept = atoi(optarg);
+				if (config.defer_accept < 0){
+					fprintf(stderr, "Invalid defer accept timeout: %s\n", optarg);
+					return 1;
+				}
+				break;
+			case OPT_FASTOPEN:
+				config.fastopen = atoi(optarg);
+				if (config.fastopen < 0){
+					fprintf(stderr, "Invalid Fast Open queue length: %s\n", optarg);
+					return 1;
+				}
+				break;
+			case OPT_IO_THREADS:
+				io_pool.configured = atoi(optarg);
+				if (io_pool.configured < 0 || io_pool.configured > IO_THREADS_MAX){
+					fprintf(stderr, "Invalid I/O thread count: %s (0 to %d)\n", optarg, IO_THREADS_MAX);
+					return 1;
+				}
+				break;
+			case OPT_HEADER_TIMEOUT:
+			case OPT_BODY_TIMEOUT:
+			case OPT_IDLE_TIMEOUT:
+			case OPT_WRITE_TIMEOUT: {
+				int seconds = atoi(optarg);
+				if (seconds <= 0){
+					fprintf(stderr, "Invalid timeout: %s\n", optarg);
+					return 1;
+				}
+				config.timeouts_ms[TIMEOUT_HEADER + option - OPT_HEADER_TIMEOUT] = seconds * 1000L;
+				break;
+			}
+			case 'h':
+				print_usage(argv[0]);
+				return 0;
+			default:
+				print_usage(argv[0]);
+				return 1;
+		}
+	}
+
+	//A client hanging up mid-response must not kill the server
+	signal(SIGPIPE, SIG_IGN);
+	scan_line_select();
+
+	//Resolve the document root once, every process looks files up relative to it
+	if (document_root_open("files") != 0){
+		return 1;
+	}
+
+	//Mapped before any fork, so every worker shares the same pages
+	if (bundle_name != NULL && bundle_open(bundle_name) != 0){
+		return 1;
+	}
+	if (routes_init() != 0){
+		return 1;
+	}
+
+	//Forked children all write to the first metrics slot, workers get one each
+	if (metrics_init(mode == MODE_FORK) != 0){
+		return 1;
+	}
+
+	if (worker_count > 0){
+		if (mode == MODE_FORK){
+			fprintf(stderr, "--workers requires --mode=epoll or --mode=uring\n");
+			return 1;
+		}
+		printf("Starting %d workers on port 4040...\n", worker_count);
+		return run_workers(mode, worker_count, cpu_affinity);
+	}
+
+	int server_fd = create_listener(0);
+	if (server_fd < 0){
+		return 1;
+	}
+	const char *mode_names[] = { "epoll", "fork", "io_uring" };
+	printf("Server listening on port 4040 (%s mode)...\n", mode_names[mode]);
+
+	int status;
+	if (mode == MODE_FORK){
+		status = run_fork_loop(server_fd);
+	}
+	else if (mode == MODE_URING){
+		status = run_uring_loop(server_fd);
+	}
+	else {
+		status = run_event_loop(server_fd);
+	}
+	close(server_fd);
+	return status;
+}
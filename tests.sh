@@ -52,6 +52,46 @@ else
 fi
 echo ""
 
+# Chunked POST
+echo "Chunked POST with body"
+RESULT=$(curl -s -H "Transfer-Encoding: chunked" -d "user_name=sosa&user_age=300" http://localhost:4040/form.html)
+if echo "$RESULT" | grep -q "processe"; then
+	echo "✓ SUCCESS: Chunked POST request processed"
+else
+	echo "✗ ERROR: Chunked POST request failed"
+fi
+echo ""
+
+# Form fields are checked
+echo "POST with an incomplete form"
+HTTP_CODE=$(curl -s -o /dev/null -w "%{http_code}" -d "user_name=sosa" http://localhost:4040/form.html)
+if [ "$HTTP_CODE" = "400" ]; then
+	echo "✓ SUCCESS: Got 400 Bad Request"
+else
+	echo "✗ ERROR: Expected 400 but instead got $HTTP_CODE"
+fi
+echo ""
+
+# POST to a path without a POST route
+echo "POST to a static file"
+HTTP_CODE=$(curl -s -o /dev/null -w "%{http_code}" -d "a=1" http://localhost:4040/index.html)
+if [ "$HTTP_CODE" = "405" ]; then
+	echo "✓ SUCCESS: Got 405 Method Not Allowed"
+else
+	echo "✗ ERROR: Expected 405 but instead got $HTTP_CODE"
+fi
+echo ""
+
+# Health check route
+echo "Get /healthz"
+RESULT=$(curl -s http://localhost:4040/healthz)
+if echo "$RESULT" | grep -q "OK"; then
+	echo "✓ SUCCESS: Health check answered"
+else
+	echo "✗ ERROR: Health check did not answer OK"
+fi
+echo ""
+
 # Keep alive header
 echo "Keep alive connection header"
 RESULT=$(curl -s -v http://localhost:4040/ 2>&1 | grep -i "Connection: keep-alive")
@@ -62,6 +102,51 @@ else
 fi
 echo ""
 
+# Pipelined requests
+echo "Pipelined requests on one connection"
+exec 3<>/dev/tcp/localhost/4040
+printf 'GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\nGET /styles.css HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n' >&3
+RESULT=$(timeout 5 cat <&3 | grep -c "HTTP/1.1 200 OK")
+exec 3<&-
+if [ "$RESULT" = "2" ]; then
+	echo "✓ SUCCESS: Got both pipelined responses"
+else
+	echo "✗ ERROR: Expected 2 pipelined responses but got $RESULT"
+fi
+echo ""
+
+# Range request
+echo "Range request"
+HTTP_CODE=$(curl -s -o /tmp/range_body -w "%{http_code}" -r 0-5 http://localhost:4040/index.html)
+if [ "$HTTP_CODE" = "206" ] && [ "$(cat /tmp/range_body)" = "$(head -c 6 files/index.html)" ]; then
+	echo "✓ SUCCESS: Got 206 with the first 6 bytes"
+else
+	echo "✗ ERROR: Expected 206 with the first 6 bytes but got $HTTP_CODE"
+fi
+rm -f /tmp/range_body
+echo ""
+
+# Unsatisfiable range
+echo "Unsatisfiable range request"
+HTTP_CODE=$(curl -s -o /dev/null -w "%{http_code}" -r 100000000- http://localhost:4040/index.html)
+if [ "$HTTP_CODE" = "416" ]; then
+	echo "✓ SUCCESS: Got 416"
+else
+	echo "✗ ERROR: Expected 416 but instead got $HTTP_CODE"
+fi
+echo ""
+
+# Conditional request
+echo "Conditional request with the ETag"
+ETAG=$(curl -s -D- -o /dev/null http://localhost:4040/index.html | grep -i "^ETag:" | cut -d' ' -f2 | tr -d '\r')
+HTTP_CODE=$(curl -s -o /dev/null -w "%{http_code}" -H "If-None-Match: $ETAG" http://localhost:4040/index.html)
+if [ -n "$ETAG" ] && [ "$HTTP_CODE" = "304" ]; then
+	echo "✓ SUCCESS: Got 304 Not Modified"
+else
+	echo "✗ ERROR: Expected 304 but instead got $HTTP_CODE (ETag: $ETAG)"
+fi
+echo ""
+
 echo "==============================="
 echo "TEST SUITE COMPLETE"
 echo "==============================="